@@ -0,0 +1,62 @@
+#pragma once
+//minimal Arduino core for building WLED modules on the host
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef std::string String;
+
+unsigned long millis();
+unsigned long micros();
+void yield();
+void delay(unsigned long ms);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+//tests control time: hostSetMillis() freezes the clock at a value, hostRealTime() uses the system clock again
+void hostSetMillis(uint32_t ms);
+void hostSetMicros(uint64_t us);
+void hostRealTime();
+extern uint32_t hostYields; //yield() calls
+
+#define PROGMEM
+#define F(x) x
+#define PSTR(x) x
+#define FPSTR(x) x
+#define pgm_read_byte(a) (*(const uint8_t*)(a))
+#define pgm_read_word(a) (*(const uint16_t*)(a))
+#define pgm_read_dword(a) (*(a)) //also reads pointer tables, which are 64 bit here
+void* memcpy_P(void* dest, const void* src, size_t n); //flash reads, not checked by the address sanitizer
+#define strlen_P strlen
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+#define constrain(a,lo,hi) ((a)<(lo)?(lo):((a)>(hi)?(hi):(a)))
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#ifndef ESP8266
+#define ARDUINO_ARCH_ESP32
+#endif
+#define IRAM_ATTR
+class __FlashStringHelper;
+using std::min;
+using std::max;
+#include "HardwareSerial.h"
+#define bitRead(v,b) (((v)>>(b))&1)
+#define bitSet(v,b) ((v)|=(1UL<<(b)))
+#define bitClear(v,b) ((v)&=~(1UL<<(b)))
+#define bitWrite(v,b,x) ((x)?bitSet(v,b):bitClear(v,b))
@@ -0,0 +1,4 @@
+#pragma once
+//only the types the E1.31 receiver declares, no sockets
+class AsyncUDP {};
+class AsyncUDPPacket {};
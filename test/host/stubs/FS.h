@@ -0,0 +1,28 @@
+#pragma once
+//file system stand-in for host tests: there are no files
+#include <Arduino.h>
+
+class File {
+  public:
+    operator bool() const { return false; }
+    size_t read(uint8_t* buf, size_t len) { return 0; }
+    int    read() { return -1; }
+    size_t readBytes(char* buf, size_t len) { return 0; }
+    size_t write(const uint8_t* buf, size_t len) { return 0; }
+    size_t size() { return 0; }
+    size_t position() { return 0; }
+    bool   seek(uint32_t pos) { return false; }
+    int    available() { return 0; }
+    bool   find(const char* target) { return false; }
+    void   setTimeout(unsigned long ms) {}
+    size_t print(const char* s) { return 0; }
+    void   close() {}
+};
+
+class HostFS {
+  public:
+    bool exists(const char* path) { return false; }
+    File open(const char* path, const char* mode) { return File(); }
+    bool remove(const char* path) { return false; }
+};
+extern HostFS WLED_FS;
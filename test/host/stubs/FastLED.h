@@ -0,0 +1,254 @@
+#pragma once
+//FastLED stand-in for host tests
+//lib8tion math follows the FastLED C implementations, palettes and HSV conversion are simplified.
+#include <Arduino.h>
+
+typedef uint8_t  fract8;
+typedef uint16_t fract16;
+typedef uint16_t accum88;
+typedef int8_t   sfract7;
+
+#define GET_MILLIS millis
+#define FASTLED_VERSION 3003002
+#define EVERY_N_MILLISECONDS(n) if (true)
+
+inline uint8_t  scale8(uint8_t i, fract8 scale) { return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8; }
+inline uint8_t  scale8_video(uint8_t i, fract8 scale) { return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0); }
+inline uint16_t scale16(uint16_t i, fract16 scale) { return ((uint32_t)i * (1 + (uint32_t)scale)) >> 16; }
+inline uint16_t scale16by8(uint16_t i, fract8 scale) { return (i * (1 + ((uint16_t)scale))) >> 8; }
+inline uint8_t  qadd8(uint8_t i, uint8_t j) { unsigned t = i + j; return t > 255 ? 255 : t; }
+inline uint8_t  qsub8(uint8_t i, uint8_t j) { int t = i - j; return t < 0 ? 0 : t; }
+inline int8_t   qadd7(int8_t i, int8_t j) { int t = i + j; return t > 127 ? 127 : t; }
+inline uint8_t  qmul8(uint8_t i, uint8_t j) { unsigned p = (unsigned)i * j; return p > 255 ? 255 : p; }
+inline uint8_t  add8(uint8_t i, uint8_t j) { return i + j; }
+inline uint8_t  sub8(uint8_t i, uint8_t j) { return i - j; }
+inline uint8_t  mul8(uint8_t i, uint8_t j) { return i * j; }
+inline uint8_t  addmod8(uint8_t a, uint8_t b, uint8_t m) { a += b; while (a >= m) a -= m; return a; }
+inline uint8_t  submod8(uint8_t a, uint8_t b, uint8_t m) { a -= b; while (a >= m) a -= m; return a; }
+inline uint8_t  avg8(uint8_t i, uint8_t j) { return (i + j) >> 1; }
+inline uint16_t avg16(uint16_t i, uint16_t j) { return (uint32_t)((uint32_t)(i) + (uint32_t)(j)) >> 1; }
+inline int16_t  avg15(int16_t i, int16_t j) { return (i >> 1) + (j >> 1) + (i & 0x1); }
+inline uint8_t  abs8(int8_t i) { return i < 0 ? -i : i; }
+inline uint8_t  map8(uint8_t in, uint8_t rangeStart, uint8_t rangeEnd) { return rangeStart + scale8(in, rangeEnd - rangeStart); }
+inline uint8_t  lerp8by8(uint8_t a, uint8_t b, fract8 frac) { return b > a ? a + scale8(b - a, frac) : a - scale8(a - b, frac); }
+inline uint16_t lerp16by16(uint16_t a, uint16_t b, fract16 frac) { return b > a ? a + scale16(b - a, frac) : a - scale16(a - b, frac); }
+inline uint16_t lerp16by8(uint16_t a, uint16_t b, fract8 frac) { return b > a ? a + scale16by8(b - a, frac) : a - scale16by8(a - b, frac); }
+inline int16_t  lerp15by16(int16_t a, int16_t b, fract16 frac) { return b > a ? a + scale16(b - a, frac) : a - scale16(a - b, frac); }
+inline uint8_t  dim8_raw(uint8_t x) { return scale8(x, x); }
+inline uint8_t  dim8_video(uint8_t x) { return scale8_video(x, x); }
+inline uint8_t  dim8_lin(uint8_t x) { return (x & 0x80) ? scale8(x, x) : (x + 1) / 2; }
+inline uint8_t  brighten8_raw(uint8_t x) { uint8_t ix = 255 - x; return 255 - scale8(ix, ix); }
+inline uint8_t  ease8InOutQuad(uint8_t i) { uint8_t j = i; if (j & 0x80) j = 255 - j; uint8_t jj = scale8(j, j); uint8_t jj2 = jj << 1; if (i & 0x80) jj2 = 255 - jj2; return jj2; }
+inline uint16_t ease16InOutQuad(uint16_t i) { uint16_t j = i; if (j & 0x8000) j = 65535 - j; uint16_t jj = scale16(j, j); uint16_t jj2 = jj << 1; if (i & 0x8000) jj2 = 65535 - jj2; return jj2; }
+inline uint8_t  ease8InOutCubic(uint8_t i) { uint8_t ii = scale8(i, i); uint8_t iii = scale8(ii, i); uint16_t r1 = (3 * (uint16_t)ii) - (2 * (uint16_t)iii); return (r1 & 0x100) ? 255 : r1; }
+inline uint8_t  ease8InOutApprox(uint8_t i) { if (i < 64) return i / 2; if (i > 191) return 255 - (255 - i) / 2; return 32 + ((i - 64) * 191) / 127; }
+inline uint8_t  triwave8(uint8_t in) { if (in & 0x80) in = 255 - in; return in << 1; }
+inline uint8_t  quadwave8(uint8_t in) { return ease8InOutQuad(triwave8(in)); }
+inline uint8_t  cubicwave8(uint8_t in) { return ease8InOutCubic(triwave8(in)); }
+inline uint16_t sqrt16(uint16_t x) { return (uint16_t)sqrtf(x); }
+inline int16_t  sin16(uint16_t theta) { return (int16_t)lrintf(sinf(theta * (2.0f * (float)M_PI / 65536.0f)) * 32767.0f); }
+inline int16_t  cos16(uint16_t theta) { return sin16(theta + 16384); }
+inline uint8_t  sin8(uint8_t theta) { return (sin16((uint16_t)theta << 8) + 32768) >> 8; }
+inline uint8_t  cos8(uint8_t theta) { return sin8(theta + 64); }
+
+inline uint16_t beat88(accum88 bpm88, uint32_t timebase = 0) { return ((millis() - timebase) * bpm88 * 280) >> 16; }
+inline uint16_t beat16(accum88 bpm, uint32_t timebase = 0) { if (bpm < 256) bpm <<= 8; return beat88(bpm, timebase); }
+inline uint8_t  beat8(accum88 bpm, uint32_t timebase = 0) { return beat16(bpm, timebase) >> 8; }
+inline uint16_t beatsin88(accum88 bpm88, uint16_t lo = 0, uint16_t hi = 65535, uint32_t timebase = 0, uint16_t phase = 0) {
+  uint16_t beatsin = (sin16(beat88(bpm88, timebase) + phase) + 32768);
+  return lo + scale16(beatsin, hi - lo);
+}
+inline uint16_t beatsin16(accum88 bpm, uint16_t lo = 0, uint16_t hi = 65535, uint32_t timebase = 0, uint16_t phase = 0) {
+  uint16_t beatsin = (sin16(beat16(bpm, timebase) + phase) + 32768);
+  return lo + scale16(beatsin, hi - lo);
+}
+inline uint8_t  beatsin8(accum88 bpm, uint8_t lo = 0, uint8_t hi = 255, uint32_t timebase = 0, uint8_t phase = 0) {
+  uint8_t beatsin = sin8(beat8(bpm, timebase) + phase);
+  return lo + scale8(beatsin, hi - lo);
+}
+
+//FastLED's global generator, effects use the per segment one in WS2812FX
+extern uint16_t rand16seed;
+inline uint8_t  random8() { rand16seed = (rand16seed * 2053) + 13849; return (uint8_t)(((uint8_t)(rand16seed & 0xFF)) + ((uint8_t)(rand16seed >> 8))); }
+inline uint8_t  random8(uint8_t lim) { return (random8() * lim) >> 8; }
+inline uint8_t  random8(uint8_t min, uint8_t lim) { return random8(lim - min) + min; }
+inline uint16_t random16() { rand16seed = (rand16seed * 2053) + 13849; return rand16seed; }
+inline uint16_t random16(uint16_t lim) { return ((uint32_t)random16() * lim) >> 16; }
+inline uint16_t random16(uint16_t min, uint16_t lim) { return random16(lim - min) + min; }
+inline void     random16_set_seed(uint16_t seed) { rand16seed = seed; }
+inline void     random16_add_entropy(uint16_t entropy) { rand16seed += entropy; }
+inline uint32_t get_millisecond_timer() { return millis(); }
+
+//value noise with the FastLED signatures, not the FastLED gradients
+inline uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z) { uint32_t h = x * 0x9E3779B1u ^ y * 0x85EBCA77u ^ z * 0xC2B2AE3Du; h ^= h >> 15; return h; }
+inline uint16_t inoise16(uint32_t x, uint32_t y) { return inoise16(x, y, 0); }
+inline uint16_t inoise16(uint32_t x) { return inoise16(x, 0, 0); }
+inline uint8_t  inoise8(uint16_t x, uint16_t y, uint16_t z) { return inoise16((uint32_t)x << 8, (uint32_t)y << 8, (uint32_t)z << 8) >> 8; }
+inline uint8_t  inoise8(uint16_t x, uint16_t y) { return inoise8(x, y, 0); }
+inline uint8_t  inoise8(uint16_t x) { return inoise8(x, 0, 0); }
+
+struct CHSV {
+  union { struct { uint8_t h, s, v; }; struct { uint8_t hue, sat, val; }; uint8_t raw[3]; };
+  CHSV() {}
+  CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+inline void hsv2rgb_spectrum(const CHSV& hsv, CRGB& rgb) { hsv2rgb_rainbow(hsv, rgb); }
+
+struct CRGB {
+  union { struct { uint8_t r, g, b; }; struct { uint8_t red, green, blue; }; uint8_t raw[3]; };
+  CRGB() {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(uint32_t c) : r(c >> 16), g(c >> 8), b(c) {}
+  CRGB(const CHSV& hsv) { hsv2rgb_rainbow(hsv, *this); }
+  CRGB& operator=(const CHSV& hsv) { hsv2rgb_rainbow(hsv, *this); return *this; }
+  CRGB& operator=(uint32_t c) { r = c >> 16; g = c >> 8; b = c; return *this; }
+  CRGB& setRGB(uint8_t nr, uint8_t ng, uint8_t nb) { r = nr; g = ng; b = nb; return *this; }
+  CRGB& setHue(uint8_t hue) { hsv2rgb_rainbow(CHSV(hue, 255, 255), *this); return *this; }
+  CRGB& operator+=(const CRGB& o) { r = qadd8(r, o.r); g = qadd8(g, o.g); b = qadd8(b, o.b); return *this; }
+  CRGB& operator-=(const CRGB& o) { r = qsub8(r, o.r); g = qsub8(g, o.g); b = qsub8(b, o.b); return *this; }
+  CRGB& operator|=(const CRGB& o) { if (o.r > r) r = o.r; if (o.g > g) g = o.g; if (o.b > b) b = o.b; return *this; }
+  CRGB& operator%=(uint8_t s) { return nscale8_video(s); }
+  CRGB& operator*=(uint8_t d) { r = qmul8(r, d); g = qmul8(g, d); b = qmul8(b, d); return *this; }
+  CRGB& operator/=(uint8_t d) { r /= d; g /= d; b /= d; return *this; }
+  CRGB& operator>>=(uint8_t d) { r >>= d; g >>= d; b >>= d; return *this; }
+  CRGB& nscale8(uint8_t s) { r = scale8(r, s); g = scale8(g, s); b = scale8(b, s); return *this; }
+  CRGB& nscale8_video(uint8_t s) { r = scale8_video(r, s); g = scale8_video(g, s); b = scale8_video(b, s); return *this; }
+  CRGB& fadeToBlackBy(uint8_t f) { return nscale8(255 - f); }
+  CRGB& fadeLightBy(uint8_t f) { return nscale8_video(255 - f); }
+  uint8_t getAverageLight() const { return (scale8(r, 85) + scale8(g, 85) + scale8(b, 85)); }
+  uint8_t getLuma() const { return scale8(r, 54) + scale8(g, 183) + scale8(b, 18); }
+  uint8_t& operator[](uint8_t x) { return raw[x]; }
+  operator bool() const { return r || g || b; }
+  enum {
+    Black=0x000000, White=0xFFFFFF, Red=0xFF0000, Green=0x008000, Blue=0x0000FF, DarkOrange=0xFF8C00, Orange=0xFFA500,
+    Gold=0xFFD700, Yellow=0xFFFF00, Purple=0x800080, Grey=0x808080, Gray=0x808080, Teal=0x008080, DarkGreen=0x006400,
+    OrangeRed=0xFF4500, Maroon=0x800000, Navy=0x000080, Cyan=0x00FFFF, Magenta=0xFF00FF, DarkRed=0x8B0000,
+    FireBrick=0xB22222, HotPink=0xFF69B4, Pink=0xFFC0CB, Lime=0x00FF00, Aqua=0x00FFFF, Amethyst=0x9966CC,
+    Gainsboro=0xDCDCDC, DarkBlue=0x00008B, Indigo=0x4B0082, LightGreen=0x90EE90, SkyBlue=0x87CEEB, Violet=0xEE82EE,
+    Brown=0xA52A2A, SeaGreen=0x2E8B57, DeepSkyBlue=0x00BFFF, DarkGoldenrod=0xB8860B, Crimson=0xDC143C,
+    Sienna=0xA0522D, Chocolate=0xD2691E, LawnGreen=0x7CFC00, LightBlue=0xADD8E6, Salmon=0xFA8072, Tomato=0xFF6347,
+    Snow=0xFFFAFA, FairyLight=0xFFE42D, Plaid=0xCC5533
+  };
+};
+
+inline CRGB operator+(const CRGB& a, const CRGB& b) { CRGB c = a; return c += b; }
+inline CRGB operator-(const CRGB& a, const CRGB& b) { CRGB c = a; return c -= b; }
+inline CRGB operator%(const CRGB& a, uint8_t s) { CRGB c = a; return c %= s; }
+inline CRGB operator*(const CRGB& a, uint8_t d) { CRGB c = a; return c *= d; }
+inline bool operator==(const CRGB& a, const CRGB& b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+inline bool operator!=(const CRGB& a, const CRGB& b) { return !(a == b); }
+
+inline void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb)
+{
+  uint8_t region = hsv.h / 43, rem = (hsv.h - region * 43) * 6;
+  uint8_t p = scale8(hsv.v, 255 - hsv.s), q = scale8(hsv.v, 255 - scale8(hsv.s, rem)), t = scale8(hsv.v, 255 - scale8(hsv.s, 255 - rem));
+  switch (region) {
+    case 0:  rgb = CRGB(hsv.v, t, p); break;
+    case 1:  rgb = CRGB(q, hsv.v, p); break;
+    case 2:  rgb = CRGB(p, hsv.v, t); break;
+    case 3:  rgb = CRGB(p, q, hsv.v); break;
+    case 4:  rgb = CRGB(t, p, hsv.v); break;
+    default: rgb = CRGB(hsv.v, p, q); break;
+  }
+}
+inline CHSV rgb2hsv_approximate(const CRGB& c)
+{
+  uint8_t mx = max(c.r, max(c.g, c.b)), mn = min(c.r, min(c.g, c.b));
+  if (mx == mn) return CHSV(0, 0, mx);
+  int d = mx - mn, h;
+  if (mx == c.r) h = 43 * (c.g - c.b) / d; else if (mx == c.g) h = 85 + 43 * (c.b - c.r) / d; else h = 171 + 43 * (c.r - c.g) / d;
+  return CHSV(h, d * 255 / mx, mx);
+}
+
+inline CRGB& nblend(CRGB& existing, const CRGB& overlay, fract8 amount)
+{
+  existing.r = lerp8by8(existing.r, overlay.r, amount);
+  existing.g = lerp8by8(existing.g, overlay.g, amount);
+  existing.b = lerp8by8(existing.b, overlay.b, amount);
+  return existing;
+}
+inline CRGB blend(const CRGB& a, const CRGB& b, fract8 amount) { CRGB c = a; return nblend(c, b, amount); }
+inline void fill_solid(CRGB* leds, int n, const CRGB& c) { for (int i = 0; i < n; i++) leds[i] = c; }
+inline void fadeToBlackBy(CRGB* leds, uint16_t n, uint8_t f) { for (uint16_t i = 0; i < n; i++) leds[i].fadeToBlackBy(f); }
+
+typedef const uint8_t  TProgmemRGBGradientPalette_byte;
+typedef const uint8_t* TProgmemRGBGradientPalette_bytes;
+typedef const uint8_t* TProgmemRGBGradientPalettePtr;
+typedef uint8_t        TDynamicRGBGradientPalette_byte;
+typedef uint32_t       TProgmemRGBPalette16[16];
+#define DEFINE_GRADIENT_PALETTE(n) const uint8_t n[] =
+#define DECLARE_GRADIENT_PALETTE(n) extern const uint8_t n[]
+
+enum TBlendType { NOBLEND = 0, LINEARBLEND = 1 };
+
+struct CRGBPalette16 {
+  CRGB entries[16];
+  CRGBPalette16() { fill_solid(entries, 16, CRGB(0)); }
+  CRGBPalette16(const CRGB& c) { fill_solid(entries, 16, c); }
+  CRGBPalette16(const CRGB& c1, const CRGB& c2) { gradient(c1, c1, c2, c2, 2); }
+  CRGBPalette16(const CRGB& c1, const CRGB& c2, const CRGB& c3) { gradient(c1, c2, c3, c3, 3); }
+  CRGBPalette16(const CRGB& c1, const CRGB& c2, const CRGB& c3, const CRGB& c4) { gradient(c1, c2, c3, c4, 4); }
+  CRGBPalette16(const CHSV& c1, const CHSV& c2, const CHSV& c3, const CHSV& c4) { gradient(CRGB(c1), CRGB(c2), CRGB(c3), CRGB(c4), 4); }
+  CRGBPalette16(const CRGB& c00, const CRGB& c01, const CRGB& c02, const CRGB& c03, const CRGB& c04, const CRGB& c05, const CRGB& c06, const CRGB& c07,
+                const CRGB& c08, const CRGB& c09, const CRGB& c10, const CRGB& c11, const CRGB& c12, const CRGB& c13, const CRGB& c14, const CRGB& c15) {
+    const CRGB* c[16] = {&c00, &c01, &c02, &c03, &c04, &c05, &c06, &c07, &c08, &c09, &c10, &c11, &c12, &c13, &c14, &c15};
+    for (uint8_t i = 0; i < 16; i++) entries[i] = *c[i];
+  }
+  CRGBPalette16(std::initializer_list<uint32_t> l) { uint8_t i = 0; for (uint32_t c : l) if (i < 16) entries[i++] = CRGB(c); }
+  CRGBPalette16(const uint8_t* gpal) { loadDynamicGradientPalette(gpal); }
+  CRGBPalette16& operator=(const uint8_t* gpal) { loadDynamicGradientPalette(gpal); return *this; }
+  CRGB& operator[](int x) { return entries[x]; }
+  const CRGB& operator[](int x) const { return entries[x]; }
+  bool operator==(const CRGBPalette16& o) const { for (uint8_t i = 0; i < 16; i++) if (entries[i] != o.entries[i]) return false; return true; }
+  bool operator!=(const CRGBPalette16& o) const { return !(*this == o); }
+
+  //gradient palettes are (index, r, g, b) entries up to index 255
+  void loadDynamicGradientPalette(const uint8_t* gpal) {
+    for (uint8_t i = 0; i < 16; i++) {
+      uint8_t idx = i * 17;
+      const uint8_t* p = gpal;
+      while (p[0] < idx && p[0] != 255) p += 4;
+      const uint8_t* lo = (p == gpal) ? p : p - 4;
+      uint8_t span = p[0] - lo[0];
+      uint8_t f = span ? ((idx - lo[0]) * 255) / span : 0;
+      entries[i] = blend(CRGB(lo[1], lo[2], lo[3]), CRGB(p[1], p[2], p[3]), f);
+    }
+  }
+
+  private:
+  void gradient(const CRGB& c1, const CRGB& c2, const CRGB& c3, const CRGB& c4, uint8_t n) {
+    const CRGB* c[4] = {&c1, &c2, &c3, &c4};
+    for (uint8_t i = 0; i < 16; i++) {
+      uint16_t pos = (uint16_t)i * (n - 1) * 256 / 15;
+      uint8_t k = pos >> 8;
+      entries[i] = (k >= n - 1) ? *c[n - 1] : blend(*c[k], *c[k + 1], pos & 0xFF);
+    }
+  }
+};
+struct CHSVPalette16 {};
+
+inline CRGB ColorFromPalette(const CRGBPalette16& pal, uint8_t index, uint8_t brightness = 255, TBlendType blendType = LINEARBLEND)
+{
+  uint8_t hi4 = index >> 4, lo4 = index & 0x0F;
+  CRGB c = pal[hi4];
+  if (blendType && lo4) c = blend(c, pal[(hi4 + 1) & 0x0F], lo4 << 4);
+  if (brightness != 255) c.nscale8_video(brightness);
+  return c;
+}
+
+inline void nblendPaletteTowardPalette(CRGBPalette16& current, CRGBPalette16& target, uint8_t maxChanges = 24)
+{
+  uint8_t changes = 0;
+  for (uint8_t i = 0; i < 48 && changes < maxChanges; i++) {
+    uint8_t& p = current.entries[i / 3].raw[i % 3];
+    uint8_t  t = target.entries[i / 3].raw[i % 3];
+    if (p < t) { p++; changes++; }
+    if (p > t) { p -= (p - t > 1) ? 2 : 1; changes++; }
+  }
+}
+
+extern const CRGBPalette16 CloudColors_p, LavaColors_p, OceanColors_p, ForestColors_p, RainbowColors_p, RainbowStripeColors_p,
+                           PartyColors_p, HeatColors_p;
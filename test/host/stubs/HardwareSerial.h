@@ -0,0 +1,40 @@
+#pragma once
+//UART on a file descriptor (a pty in the tests). Bytes that arrive while the receive buffer is full are dropped, like on the controller.
+#include <deque>
+
+class HardwareSerial {
+  public:
+    void begin(unsigned long baud) { _baud = baud; }
+    void end() { _rx.clear(); }
+    size_t setRxBufferSize(size_t size) { _rxSize = size; return size; }
+    void updateBaudRate(unsigned long baud) { _baud = baud; }
+    void setTimeout(unsigned long) {}
+    void flush() {}
+
+    int available();
+    int peek();
+    int read();
+    size_t readBytes(uint8_t* buf, size_t len);
+    size_t readBytes(char* buf, size_t len) { return readBytes((uint8_t*)buf, len); }
+
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t len);
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(long n) { char b[12]; snprintf(b, sizeof(b), "%ld", n); return print(b); }
+    size_t println(const char* s = "") { return print(s) + print("\r\n"); }
+    size_t println(long n) { return print(n) + print("\r\n"); }
+
+    //host only
+    int fd = -1;                  //read and written without blocking
+    unsigned long baud() { return _baud; }
+    size_t rxBufferSize() { return _rxSize; }
+    uint32_t dropped = 0;         //bytes lost to a full receive buffer
+
+  private:
+    void poll();
+    std::deque<uint8_t> _rx;
+    size_t _rxSize = 256;         //ESP32 and ESP8266 default
+    unsigned long _baud = 0;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,15 @@
+#pragma once
+//IPAddress of the Arduino core, for the network modules
+#include <Arduino.h>
+
+class IPAddress {
+  public:
+    IPAddress(uint32_t a = 0) : _a(a) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _a(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    operator uint32_t() const { return _a; }
+    bool operator==(const IPAddress& o) const { return _a == o._a; }
+    uint8_t operator[](int i) const { return _a >> (i * 8); }
+    uint8_t& operator[](int i) { return ((uint8_t*)&_a)[i]; }
+  private:
+    uint32_t _a;
+};
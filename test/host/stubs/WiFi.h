@@ -0,0 +1,20 @@
+#pragma once
+//network classes of the Arduino core: addresses, and a UDP socket that keeps the last packet sent for the test to read
+#include <IPAddress.h>
+
+class WiFiUDP {
+  public:
+    int beginPacket(IPAddress ip, uint16_t port) { txIp = ip; txPort = port; txLen = 0; return 1; }
+    size_t write(const uint8_t* buf, size_t len) {
+      if (len > sizeof(tx) - txLen) len = sizeof(tx) - txLen;
+      memcpy(tx + txLen, buf, len); txLen += len;
+      return len;
+    }
+    int endPacket() { txPackets++; return 1; }
+
+    IPAddress txIp;
+    uint16_t  txPort = 0;
+    uint8_t   tx[1472];
+    size_t    txLen = 0;
+    uint32_t  txPackets = 0;
+};
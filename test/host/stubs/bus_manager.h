@@ -0,0 +1,101 @@
+#pragma once
+//replaces wled00/bus_manager.h for host tests: every bus keeps its pixels in memory
+#include <vector>
+#include "const.h"
+
+struct BusConfig {
+  uint8_t type = TYPE_WS2812_RGB;
+  uint16_t count;
+  uint16_t start;
+  uint8_t colorOrder;
+  bool reversed;
+  uint8_t skipAmount;
+  bool refreshReq = false;
+  uint16_t maxPower = 0;
+  uint8_t pins[5] = {LEDPIN, 255, 255, 255, 255};
+  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0) {
+    type = busType & 0x7F;
+    count = len; start = pstart; colorOrder = pcolorOrder; reversed = rev; skipAmount = skip;
+    pins[0] = ppins[0];
+  }
+};
+
+class Bus {
+  public:
+    Bus(const BusConfig& bc) : _type(bc.type), _start(bc.start), _pixels(bc.count, 0) {}
+    void     show() { _shows++; }
+    bool     canShow() { return true; }
+    void     setPixelColor(uint16_t pix, uint32_t c) { if (pix < _pixels.size()) _pixels[pix] = c; }
+    uint32_t getPixelColor(uint16_t pix) { return pix < _pixels.size() ? _pixels[pix] : 0; }
+    void     setBrightness(uint8_t b) { _bri = b; }
+    uint8_t  getPins(uint8_t* pinArray) { return 0; }
+    uint16_t getLength() { return _pixels.size(); }
+    uint16_t getStart() { return _start; }
+    uint8_t  getType() { return _type; }
+    bool     isOffRefreshRequired() { return false; }
+    bool     isRgbw() { return _type == TYPE_SK6812_RGBW; }
+    uint16_t getMaxPower() { return 0; }
+    uint16_t getMilliamps() { return _milliamps; }
+    void     setMilliamps(uint16_t mA) { _milliamps = mA; }
+    uint32_t getPowerSum(bool ws2815) {
+      uint32_t sum = 0;
+      for (uint32_t c : _pixels) sum += (c & 0xFF) + ((c >> 8) & 0xFF) + ((c >> 16) & 0xFF) + (c >> 24);
+      return sum;
+    }
+    static void setCCT(int16_t cct) { _cct = cct; }
+
+    uint8_t  _bri = 255;
+    uint32_t _shows = 0;
+    std::vector<uint32_t> _pixels;
+
+  protected:
+    uint8_t  _type;
+    uint16_t _start;
+    uint16_t _milliamps = 0;
+    static uint8_t _autoWhiteMode;
+    static int16_t _cct;
+    static uint8_t _cctBlend;
+};
+
+class BusDigital : public Bus {
+  public:
+    void reinit() {}
+};
+
+class BusManager {
+  public:
+  int add(BusConfig& bc) {
+    if (numBusses >= WLED_MAX_BUSSES) return -1;
+    busses[numBusses] = new Bus(bc);
+    return numBusses++;
+  }
+  void removeAll() {
+    for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
+    numBusses = 0;
+  }
+  void show() { for (uint8_t i = 0; i < numBusses; i++) busses[i]->show(); }
+  void setPixelColor(uint16_t pix, uint32_t c, int16_t cct=-1) {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      Bus* b = busses[i];
+      if (pix >= b->getStart() && pix < b->getStart() + b->getLength()) b->setPixelColor(pix - b->getStart(), c);
+    }
+  }
+  uint32_t getPixelColor(uint16_t pix) {
+    reads++;
+    for (uint8_t i = 0; i < numBusses; i++) {
+      Bus* b = busses[i];
+      if (pix >= b->getStart() && pix < b->getStart() + b->getLength()) return b->getPixelColor(pix - b->getStart());
+    }
+    return 0;
+  }
+  void setBrightness(uint8_t b) { for (uint8_t i = 0; i < numBusses; i++) busses[i]->setBrightness(b); }
+  void setSegmentCCT(int16_t cct, bool allowWBCorrection = false) { Bus::setCCT(cct); }
+  bool canAllShow() { return true; }
+  Bus* getBus(uint8_t busNr) { return busNr < numBusses ? busses[busNr] : nullptr; }
+  uint8_t getNumBusses() { return numBusses; }
+  uint32_t reads = 0; //host only: pixels read back from the output
+
+  private:
+  uint8_t numBusses = 0;
+  Bus* busses[WLED_MAX_BUSSES];
+};
@@ -0,0 +1,34 @@
+//globals of wled.cpp and FastLED the effect engine (FX*.cpp) needs on the host
+#include "wled.h"
+
+BusManager busses;
+HostFS WLED_FS;
+StaticJsonDocument<JSON_BUFFER_SIZE> doc;
+bool correctWB = false;
+bool cctFromRgb = false;
+bool autoSegments = false;
+uint32_t metricFsBytesWritten = 0;
+
+volatile uint8_t jsonBufferLock = 0;
+bool requestJSONBufferLock(uint8_t module) { if (jsonBufferLock) return false; jsonBufferLock = module ? module : 255; return true; }
+void releaseJSONBufferLock() { jsonBufferLock = 0; }
+
+uint16_t rand16seed = 1337;
+
+const CRGBPalette16 CloudColors_p(CRGB::Blue, CRGB::DarkBlue, CRGB::SkyBlue, CRGB::White);
+const CRGBPalette16 LavaColors_p(CRGB::Black, CRGB::Maroon, CRGB::Red, CRGB::Orange);
+const CRGBPalette16 OceanColors_p(CRGB::Navy, CRGB::Blue, CRGB::Teal, CRGB::Aqua);
+const CRGBPalette16 ForestColors_p(CRGB::DarkGreen, CRGB::Green, CRGB::SeaGreen, CRGB::LawnGreen);
+const CRGBPalette16 RainbowColors_p(CRGB::Red, CRGB::Yellow, CRGB::Aqua, CRGB::Purple);
+const CRGBPalette16 RainbowStripeColors_p(CRGB::Red, CRGB::Black, CRGB::Aqua, CRGB::Black);
+const CRGBPalette16 PartyColors_p(CRGB::Purple, CRGB::Red, CRGB::Yellow, CRGB::Blue);
+const CRGBPalette16 HeatColors_p(CRGB::Black, CRGB::Red, CRGB::Yellow, CRGB::White);
+
+//one bus of the given length, replacing any earlier ones
+void hostSetupBus(uint16_t len)
+{
+  busses.removeAll();
+  uint8_t pins[1] = {2};
+  BusConfig bc(TYPE_WS2812_RGB, pins, 0, len);
+  busses.add(bc);
+}
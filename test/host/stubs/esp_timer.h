@@ -0,0 +1,4 @@
+#pragma once
+//64 bit microsecond clock of the ESP32, follows the host clock (see hostSetMicros())
+#include <stdint.h>
+int64_t esp_timer_get_time();
@@ -0,0 +1,99 @@
+#include "wled.h"
+#include "esp_timer.h"
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+byte col[4]    = {255, 160, 0, 0};
+byte colSec[4] = {0, 0, 0, 0};
+
+static bool     fixedTime = false;
+static uint64_t fixedMicros = 0;
+
+static uint64_t hostMicros()
+{
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+unsigned long millis() { return (fixedTime ? fixedMicros : hostMicros()) / 1000; }
+unsigned long micros() { return fixedTime ? fixedMicros : hostMicros(); }
+int64_t esp_timer_get_time() { return fixedTime ? fixedMicros : hostMicros(); }
+void hostSetMillis(uint32_t ms) { fixedTime = true; fixedMicros = (uint64_t)ms * 1000; }
+void hostSetMicros(uint64_t us) { fixedTime = true; fixedMicros = us; }
+void hostRealTime() { fixedTime = false; }
+uint32_t hostYields = 0;
+void yield() { hostYields++; }
+void delay(unsigned long ms) { if (fixedTime) fixedMicros += (uint64_t)ms * 1000; else std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+static uint32_t hostRandState = 1;
+void randomSeed(unsigned long seed) { hostRandState = seed ? seed : 1; }
+long random(long howbig)
+{
+  if (howbig <= 0) return 0;
+  hostRandState ^= hostRandState << 13; hostRandState ^= hostRandState >> 17; hostRandState ^= hostRandState << 5;
+  return hostRandState % howbig;
+}
+long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+//gradient palettes are copied from flash with a fixed length, reading past the shorter ones
+__attribute__((no_sanitize_address)) void* memcpy_P(void* dest, const void* src, size_t n)
+{
+  volatile uint8_t* d = (uint8_t*)dest;
+  const volatile uint8_t* s = (const uint8_t*)src;
+  while (n--) *d++ = *s++;
+  return dest;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) { return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin; }
+
+HardwareSerial Serial;
+
+//a follower on 192.168.1.0/24
+NetworkClass Network;
+IPAddress NetworkClass::localIP() { return IPAddress(192, 168, 1, 20); }
+IPAddress NetworkClass::subnetMask() { return IPAddress(255, 255, 255, 0); }
+IPAddress NetworkClass::gatewayIP() { return IPAddress(192, 168, 1, 1); }
+bool NetworkClass::isConnected() { return true; }
+bool NetworkClass::isEthernet() { return false; }
+
+//moves what arrived since the last call into the receive buffer
+void HardwareSerial::poll()
+{
+  if (fd < 0) return;
+  uint8_t buf[256];
+  ssize_t n;
+  while ((n = ::read(fd, buf, sizeof(buf))) > 0) {
+    for (ssize_t i = 0; i < n; i++) {
+      if (_rx.size() < _rxSize) _rx.push_back(buf[i]);
+      else dropped++;
+    }
+  }
+}
+
+int HardwareSerial::available() { poll(); return _rx.size(); }
+int HardwareSerial::peek() { poll(); return _rx.empty() ? -1 : _rx.front(); }
+
+int HardwareSerial::read()
+{
+  poll();
+  if (_rx.empty()) return -1;
+  uint8_t c = _rx.front();
+  _rx.pop_front();
+  return c;
+}
+
+size_t HardwareSerial::readBytes(uint8_t* buf, size_t len)
+{
+  poll();
+  size_t n = 0;
+  while (n < len && !_rx.empty()) { buf[n++] = _rx.front(); _rx.pop_front(); }
+  return n;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t len)
+{
+  if (fd < 0) return len;
+  ssize_t n = ::write(fd, buf, len);
+  return n < 0 ? 0 : n;
+}
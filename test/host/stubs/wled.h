@@ -0,0 +1,133 @@
+#pragma once
+//replaces wled00/wled.h for host tests: only the engine headers and the globals the tested modules use
+#include <Arduino.h>
+#define ARDUINOJSON_DECODE_UNICODE 0
+#include "src/dependencies/json/ArduinoJson-v6.h"
+#include "FS.h"
+#include "const.h"
+#include "bus_manager.h"
+#include "FX.h"
+//the E1.31 packet layout of the real receiver, its platform headers are stubs
+#define ESP32
+#include "src/dependencies/e131/ESPAsyncE131.h"
+#undef ESP32
+#include "src/dependencies/network/Network.h"
+#include "NodeStruct.h"
+
+#define RGBW32(r,g,b,w) (uint32_t((byte(w) << 24) | (byte(r) << 16) | (byte(g) << 8) | (byte(b))))
+#define R(c) (byte((c) >> 16))
+#define G(c) (byte((c) >> 8))
+#define B(c) (byte(c))
+#define W(c) (byte((c) >> 24))
+
+#define DEBUG_PRINT(x)
+#define DEBUG_PRINTLN(x)
+#define DEBUG_PRINTF(x...)
+
+#define strcpy_P strcpy
+#define memcmp_P memcmp
+
+#define VERSION 2112080
+#define WLED_ENABLE_ADALIGHT
+
+extern byte col[4];
+extern byte colSec[4];
+extern bool correctWB;
+extern bool cctFromRgb;
+extern bool autoSegments;
+extern uint32_t metricFsBytesWritten;
+extern BusManager busses;
+extern WS2812FX strip;
+extern byte bri;
+extern byte briLast;
+extern byte realtimeMode;
+extern byte realtimeOverride;
+extern uint16_t realtimeTimeoutMs;
+
+struct HostPinManager { bool isPinAllocated(byte gpio) { return false; } };
+extern HostPinManager pinManager;
+
+//colors.cpp
+void colorKtoRGB(uint16_t kelvin, byte* rgb);
+uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb);
+
+//e131.cpp
+extern uint16_t e131Universe;
+extern byte DMXMode;
+extern uint16_t DMXAddress;
+extern byte DMXOldDimmer;
+extern byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT];
+extern bool e131SkipOutOfSequence;
+extern bool e131NewData;
+extern IPAddress realtimeIP;
+extern byte effectCurrent, effectSpeed, effectIntensity, effectPalette;
+extern uint16_t transitionDelayTemp;
+extern uint32_t metricPacketsRx[METRIC_PROTO_COUNT];
+extern uint32_t metricPacketsDropped[METRIC_PROTO_COUNT];
+extern uint32_t metricPacketsOutOfSeq[METRIC_PROTO_COUNT];
+extern uint32_t metricE131QueueDrops;
+void e131ResetFrame();
+void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void queueE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleE131Queue();
+
+//improv.cpp
+void handleImprovPacket();
+
+//json.cpp
+bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
+void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true);
+void serializeInfo(JsonObject root);
+
+//pixels.cpp
+struct PixelUpload {
+  uint8_t  header[5];
+  uint8_t  headerLen;
+  uint8_t  carry[4];
+  uint8_t  carryLen;
+  uint16_t pix;
+  uint16_t palBytes;
+  uint16_t palLen;
+  bool     error;
+  uint8_t  pal[768];
+};
+void pixelUploadBegin(PixelUpload* up);
+bool pixelUploadFeed(PixelUpload* up, const uint8_t* data, size_t len);
+bool pixelUploadEnd(PixelUpload* up);
+typedef void (*PixelSetter)(uint16_t i, byte r, byte g, byte b, byte w);
+uint8_t pixelElementLen(uint8_t format);
+uint16_t decodePixelElement(uint8_t format, const uint8_t* el, uint16_t pix, uint16_t len, const uint8_t* pal, uint16_t palBytes, PixelSetter set);
+void decodeRealtimePixels(uint8_t enc, const uint8_t* d, uint16_t len, uint16_t id, uint16_t totalLen);
+
+//led.cpp
+void colorUpdated(int callMode);
+
+//udp.cpp
+void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
+void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+bool rtInterpActive();
+void rtInterpPush();
+
+//tsync.cpp
+extern byte timeSyncMode;
+extern NodesMap Nodes;
+extern WiFiUDP notifierUdp;
+extern uint16_t udpPort;
+extern bool udpConnected;
+void handleTimeSync();
+void handleTimeSyncPacket(const uint8_t* buf, uint16_t len, IPAddress ip);
+void serializeTimeSync(JsonObject root);
+
+//util.cpp
+extern volatile uint8_t jsonBufferLock;
+bool requestJSONBufferLock(uint8_t module);
+void releaseJSONBufferLock();
+
+extern StaticJsonDocument<JSON_BUFFER_SIZE> doc;
+
+//wled_serial.cpp
+void handleSerial();
+void updateSerialBaud(uint32_t baud);
+
+//stubs/engine.cpp
+void hostSetupBus(uint16_t len);
@@ -0,0 +1,16 @@
+#pragma once
+#include <stdio.h>
+#include <inttypes.h>
+
+static unsigned testFailures = 0, testChecks = 0;
+
+#define CHECK(cond) do { testChecks++; if (!(cond)) { if (testFailures++ < 20) \
+  printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } } while (0)
+#define CHECK_EQ(a, b) do { testChecks++; long long _a = (long long)(a), _b = (long long)(b); if (_a != _b) { \
+  if (testFailures++ < 20) printf("%s:%d: %s == %s failed (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, _a, _b); } } while (0)
+
+static int testResult(const char* name)
+{
+  printf("%s: %u checks, %u failed\n", name, testChecks, testFailures);
+  return testFailures ? 1 : 0;
+}
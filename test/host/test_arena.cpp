@@ -0,0 +1,70 @@
+//segment data arena soak test: a simulated week of playlists changing effects and segment sizes on 32 segments
+#include "wled.h"
+#include "test.h"
+
+#define SEGS        32
+#define MAX_SEGLEN  150
+#define LEDS        (SEGS * MAX_SEGLEN)
+#define STEP_MS     (10 * 60 * 1000UL) //playlist entries change every 10 minutes
+#define STEPS       (7 * 24 * 6)       //one week
+#define FRAMES      3                  //rendered after each change
+
+int main()
+{
+  hostSetupBus(LEDS);
+  WS2812FX* fx = new WS2812FX();
+  fx->finalizeInit();
+  CHECK_EQ(fx->getSegmentDataSize(), 0); //nothing is reserved before an effect needs data
+
+  randomSeed(42);
+  uint16_t worstFrag = 0, maxSize = 0;
+  uint32_t changes = 0;
+  for (uint32_t step = 0; step < STEPS; step++) {
+    //about a third of the segments get a new effect, some of them a new size too
+    for (uint8_t s = 0; s < SEGS; s++) {
+      if (random(3)) continue;
+      if (!random(4)) {
+        uint16_t start = s * MAX_SEGLEN;
+        fx->setSegment(s, start, start + 1 + random(MAX_SEGLEN));
+      }
+      fx->setMode(s, random(MODE_COUNT));
+      changes++;
+    }
+    for (uint8_t f = 0; f < FRAMES; f++) {
+      hostSetMillis(step * STEP_MS + f * 100);
+      fx->service();
+      uint16_t frag = fx->getSegmentDataFragmentation();
+      if (frag > worstFrag) worstFrag = frag;
+      if (fx->getSegmentDataSize() > maxSize) maxSize = fx->getSegmentDataSize();
+      CHECK(fx->getSegmentDataUsed() <= fx->getSegmentDataSize());
+    }
+  }
+  CHECK(maxSize <= MAX_SEGMENT_DATA);
+  CHECK(fx->getSegmentDataCompactions() > 0);
+
+  printf("%u effect changes on %u segments over %u simulated days\n", changes, SEGS, (unsigned)(STEPS * STEP_MS / 86400000UL));
+  printf("arena: peak %u of %u bytes used, arena size up to %u bytes\n", fx->getSegmentDataPeak(), MAX_SEGMENT_DATA, maxSize);
+  printf("worst fragmentation (free bytes in holes) %u%%, %u compactions, %u allocations failed (budget exhausted)\n",
+         worstFrag, fx->getSegmentDataCompactions(), fx->getSegmentDataFails());
+
+  //all memory is returned once no effect needs data, deleted segments release theirs in service()
+  CHECK_EQ(fx->getSegmentsNum(), SEGS);
+  fx->setMode(0, FX_MODE_STATIC);
+  for (uint8_t s = SEGS -1; s > 0; s--) fx->setSegment(s, 0, 0);
+  CHECK_EQ(fx->getSegmentsNum(), 1);
+  hostSetMillis(STEPS * STEP_MS);
+  fx->service();
+  CHECK_EQ(fx->getSegmentDataUsed(), 0);
+  CHECK_EQ(fx->getSegmentDataSize(), 0);
+
+  //an empty allocation succeeds without data
+  WS2812FX::segment_runtime r;
+  CHECK(r.allocateData(0));
+  CHECK(r.data == nullptr);
+  CHECK(r.allocateData(100));
+  CHECK(r.data != nullptr);
+  CHECK(r.allocateData(0));
+  CHECK(r.data == nullptr);
+  CHECK_EQ(fx->getSegmentDataSize(), 0);
+  return testResult("arena");
+}
@@ -0,0 +1,89 @@
+//cloned segments: the source effect runs once, clones show its colors before opacity with their own settings
+#include "wled.h"
+#include "test.h"
+
+#define LEN  100 //per segment
+
+static WS2812FX* fx;
+static uint32_t srcOut[LEN], clnOut[LEN];
+
+static uint32_t opacity(uint32_t c, uint8_t bri)
+{
+  return RGBW32(scale8(R(c), bri), scale8(G(c), bri), scale8(B(c), bri), scale8(W(c), bri));
+}
+
+//renders the same frames from the start of the effects, keeps the source and the (reversed) clone pixels
+static void render()
+{
+  fx->reseed(0);
+  fx->setRange(0, 3 * LEN -1, 0);
+  for (uint16_t f = 0; f < 20; f++) {
+    hostSetMillis(100000 + f * 25);
+    fx->service();
+  }
+  for (uint16_t i = 0; i < LEN; i++) {
+    srcOut[i] = busses.getPixelColor(i);
+    clnOut[i] = busses.getPixelColor(2 * LEN - 1 - i);
+  }
+}
+
+int main()
+{
+  hostSetupBus(3 * LEN);
+  fx = new WS2812FX();
+  fx->finalizeInit();
+  for (uint8_t s = 0; s < 3; s++) fx->setSegment(s, s * LEN, (s + 1) * LEN);
+  fx->setMode(0, FX_MODE_PACIFICA);
+  fx->setMode(2, FX_MODE_RAINBOW_CYCLE);
+  WS2812FX::Segment& src = fx->getSegment(0);
+  WS2812FX::Segment& cln = fx->getSegment(1);
+  cln.clone = 1;
+  cln.setOption(SEG_OPTION_REVERSED, true);
+
+  //the clone shows what the source shows, nothing is read back from the bus
+  uint32_t reads = busses.reads;
+  render();
+  CHECK_EQ(busses.reads, reads + 2 * LEN); //only the ones of render()
+  uint32_t full[LEN];
+  for (uint16_t i = 0; i < LEN; i++) {
+    CHECK(srcOut[i] != 0);
+    CHECK_EQ(clnOut[i], srcOut[i]);
+    full[i] = srcOut[i];
+  }
+
+  //the opacity of the source does not reach the clone, the clone applies its own
+  src.opacity = 60;
+  cln.opacity = 200;
+  render();
+  for (uint16_t i = 0; i < LEN; i++) {
+    CHECK_EQ(srcOut[i], opacity(full[i], 60));
+    CHECK_EQ(clnOut[i], opacity(full[i], 200));
+  }
+  src.opacity = 255;
+  cln.opacity = 255;
+
+  //a source rendered at reduced resolution is interpolated the same way on the clone
+  src.scale = 4;
+  src.setOption(SEG_OPTION_CUBIC, true);
+  render();
+  uint16_t same = 0;
+  for (uint16_t i = 0; i < LEN; i++) {
+    CHECK_EQ(clnOut[i], srcOut[i]);
+    if (srcOut[i] == full[i]) same++;
+  }
+  CHECK(same < LEN); //interpolated
+
+  //a clone of a shorter source is black after it
+  fx->setSegment(0, 0, LEN / 2);
+  render();
+  for (uint16_t i = 0; i < LEN / 2; i++) CHECK_EQ(clnOut[i], srcOut[i]);
+  for (uint16_t i = LEN / 2; i < LEN; i++) CHECK_EQ(clnOut[i], 0);
+
+  //without its source the clone runs its own effect
+  cln.clone = 0;
+  fx->setMode(1, FX_MODE_STATIC);
+  cln.colors[0] = 0xFF0000;
+  render();
+  for (uint16_t i = 0; i < LEN; i++) CHECK_EQ(clnOut[i], 0xFF0000);
+  return testResult("clone");
+}
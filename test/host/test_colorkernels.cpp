@@ -0,0 +1,160 @@
+//packed color kernels: fades reach their target and stay there, the other kernels match the scalar code they replaced,
+//and how much faster they are than that code
+#include <algorithm>
+#include <chrono>
+#include "colorkernels.h"
+#include "test.h"
+
+static uint8_t ch(uint32_t c, uint8_t i) { return c >> (i * 8); }
+
+//fade_out() amount for a rate
+static uint8_t fadeAmount(uint8_t rate)
+{
+  rate = (255 - rate) >> 1;
+  return 2550 / (10 * rate + 11);
+}
+
+static uint32_t xorshift(uint32_t& s) { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+
+//the scalar code the kernels replaced (color_blend(), fade_out(), nscale8() and qadd8() on each channel)
+static uint32_t pack(uint32_t r, uint32_t g, uint32_t b, uint32_t w) { return (w << 24) | (r << 16) | (g << 8) | b; }
+
+static uint32_t scalarScale(uint32_t c, uint8_t scale)
+{
+  uint32_t s = scale + 1;
+  return pack((ch(c, 2) * s) >> 8, (ch(c, 1) * s) >> 8, (ch(c, 0) * s) >> 8, (ch(c, 3) * s) >> 8);
+}
+
+static uint32_t scalarAdd(uint32_t c1, uint32_t c2)
+{
+  uint32_t r = ch(c1, 2) + ch(c2, 2), g = ch(c1, 1) + ch(c2, 1), b = ch(c1, 0) + ch(c2, 0), w = ch(c1, 3) + ch(c2, 3);
+  return pack(r > 255 ? 255 : r, g > 255 ? 255 : g, b > 255 ? 255 : b, w > 255 ? 255 : w);
+}
+
+static uint32_t scalarBlend(uint32_t c1, uint32_t c2, uint16_t blend)
+{
+  uint32_t ib = 255 - blend;
+  return pack((ch(c2, 2) * blend + ch(c1, 2) * ib) >> 8, (ch(c2, 1) * blend + ch(c1, 1) * ib) >> 8,
+              (ch(c2, 0) * blend + ch(c1, 0) * ib) >> 8, (ch(c2, 3) * blend + ch(c1, 3) * ib) >> 8);
+}
+
+static uint32_t scalarFade(uint32_t c, uint32_t target, float mappedRate)
+{
+  uint32_t n = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    int c1 = ch(c, i), c2 = ch(target, i);
+    int delta = (c2 - c1) / mappedRate;
+    delta += (c2 == c1) ? 0 : (c2 > c1) ? 1 : -1;
+    n |= uint32_t(uint8_t(c1 + delta)) << (i * 8);
+  }
+  return n;
+}
+
+#define BENCH_PIXELS 1024
+#define BENCH_ROUNDS 20000
+
+static uint32_t benchA[BENCH_PIXELS], benchB[BENCH_PIXELS], benchOut[BENCH_PIXELS];
+static float    mappedRates[256]; //fade_out() computes these once per call
+static uint8_t  fadeAmounts[256];
+
+//ns per pixel of f over a 1024 pixel row
+template<typename F> static double bench(F f)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    uint8_t k = r;
+    for (uint16_t i = 0; i < BENCH_PIXELS; i++) benchOut[i] = f(benchA[i] ^ k, benchB[i], k);
+    asm volatile("" : : "r"(benchOut) : "memory"); //keep every round
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (BENCH_PIXELS * BENCH_ROUNDS);
+}
+
+static void benchmark()
+{
+  uint32_t seed = 7;
+  for (uint16_t i = 0; i < BENCH_PIXELS; i++) { benchA[i] = xorshift(seed); benchB[i] = xorshift(seed); }
+  for (uint16_t r = 0; r < 256; r++) { mappedRates[r] = float((255 - r) >> 1) + 1.1; fadeAmounts[r] = fadeAmount(r); }
+  struct { const char* name; double scalar, packed; } rows[] = {
+    {"scale",        bench([](uint32_t a, uint32_t, uint8_t k) { return scalarScale(a, k); }),
+                     bench([](uint32_t a, uint32_t, uint8_t k) { return colorScale(a, k); })},
+    {"add",          bench([](uint32_t a, uint32_t b, uint8_t) { return scalarAdd(a, b); }),
+                     bench([](uint32_t a, uint32_t b, uint8_t) { return colorAdd(a, b); })},
+    {"blend",        bench([](uint32_t a, uint32_t b, uint8_t k) { return scalarBlend(a, b, k); }),
+                     bench([](uint32_t a, uint32_t b, uint8_t k) { return colorBlend<false>(a, b, k); })},
+    {"fade toward",  bench([](uint32_t a, uint32_t b, uint8_t k) { return scalarFade(a, b, mappedRates[k]); }),
+                     bench([](uint32_t a, uint32_t b, uint8_t k) { return colorFadeToward(a, b, fadeAmounts[k]); })},
+  };
+  printf("%-14s %10s %10s %8s\n", "ns per pixel", "scalar", "packed", "speedup");
+  for (auto& r : rows) printf("%-14s %10.2f %10.2f %7.1fx\n", r.name, r.scalar, r.packed, r.scalar / r.packed);
+}
+
+int main()
+{
+  const uint32_t targets[] = {0x00FF8000, 0x00000000, 0xFFFFFFFF, 0x12345678, 0x80017FFE};
+  uint32_t seed = 42;
+  uint16_t worst = 0;
+  for (uint16_t rate = 0; rate < 256; rate++) {
+    uint8_t amount = fadeAmount(rate);
+    for (uint32_t target : targets) {
+      for (uint8_t s = 0; s < 8; s++) {
+        uint32_t c = (s == 0) ? target : (s == 1) ? ~target : xorshift(seed);
+        uint16_t steps = 0;
+        while (c != target && steps < 300) {
+          uint32_t n = colorFadeToward(c, target, amount);
+          for (uint8_t i = 0; i < 4; i++) { //every channel moves towards the target and does not overshoot
+            int d0 = ch(c, i) - ch(target, i), d1 = ch(n, i) - ch(target, i);
+            if (d0 > 0) CHECK(d1 >= 0 && d1 < d0);
+            else if (d0 < 0) CHECK(d1 <= 0 && d1 > d0);
+            else CHECK_EQ(d1, 0);
+          }
+          c = n;
+          steps++;
+        }
+        CHECK_EQ(c, target);
+        if (steps > worst) worst = steps;
+        for (uint8_t i = 0; i < 50; i++) c = colorFadeToward(c, target, amount);
+        CHECK_EQ(c, target); //stays there
+      }
+    }
+  }
+  printf("fades reach the target after at most %u steps\n", worst);
+
+  //the packed rounding step against the per channel one it replaced
+  for (uint32_t i = 0; i < 1000000; i++) {
+    uint32_t c = xorshift(seed), target = (i & 1) ? xorshift(seed) : c ^ (0x01010101u << (i & 7));
+    uint8_t amount = xorshift(seed);
+    uint32_t a = amount, ia = 256 - a, n = 0;
+    for (uint8_t k = 0; k < 4; k++) n |= ((ch(c, k) * ia + ch(target, k) * a) >> 8) << (k * 8);
+    for (uint8_t k = 0; k < 4; k++) {
+      uint8_t o = ch(c, k), v = ch(n, k), t = ch(target, k);
+      if (v != o || o == t) continue;
+      if (o < t) n += 1u << (k * 8);
+      else       n -= 1u << (k * 8);
+    }
+    CHECK_EQ(colorFadeToward(c, target, amount), n);
+  }
+
+  //exact against the scalar versions for random colors
+  for (uint32_t i = 0; i < 100000; i++) {
+    uint32_t c1 = xorshift(seed), c2 = xorshift(seed);
+    uint16_t b16 = xorshift(seed);
+    uint8_t b = b16;
+    uint32_t scale = 0, add = 0, blend = 0, blend16 = 0;
+    for (uint8_t k = 0; k < 4; k++) {
+      uint32_t x = ch(c1, k), y = ch(c2, k);
+      scale   |= ((x * (b + 1)) >> 8) << (k * 8);
+      add     |= std::min<uint32_t>(x + y, 255) << (k * 8);
+      blend   |= ((x * (255 - b) + y * b) >> 8) << (k * 8);
+      blend16 |= ((x * (0xFFFF - b16) + y * b16) >> 16) << (k * 8);
+    }
+    CHECK_EQ(colorScale(c1, b), scale);
+    CHECK_EQ(colorAdd(c1, c2), add);
+    CHECK_EQ(colorBlend<false>(c1, c2, b), blend);
+    CHECK_EQ(scalarScale(c1, b), scale); //the benchmark references compute the same
+    CHECK_EQ(scalarAdd(c1, c2), add);
+    CHECK_EQ(scalarBlend(c1, c2, b), blend);
+    CHECK_EQ(colorBlend<true>(c1, c2, b16), blend16);
+  }
+  benchmark();
+  return testResult("colorkernels");
+}
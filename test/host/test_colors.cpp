@@ -0,0 +1,23 @@
+//white balance table of colorBalanceFromKelvin() against the per pixel calculation it replaced
+#include "wled.h"
+#include "test.h"
+
+static uint32_t balanceReference(uint16_t kelvin, uint32_t c)
+{
+  byte rgbw[4] = {0};
+  colorKtoRGB(kelvin, rgbw);
+  return RGBW32(((uint16_t) rgbw[0] * R(c)) /255, ((uint16_t) rgbw[1] * G(c)) /255, ((uint16_t) rgbw[2] * B(c)) /255, W(c));
+}
+
+int main()
+{
+  //every channel value at each kelvin step, with kelvin changing between calls to catch stale tables
+  for (uint16_t k = 1900; k <= 10091; k += 37) {
+    for (uint16_t x = 0; x < 256; x++) {
+      uint32_t c = RGBW32(x, 255 - x, (x * 7) & 0xFF, x ^ 0x5A);
+      CHECK_EQ(colorBalanceFromKelvin(k, c), balanceReference(k, c));
+    }
+    CHECK_EQ(colorBalanceFromKelvin(6500, 0xFFFFFFFF), balanceReference(6500, 0xFFFFFFFF));
+  }
+  return testResult("colors");
+}
@@ -0,0 +1,107 @@
+//E1.31 packet queue: a producer thread (the AsyncUDP task) and the loop, no packet may be torn, reordered or lost unnoticed
+//built with the thread sanitizer, a data race on a queue slot fails the test as well
+#include "wled.h"
+#include "test.h"
+#include <atomic>
+#include <thread>
+
+#define LEDS     300
+#define PACKETS  200000
+
+WS2812FX strip;
+byte bri = 128;
+byte briLast = 128;
+byte realtimeMode = REALTIME_MODE_INACTIVE;
+byte realtimeOverride = REALTIME_OVERRIDE_NONE;
+uint16_t realtimeTimeoutMs = 2500;
+uint16_t e131Universe = 1;
+byte DMXMode = DMX_MODE_MULTIPLE_RGB;
+uint16_t DMXAddress = 0;
+byte DMXOldDimmer = 0;
+byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT];
+bool e131SkipOutOfSequence = false;
+bool e131NewData = false;
+IPAddress realtimeIP;
+byte effectCurrent = 0, effectSpeed = 128, effectIntensity = 128, effectPalette = 0;
+uint16_t transitionDelayTemp = 0;
+uint32_t metricPacketsRx[METRIC_PROTO_COUNT];
+uint32_t metricPacketsDropped[METRIC_PROTO_COUNT];
+uint32_t metricPacketsOutOfSeq[METRIC_PROTO_COUNT];
+uint32_t metricE131QueueDrops = 0;
+
+void colorUpdated(int callMode) {}
+bool rtInterpActive() { return false; }
+void rtInterpPush() {}
+
+static std::atomic<bool> producing(true);
+static int32_t  packetId = -1, lastId = -1; //of the packet being applied, and of the last complete one
+static uint16_t packetPixels = 0;
+static bool     packetOk = false;
+static uint32_t applied = 0, torn = 0, reordered = 0;
+
+//pixel i of packet n is (n, n >> 8, n >> 16) xor i, so shifted and mixed data both show
+static void checkPacketDone()
+{
+  if (packetId < 0) return;
+  if (!packetOk || packetPixels != LEDS) torn++;
+  else if (packetId <= lastId) reordered++;
+  else applied++;
+  lastId = packetId;
+  packetId = -1;
+}
+
+void realtimeLock(uint32_t timeoutMs, byte md)
+{
+  checkPacketDone(); //a new packet starts
+  realtimeMode = md;
+  packetPixels = 0;
+  packetOk = true;
+}
+
+void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
+{
+  int32_t id = (r | (g << 8) | (b << 16)) ^ (i * 0x010101 & 0xFFFFFF);
+  if (i == 0) packetId = id;
+  else if (id != packetId) packetOk = false;
+  if (i != packetPixels++) packetOk = false;
+  if (i % 64 == 0) std::this_thread::yield(); //a slow loop, the producer catches up with it
+}
+
+static void produce()
+{
+  static e131_packet_t p; //the receive buffer of the UDP stack, reused for every packet
+  for (int32_t n = 0; n < PACKETS; n++) {
+    memset(&p, 0, offsetof(e131_packet_t, data));
+    p.flags = DDP_PUSH_FLAG;
+    p.channelOffset = htonl(0);
+    p.dataLen = htons(LEDS * 3);
+    for (uint16_t i = 0; i < LEDS; i++) {
+      uint32_t v = n ^ (i * 0x010101 & 0xFFFFFF);
+      p.data[i*3] = v; p.data[i*3+1] = v >> 8; p.data[i*3+2] = v >> 16;
+    }
+    queueE131Packet(&p, IPAddress(10, 0, 0, 2), P_DDP);
+    if (n % 7 == 0) std::this_thread::yield();
+  }
+  producing = false;
+}
+
+int main()
+{
+  hostSetupBus(LEDS);
+  strip.finalizeInit();
+
+  std::thread producer(produce);
+  while (producing) handleE131Queue();
+  producer.join();
+  handleE131Queue(); //what is left
+  checkPacketDone();
+
+  printf("%u of %u packets applied, %u dropped (queue of %u full), %u torn, %u out of order\n",
+         applied, PACKETS, metricE131QueueDrops, E131_QUEUE_SLOTS, torn, reordered);
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(reordered, 0);
+  CHECK_EQ(applied + metricE131QueueDrops, PACKETS);
+  CHECK(applied > PACKETS / 1000);
+  CHECK(metricE131QueueDrops > 0); //the producer did overrun the loop
+  return testResult("e131");
+}
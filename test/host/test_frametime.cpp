@@ -0,0 +1,137 @@
+//frame timing of service(): the early exit until the next segment is due must not change when frames are rendered
+//the same scenario runs on an engine built with WLED_DISABLE_FRAME_SKIP, which walks all segments on every call:
+//  test_frametime_ref --trace | test_frametime
+//every shown frame (time and pixel hash) must match, and timeToNextFrame() must not report idle time past a frame
+//that is not caused by a later change
+#include "wled.h"
+#include "test.h"
+#include <string.h>
+#include <vector>
+
+#define LEDS      240
+#define DURATION  6000 //ms
+
+WS2812FX strip;
+byte bri = 128;
+byte briLast = 128;
+byte realtimeMode = REALTIME_MODE_INACTIVE;
+byte realtimeOverride = REALTIME_OVERRIDE_NONE;
+uint16_t realtimeTimeoutMs = 2500;
+
+struct Frame {
+  uint32_t t;
+  uint32_t hash;
+};
+
+struct Wait {
+  uint32_t t;
+  uint16_t ms; //timeToNextFrame() before the call at t
+};
+
+static uint32_t frameHash()
+{
+  uint32_t h = 2166136261u; //FNV-1a
+  for (uint16_t i = 0; i < LEDS; i++) {
+    uint32_t c = busses.getPixelColor(i);
+    for (uint8_t b = 0; b < 4; b++) { h ^= (c >> (b * 8)) & 0xFF; h *= 16777619u; }
+  }
+  return h;
+}
+
+//what the API and the network do to the segments while the loop runs, returns true if there was something
+static bool event(WS2812FX* fx, uint32_t t)
+{
+  switch (t) {
+    case 500:  fx->setMode(2, FX_MODE_STATIC); break;              //segment reset, all segments slow now
+    case 900:  fx->getSegment(1).setColor(0, 0x0000FF, 1); break;  //transition pulls next_time forward
+    case 1000: fx->getSegment(0).setOpacity(60, 0); break;
+    case 1300: fx->setSegment(2, 160, 220, 2, 1); fx->setMode(2, FX_MODE_RAINBOW); break; //reconfigured
+    case 1500: fx->setMode(1, FX_MODE_FIREWORKS); break;
+    case 1700: fx->trigger(); break;
+    case 2100: fx->getSegment(0).setOption(SEG_OPTION_FREEZE, true); break;
+    case 2500: fx->setSegment(1, 0, 0); break;                      //deleted
+    case 2900: fx->setSegment(3, 220, 240); fx->setMode(3, FX_MODE_BREATH); break; //added
+    case 3300: fx->getSegment(2).setOption(SEG_OPTION_ON, false, 2); break; //turns off with a transition
+    case 3700: fx->setBrightness(30); break;
+    case 4100: fx->getSegment(0).setOption(SEG_OPTION_FREEZE, false); fx->setMode(0, FX_MODE_STATIC); break;
+    case 4500: fx->setTargetFps(20); break;
+    default: return false;
+  }
+  return true;
+}
+
+/*
+ * Runs the scenario with the loop calling service() every 1-3ms, like WLED::loop() with other work in between.
+ * Returns the shown frames, wait() gets the result of timeToNextFrame() before each call, events the times of changes.
+ */
+template <typename F> static std::vector<Frame> runScenario(F wait, std::vector<uint32_t>* events = nullptr)
+{
+  std::vector<Frame> frames;
+  hostSetupBus(LEDS);
+  WS2812FX* fx = new WS2812FX();
+  fx->finalizeInit();
+  fx->rngSeed = 1234;
+  fx->setTransition(700);
+  fx->setSegment(0, 0, 80);   fx->setMode(0, FX_MODE_BLINK);
+  fx->setSegment(1, 80, 160); fx->setMode(1, FX_MODE_STATIC);
+  fx->setSegment(2, 160, 240); fx->setMode(2, FX_MODE_RAINBOW);
+  fx->getSegment(2).speed = 250;
+
+  uint32_t rng = 7, t = 100;
+  uint32_t shows = busses.getBus(0)->_shows;
+  while (t < DURATION) {
+    uint32_t step = 1 + (rng = rng * 1103515245 + 12345) % 3;
+    for (uint32_t e = t + 1; e <= t + step; e++) { hostSetMillis(e); if (event(fx, e) && events) events->push_back(e); }
+    t += step;
+    hostSetMillis(t);
+    wait(t, fx->timeToNextFrame());
+    fx->service();
+    if (busses.getBus(0)->_shows != shows) {
+      shows = busses.getBus(0)->_shows;
+      frames.push_back({t, frameHash()});
+    }
+  }
+  return frames;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1 && !strcmp(argv[1], "--trace")) {
+    for (const Frame& f : runScenario([](uint32_t, uint16_t) {})) printf("%u %08x\n", f.t, f.hash);
+    return 0;
+  }
+
+  std::vector<Frame> ref;
+  Frame f;
+  while (scanf("%u %x", &f.t, &f.hash) == 2) ref.push_back(f);
+  CHECK(ref.size() > 100);
+
+  std::vector<Wait> waits;
+  std::vector<uint32_t> events;
+  std::vector<Frame> frames = runScenario([&](uint32_t t, uint16_t wait) { waits.push_back({t, wait}); }, &events);
+
+  //the reported idle time ends at or before the next frame of the reference, unless a change in between causes that one
+  size_t next = 0, nextEvent = 0;
+  uint32_t idle = 0, early = 0;
+  for (const Wait& w : waits) {
+    uint32_t t = w.t, wait = w.ms;
+    while (next < ref.size() && ref[next].t < t) next++;
+    while (nextEvent < events.size() && events[nextEvent] <= t) nextEvent++;
+    if (wait > 1) idle++;
+    if (!wait || next >= ref.size() || ref[next].t >= t + wait) continue;
+    if (nextEvent < events.size() && events[nextEvent] <= ref[next].t) continue;
+    if (early++ < 5) printf("timeToNextFrame() %u at %u, frame at %u\n", wait, t, ref[next].t);
+  }
+  CHECK_EQ(early, 0);
+  CHECK(idle > waits.size() / 4); //it does report the idle time
+
+  CHECK_EQ(frames.size(), ref.size());
+  uint32_t diffs = 0;
+  for (size_t i = 0; i < frames.size() && i < ref.size(); i++) {
+    if (frames[i].t == ref[i].t && frames[i].hash == ref[i].hash) continue;
+    if (diffs++ < 5) printf("frame %zu: %u %08x, reference %u %08x\n", i, frames[i].t, frames[i].hash, ref[i].t, ref[i].hash);
+  }
+  CHECK_EQ(diffs, 0);
+  printf("%zu frames, %u of %zu calls with idle time reported\n", frames.size(), idle, waits.size());
+  return testResult("frametime");
+}
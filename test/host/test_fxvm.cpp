@@ -0,0 +1,196 @@
+//Expression effect: compiler conformance (folding, temporaries, error positions, operator semantics) and interpreter speed
+#include "wled.h"
+#include "test.h"
+#include "fxvm.h"
+#include <chrono>
+
+#define FX(v) ((int32_t)lround((v) * 65536.0))
+#define WIDTH 10 //canvas width for x/y
+
+static union { FxProgram p; uint8_t raw[sizeof(FxProgram) + FXVM_MAX_REGS * FXVM_SPAN * sizeof(int32_t)]; } buf;
+static FxProgram* prog = &buf.p;
+
+static bool compile(const char* src)
+{
+  const char* err = nullptr;
+  int16_t pos = fxvmCompile(src, prog, &err);
+  if (pos >= 0) printf("\"%s\": %s at %d\n", src, err, pos);
+  return pos < 0;
+}
+
+//runs n pixels from first on, returns the result register of the last one
+static int32_t run(uint16_t first, uint16_t n, uint32_t* out, uint8_t res = 0, uint32_t ms = 1500)
+{
+  fxvmInit(prog);
+  fxvmSetUniforms(prog, ms, 100, WIDTH, 10, 255, 128);
+  fxvmRun(prog, first, n, WIDTH, out);
+  return prog->lane(prog->res[res])[n -1];
+}
+
+static int32_t eval(const char* src, uint16_t i = 3)
+{
+  uint32_t out[FXVM_SPAN];
+  if (!compile(src)) { CHECK(false); return INT32_MIN; }
+  return run(i, 1, out);
+}
+
+static uint8_t temps() { return prog->regCount - FXVM_VAR_COUNT - prog->constCount; }
+
+static void checkError(const char* src, const char* msg, int16_t pos)
+{
+  const char* err = nullptr;
+  int16_t p = fxvmCompile(src, prog, &err);
+  if (p != pos || !err || strcmp(err, msg)) printf("\"%s\": got \"%s\" at %d\n", src, err ? err : "ok", p);
+  CHECK_EQ(p, pos);
+  CHECK(err && !strcmp(err, msg));
+}
+
+static void conformance()
+{
+  //constant folding: no code for constant expressions, one constant register
+  CHECK(compile("1+2*3"));
+  CHECK_EQ(prog->codeLen, 0);
+  CHECK_EQ(prog->constCount, 1);
+  CHECK_EQ(eval("1+2*3"), FX(7));
+  CHECK(compile("(2+3)*i"));
+  CHECK_EQ(prog->codeLen, 1);
+  CHECK(compile("-(1)*sin(0)+i"));
+  CHECK_EQ(prog->codeLen, 1);
+  CHECK(compile("i*2+i*2"));
+  CHECK_EQ(prog->constCount, 1); //equal constants share a register
+
+  //numbers
+  CHECK_EQ(eval(".5"), 0x8000);
+  CHECK_EQ(eval("0.1"), 6553);
+  CHECK_EQ(eval("32767"), 32767 << 16);
+  CHECK_EQ(eval("pi"), 205887);
+
+  //precedence and associativity
+  CHECK_EQ(eval("2+3*4"), FX(14));
+  CHECK_EQ(eval("(2+3)*4"), FX(20));
+  CHECK_EQ(eval("10-4-3"), FX(3));
+  CHECK_EQ(eval("8/4/2"), FX(1));
+  CHECK_EQ(eval("1+1<3"), FX(1));
+  CHECK_EQ(eval("-2*-3"), FX(6));
+  CHECK_EQ(eval("--i"), FX(3));
+
+  //operators and functions, also with variable operands so the interpreter (not the folding) is used
+  const char* const ops[][2] = {
+    {"7%3", "i*0+7%3"}, {"-7%3", "-(i+4)%3"}, {"7%-3", "(i+4)%-3"}, {"5%0", "i%0"}, {"1/0", "i/0"},
+    {"floor(-1.5)", "floor(-i/2)"}, {"frac(-1.25)", "frac(-i/2.4)"}, {"abs(-2)", "abs(-i)"}, {"clamp(1.5)", "clamp(i)"},
+    {"clamp(-1)", "clamp(-i)"}, {"min(2,3)", "min(i,4)"}, {"max(2,3)", "max(i,2)"}, {"tri(0.25)", "tri(i/12)"},
+    {"tri(0.75)", "tri(i/4)"}, {"1<2", "i<4"}, {"3>4", "i>4"}
+  };
+  const int32_t expect[] = {FX(1), FX(2), FX(-2), 0, 0, FX(-2), FX(0.75), FX(2), FX(1), 0, FX(2), FX(3), FX(0.5),
+                            FX(0.5), FX(1), 0};
+  const int32_t expectVar[] = {FX(1), FX(2), FX(-2), 0, 0, FX(-2), FX(0.75), FX(3), FX(1), 0, FX(3), FX(3), FX(0.5),
+                               FX(0.5), FX(1), 0};
+  for (uint8_t k = 0; k < sizeof(expect) / sizeof(expect[0]); k++) {
+    int32_t c = eval(ops[k][0]), v = eval(ops[k][1]);
+    if (c != expect[k] || v != expectVar[k]) printf("%s = %d, %s = %d\n", ops[k][0], c, ops[k][1], v);
+    CHECK_EQ(c, expect[k]);
+    CHECK_EQ(v, expectVar[k]);
+  }
+  CHECK(abs(eval("sin(pi/2)") - FX(1)) < 16);
+  CHECK(abs(eval("cos(0)") - FX(1)) < 16);
+  CHECK(abs(eval("sin(i-3)")) < 16);
+  int32_t n = eval("noise(x*10,y*10)");
+  CHECK(n >= 0 && n <= 0xFFFF);
+
+  //variables: i, x, y per pixel, the others per frame
+  uint32_t out[FXVM_SPAN];
+  CHECK(compile("x"));  CHECK_EQ(run(5, 4, out), FX(8 % WIDTH));
+  CHECK(compile("y"));  CHECK_EQ(run(25, 1, out), FX(2));
+  CHECK(compile("i"));  CHECK_EQ(run(5, 4, out), FX(8));
+  CHECK_EQ(eval("t"), FX(1.5));
+  CHECK_EQ(eval("len+w+h"), FX(120));
+  CHECK_EQ(eval("sx"), 0xFFFF);
+  CHECK_EQ(eval("ix"), 128 * 257);
+
+  //temporaries are reused like a stack
+  CHECK(compile("i+(i+(i+(i+i)))"));           CHECK_EQ(temps(), 1);
+  CHECK(compile("((i*i)*i)*i"));               CHECK_EQ(temps(), 1);
+  CHECK(compile("(i*i)+(i*i)"));               CHECK_EQ(temps(), 2);
+  CHECK(compile("(i*i+i*i)*(i*i+i*i)"));       CHECK_EQ(temps(), 3);
+  CHECK_EQ(eval("(i*i+i*i)*(i*i+i*i)"), FX(324));
+  CHECK_EQ(eval("(i+1)*(i-1)-(i*2)/(i-1)"), FX(5));
+
+  //outputs
+  CHECK(compile("rgb(1, 0, 0.5)"));
+  run(0, 1, out);
+  CHECK_EQ(out[0], RGBW32(255, 0, 128, 0));
+  CHECK(compile("rgb(i/2, i, 0) "));
+  CHECK_EQ(run(3, 1, out, 1), FX(3));
+  CHECK_EQ(prog->res[0] == prog->res[1], false);
+  CHECK(compile("1.25"));
+  run(0, 1, out);
+  CHECK_EQ(out[0], 0x40); //palette positions wrap
+
+  //errors and their positions
+  checkError("", "value expected", 0);
+  checkError("i+", "value expected", 2);
+  checkError("sin(i", "')' expected", 5);
+  checkError("2*(3", "')' expected", 4);
+  checkError("foo+1", "unknown name", 0);
+  checkError("i $", "unexpected character", 2);
+  checkError("min(i)", "',' expected", 5);
+  checkError("sin i", "'(' expected", 4);
+  checkError("hsv(1,2)", "',' expected", 7);
+  checkError("i+32768", "number too large", 7);
+  char src[FXVM_MAX_SRC];
+  strcpy(src, "i");
+  for (uint8_t k = 1; k <= 30; k++) sprintf(src + strlen(src), "+%d", k);
+  checkError(src, "expression too complex", strlen(src));
+  strcpy(src, "i");
+  for (uint8_t k = 0; k < 70; k++) strcat(src, "*i");
+  checkError(src, "expression too long", 131); //at the operand that does not fit
+}
+
+//the same pixels evaluated span by span and one by one
+static void batching()
+{
+  const char* src = "hsv(t*0.1 + i/len, 1 - x/w/2, tri(t + y/h) * clamp(sin(i/3)))";
+  CHECK(compile(src));
+  uint32_t a[100], b[FXVM_SPAN];
+  for (uint16_t first = 0; first < 100; first += FXVM_SPAN) run(first, MIN(FXVM_SPAN, 100 - first), a + first);
+  for (uint16_t k = 0; k < 100; k++) {
+    run(k, 1, b);
+    CHECK_EQ(a[k], b[0]);
+  }
+}
+
+static double nsPerPixel(uint16_t span, uint32_t pixels)
+{
+  uint32_t out[FXVM_SPAN];
+  auto start = std::chrono::steady_clock::now();
+  fxvmInit(prog);
+  for (uint32_t done = 0, frame = 0; done < pixels; frame++) {
+    fxvmSetUniforms(prog, frame * 20, 300, 300, 1, 128, 128);
+    for (uint16_t first = 0; first < 300; first += span, done += span) fxvmRun(prog, first, span, 300, out);
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / pixels;
+}
+
+static void benchmark()
+{
+  const char* const progs[] = {
+    "sin(t + i/8)",
+    "hsv(t*0.1 + i/len, 1, tri(t + x/w))",
+    "rgb(clamp(sin(i/5 + t)), abs(cos(i/7 - t)), frac(i*0.01 + t*0.3))",
+    "noise(x*4000 + t*1000, t*500)",
+  };
+  printf("%-68s %9s %9s\n", "expression (ns per pixel)", "1 px", "span");
+  for (const char* src : progs) {
+    if (!compile(src)) continue;
+    double one = nsPerPixel(1, 300000), span = nsPerPixel(FXVM_SPAN, 3000000);
+    printf("%-68s %9.1f %9.1f\n", src, one, span);
+  }
+}
+
+int main()
+{
+  conformance();
+  batching();
+  benchmark();
+  return testResult("fxvm");
+}
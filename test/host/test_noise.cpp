@@ -0,0 +1,170 @@
+//batched noise rows against FastLED inoise16(), and the 1D noise effects against their former per pixel coordinates,
+//and the time per sample of both
+#include "wled.h"
+#include "test.h"
+#include <chrono>
+
+#define LEDS 300
+
+//FastLED noise.cpp (C version), for reference
+static const uint8_t p[257] = {
+  151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23,
+  190,6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,
+  88,237,149,56,87,174,20,125,136,171,168,68,175,74,165,71,134,139,48,27,166,
+  77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,55,46,245,40,244,
+  102,143,54,65,25,63,161,1,216,80,73,209,76,132,187,208,89,18,169,200,196,
+  135,130,116,188,159,86,164,100,109,198,173,186,3,64,52,217,226,250,124,123,
+  5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,
+  223,183,170,213,119,248,152,2,44,154,163,70,221,153,101,155,167,43,172,9,
+  129,22,39,253,19,98,108,110,79,113,224,232,178,185,112,104,218,246,97,228,
+  251,34,242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239,107,
+  49,192,214,31,181,199,106,157,184,84,204,176,115,121,50,45,127,4,150,254,
+  138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180,151
+};
+#define P(x) p[x]
+
+static int16_t refGrad16(uint8_t hash, int16_t x, int16_t y, int16_t z)
+{
+  hash = hash & 15;
+  int16_t u = hash < 8 ? x : y;
+  int16_t v = hash < 4 ? y : hash == 12 || hash == 14 ? x : z;
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg15(u, v);
+}
+
+static int16_t refGrad16(uint8_t hash, int16_t x, int16_t y)
+{
+  hash = hash & 7;
+  int16_t u, v;
+  if (hash < 4) { u = x; v = y; } else { u = y; v = x; }
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg15(u, v);
+}
+
+static uint16_t refInoise16(uint32_t x, uint32_t y, uint32_t z)
+{
+  uint8_t X = (x >> 16) & 0xFF, Y = (y >> 16) & 0xFF, Z = (z >> 16) & 0xFF;
+  uint8_t A = P(X) + Y, AA = P(A) + Z, AB = P(A+1) + Z;
+  uint8_t B = P(X+1) + Y, BA = P(B) + Z, BB = P(B+1) + Z;
+  uint16_t u = x & 0xFFFF, v = y & 0xFFFF, w = z & 0xFFFF;
+  int16_t xx = (u >> 1) & 0x7FFF, yy = (v >> 1) & 0x7FFF, zz = (w >> 1) & 0x7FFF;
+  uint16_t N = 0x8000L;
+  u = ease16InOutQuad(u); v = ease16InOutQuad(v); w = ease16InOutQuad(w);
+  int16_t X1 = lerp15by16(refGrad16(P(AA), xx, yy, zz), refGrad16(P(BA), xx - N, yy, zz), u);
+  int16_t X2 = lerp15by16(refGrad16(P(AB), xx, yy-N, zz), refGrad16(P(BB), xx - N, yy - N, zz), u);
+  int16_t X3 = lerp15by16(refGrad16(P(AA+1), xx, yy, zz-N), refGrad16(P(BA+1), xx - N, yy, zz-N), u);
+  int16_t X4 = lerp15by16(refGrad16(P(AB+1), xx, yy-N, zz-N), refGrad16(P(BB+1), xx - N, yy - N, zz - N), u);
+  int16_t Y1 = lerp15by16(X1, X2, v);
+  int16_t Y2 = lerp15by16(X3, X4, v);
+  int32_t ans = lerp15by16(Y1, Y2, w);
+  uint32_t pan = ans + 19052L;
+  pan *= 440L;
+  return pan >> 8;
+}
+
+static uint16_t refInoise16(uint32_t x, uint32_t y)
+{
+  uint8_t X = x >> 16, Y = y >> 16;
+  uint8_t A = P(X) + Y, AA = P(A), AB = P(A+1);
+  uint8_t B = P(X+1) + Y, BA = P(B), BB = P(B+1);
+  uint16_t u = x & 0xFFFF, v = y & 0xFFFF;
+  int16_t xx = (u >> 1) & 0x7FFF, yy = (v >> 1) & 0x7FFF;
+  uint16_t N = 0x8000L;
+  u = ease16InOutQuad(u); v = ease16InOutQuad(v);
+  int16_t X1 = lerp15by16(refGrad16(P(AA), xx, yy), refGrad16(P(BA), xx - N, yy), u);
+  int16_t X2 = lerp15by16(refGrad16(P(AB), xx, yy-N), refGrad16(P(BB), xx - N, yy - N), u);
+  int32_t ans = lerp15by16(X1, X2, v);
+  uint32_t pan = ans + 17308L;
+  pan *= 484L;
+  return pan >> 8;
+}
+
+static uint32_t xorshift(uint32_t& s) { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+
+#define BENCH_ROWS 20000
+
+//ns per sample of rows of LEDS samples, per sample through the reference or batched, for steps of dx
+static void benchRow(const char* name, uint32_t dx, uint32_t dy, bool twoD)
+{
+  static uint16_t out[LEDS];
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < BENCH_ROWS; r++) {
+    uint32_t y = r * 3000, z = r * 700;
+    if (twoD) for (uint16_t i = 0; i < LEDS; i++) out[i] = refInoise16(i * dx, y);
+    else      for (uint16_t i = 0; i < LEDS; i++) out[i] = refInoise16(i * dx, y + i * dy, z);
+    asm volatile("" : : "r"(out) : "memory");
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < BENCH_ROWS; r++) {
+    uint32_t y = r * 3000, z = r * 700;
+    if (twoD) fillNoise16_2D(out, LEDS, 0, dx, y);
+    else      fillNoise16(out, LEDS, 0, dx, y, dy, z);
+    asm volatile("" : : "r"(out) : "memory");
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  double ref = std::chrono::duration<double, std::nano>(t1 - t0).count() / (BENCH_ROWS * LEDS);
+  double batched = std::chrono::duration<double, std::nano>(t2 - t1).count() / (BENCH_ROWS * LEDS);
+  printf("%-34s %10.2f %10.2f %7.1fx\n", name, ref, batched, ref / batched);
+}
+
+static void benchmark()
+{
+  printf("%-34s %10s %10s %8s\n", "ns per sample", "inoise16", "batched", "speedup");
+  benchRow("3D, x step 1/16 cell (Noise 2)", 1 << 12, 0, false);
+  benchRow("3D, x step 1/2 cell", 1 << 15, 0, false);
+  benchRow("3D, x and y step 1/16 cell", 1 << 12, 1 << 12, false);
+  benchRow("3D, x step 1.5 cells", 3 << 15, 0, false);
+  benchRow("2D, x step 1/16 cell (Noise 4)", 1 << 12, 0, true);
+}
+
+int main()
+{
+  uint16_t n16[LEDS];
+  uint8_t  n8[LEDS];
+  uint32_t seed = 7;
+
+  //rows with random start and steps, including steps of more than a lattice cell and wrapping coordinates
+  for (uint16_t r = 0; r < 2000; r++) {
+    uint32_t x = xorshift(seed), y = xorshift(seed), z = xorshift(seed);
+    uint32_t dx = xorshift(seed) >> (8 + r % 16), dy = (r & 1) ? 0 : xorshift(seed) >> (8 + r % 16);
+    fillNoise16(n16, LEDS, x, dx, y, dy, z);
+    fillNoise8(n8, LEDS, x, dx, y, dy, z);
+    for (uint16_t i = 0; i < LEDS; i++) {
+      uint16_t ref = refInoise16(x + i * dx, y + i * dy, z);
+      CHECK_EQ(n16[i], ref);
+      CHECK_EQ(n8[i], ref >> 8);
+    }
+    fillNoise8(n8, LEDS, x, dx, y, dy, z, true);
+    for (uint16_t i = 0; i < LEDS; i++) CHECK_EQ(n8[i], refInoise16((x + i * dx) & 0xFFFF, (y + i * dy) & 0xFFFF, z) >> 8);
+    fillNoise16_2D(n16, LEDS, x, dx, y);
+    for (uint16_t i = 0; i < LEDS; i++) CHECK_EQ(n16[i], refInoise16(x + i * dx, y));
+  }
+
+  //Noise 1 on a 1D segment: coordinates were uint16_t and wrapped
+  for (uint32_t step = 0; step < 200000; step += 997) {
+    uint16_t scale = 320;
+    uint16_t shift_x = step % 256, shift_y = step / 42;
+    for (uint16_t x0 = 0; x0 < LEDS; x0 += NOISE_CHUNK) {
+      uint16_t n = MIN(NOISE_CHUNK, LEDS - x0);
+      fillNoise8(n8, n, x0 * scale + shift_x * scale, scale, x0 * scale + shift_y * scale, scale, step, true);
+      for (uint16_t i = 0; i < n; i++) {
+        uint16_t real_x = (x0 + i + shift_x) * scale;
+        uint16_t real_y = (x0 + i + shift_y) * scale;
+        CHECK_EQ(n8[i], refInoise16(real_x, real_y, step) >> 8);
+      }
+    }
+  }
+
+  //Noise 4 on a 1D segment: 2D noise along x, time as y
+  for (uint32_t stp = 0; stp < 20000000; stp += 99991) {
+    for (uint16_t x0 = 0; x0 < LEDS; x0 += NOISE_CHUNK) {
+      uint16_t n = MIN(NOISE_CHUNK, LEDS - x0);
+      fillNoise16_2D(n16, n, uint32_t(x0) << 12, 1 << 12, stp);
+      for (uint16_t i = 0; i < n; i++) CHECK_EQ(n16[i], refInoise16(uint32_t(x0 + i) << 12, stp));
+    }
+  }
+  benchmark();
+  return testResult("noise");
+}
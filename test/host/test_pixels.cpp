@@ -0,0 +1,243 @@
+//compressed UDP realtime frames: round trip of rendered effects through every encoding, with the bytes each needs
+//and binary uploads fed in chunks of any size
+#include "wled.h"
+#include "test.h"
+#include <vector>
+#include <set>
+
+#define LEDS      1500
+#define FRAMES    40
+#define FRAME_MS  25
+#define MTU       1472   //UDP_IN_MAXSIZE, largest packet the node reads
+
+WS2812FX strip;
+byte realtimeMode = REALTIME_MODE_INACTIVE;
+
+static uint32_t rx[LEDS]; //what the node shows
+
+void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
+{
+  if (i < LEDS) rx[i] = RGBW32(r, g, b, w);
+}
+
+typedef std::vector<uint8_t> Packet;
+
+//splits a frame into packets of protocol 6, each with the index of its first LED
+struct Encoder {
+  std::vector<Packet> packets;
+  uint8_t  enc;
+  uint16_t pix = 0;
+  Encoder(uint8_t e) : enc(e) {}
+  void element(const Packet& el, uint16_t n) {
+    if (packets.empty() || packets.back().size() + el.size() > MTU) packets.push_back({UDP_RT_COMPRESSED, 2, uint8_t(pix >> 8), uint8_t(pix), enc});
+    packets.back().insert(packets.back().end(), el.begin(), el.end());
+    pix += n;
+  }
+};
+
+static Packet rgb(uint32_t c) { return {R(c), G(c), B(c)}; }
+
+static std::vector<Packet> encodeRGB(const uint32_t* f)
+{
+  Encoder e(PIXEL_FORMAT_RGB);
+  for (uint16_t i = 0; i < LEDS; i++) e.element(rgb(f[i]), 1);
+  return e.packets;
+}
+
+static std::vector<Packet> encodeRLE(const uint32_t* f)
+{
+  Encoder e(PIXEL_FORMAT_RLE);
+  for (uint16_t i = 0; i < LEDS;) {
+    uint16_t n = 1;
+    while (i + n < LEDS && n < 255 && f[i + n] == f[i]) n++;
+    Packet el = rgb(f[i]);
+    el.insert(el.begin(), n);
+    e.element(el, n);
+    i += n;
+  }
+  return e.packets;
+}
+
+static std::vector<Packet> encodeDelta(const uint32_t* f, const uint32_t* prev)
+{
+  Encoder e(UDP_RT_ENC_DELTA);
+  for (uint16_t i = 0; i < LEDS;) {
+    uint16_t n = 0;
+    bool same = f[i] == prev[i];
+    while (i + n < LEDS && n < 128 && (f[i + n] == prev[i + n]) == same) n++;
+    if (same) {
+      if (i + n < LEDS) e.element({uint8_t(0x80 | (n -1))}, n); //unchanged LEDs at the end need no bytes
+      else break;
+    } else {
+      Packet el = {uint8_t(n -1)};
+      for (uint16_t k = 0; k < n; k++) { Packet c = rgb(f[i + k]); el.insert(el.end(), c.begin(), c.end()); }
+      e.element(el, n);
+    }
+    i += n;
+  }
+  return e.packets;
+}
+
+//the first packet carries the palette, unless the node has it already, the others only indices
+static std::vector<Packet> encodePalette(const uint32_t* f, std::vector<uint32_t>& pal)
+{
+  std::vector<uint32_t> colors;
+  for (uint16_t i = 0; i < LEDS; i++) {
+    if (std::find(colors.begin(), colors.end(), f[i]) != colors.end()) continue;
+    colors.push_back(f[i]);
+    if (colors.size() > 256) return {};
+  }
+  std::set<uint32_t> a(colors.begin(), colors.end()), b(pal.begin(), pal.end());
+  Encoder e(UDP_RT_ENC_INDEXED);
+  if (a != b) {
+    pal = colors;
+    e.enc = PIXEL_FORMAT_PALETTE;
+    Packet el = {uint8_t(pal.size())};
+    for (uint32_t c : pal) { Packet p = rgb(c); el.insert(el.end(), p.begin(), p.end()); }
+    e.element(el, 0);
+    e.enc = UDP_RT_ENC_INDEXED;
+  }
+  for (uint16_t i = 0; i < LEDS; i++) e.element({uint8_t(std::find(pal.begin(), pal.end(), f[i]) - pal.begin())}, 1);
+  return e.packets;
+}
+
+static size_t receive(const std::vector<Packet>& packets)
+{
+  size_t bytes = 0;
+  for (const Packet& p : packets) {
+    CHECK(p.size() <= MTU);
+    decodeRealtimePixels(p[4], p.data() + 5, p.size() - 5, (p[2] << 8) | p[3], LEDS);
+    bytes += p.size();
+  }
+  return bytes;
+}
+
+static void roundTrip()
+{
+  static const uint8_t modes[] = {FX_MODE_STATIC, FX_MODE_LARSON_SCANNER, FX_MODE_METEOR, FX_MODE_PALETTE, FX_MODE_COLORWAVES,
+                                  FX_MODE_RAINBOW_CYCLE, FX_MODE_FIRE_2012, FX_MODE_TWINKLEFOX};
+  static const char* names[] = {"Solid", "Scanner", "Meteor", "Palette", "Colorwaves", "Rainbow", "Fire 2012", "Twinklefox"};
+  static uint32_t frame[LEDS], prev[LEDS];
+  const char* encNames[] = {"RGB", "RLE", "delta", "palette"};
+
+  printf("average bytes per %u LED frame (packets of up to %u bytes, with headers), round trip checked\n", LEDS, MTU);
+  printf("%-12s %8s %8s %8s %8s\n", "effect", encNames[0], encNames[1], encNames[2], encNames[3]);
+  for (uint8_t m = 0; m < sizeof(modes); m++) {
+    strip.setMode(0, modes[m]);
+    size_t bytes[4] = {0};
+    bool palOk = true;
+    std::vector<uint32_t> pal;
+    memset(prev, 0, sizeof(prev));
+    for (uint16_t n = 0; n < FRAMES; n++) {
+      hostSetMillis(100000 + m * 10000 + n * FRAME_MS);
+      strip.service();
+      for (uint16_t i = 0; i < LEDS; i++) frame[i] = busses.getPixelColor(i) & 0xFFFFFF;
+
+      for (uint8_t e = 0; e < 4; e++) {
+        std::vector<Packet> packets;
+        switch (e) {
+          case 0: packets = encodeRGB(frame); break;
+          case 1: packets = encodeRLE(frame); break;
+          case 2: packets = encodeDelta(frame, prev); break;
+          case 3: packets = encodePalette(frame, pal); if (packets.empty()) { palOk = false; pal.clear(); continue; } break;
+        }
+        memcpy(rx, prev, sizeof(rx)); //the node shows the previous frame
+        bytes[e] += receive(packets);
+        CHECK(!memcmp(rx, frame, sizeof(rx)));
+      }
+      memcpy(prev, frame, sizeof(prev));
+    }
+    printf("%-12s", names[m]);
+    for (uint8_t e = 0; e < 4; e++) {
+      if (e == 3 && !palOk) printf(" %8s", "-");
+      else                  printf(" %8zu", bytes[e] / FRAMES);
+    }
+    printf("\n");
+  }
+}
+
+static void decoderEdges()
+{
+  //indices before any palette arrived are ignored
+  memset(rx, 0, sizeof(rx));
+  const uint8_t idx[] = {0, 1, 2};
+  decodeRealtimePixels(UDP_RT_ENC_INDEXED, idx, sizeof(idx), 0, LEDS);
+  CHECK_EQ(rx[0], 0);
+
+  //indices outside of the palette are black, the palette stays for indexed packets
+  const uint8_t palPkt[] = {2, 10, 20, 30, 40, 50, 60, 1, 5, 0};
+  decodeRealtimePixels(PIXEL_FORMAT_PALETTE, palPkt, sizeof(palPkt), 10, LEDS);
+  CHECK_EQ(rx[10], RGBW32(40, 50, 60, 0));
+  CHECK_EQ(rx[11], 0);
+  CHECK_EQ(rx[12], RGBW32(10, 20, 30, 0));
+  decodeRealtimePixels(UDP_RT_ENC_INDEXED, idx, sizeof(idx), LEDS - 2, LEDS);
+  CHECK_EQ(rx[LEDS - 2], RGBW32(10, 20, 30, 0));
+  CHECK_EQ(rx[LEDS - 1], RGBW32(40, 50, 60, 0));
+
+  //a truncated palette is rejected, RLE runs stop at the end of the strip, RGBW keeps white
+  memset(rx, 0, sizeof(rx));
+  decodeRealtimePixels(PIXEL_FORMAT_PALETTE, palPkt, 5, 0, LEDS);
+  CHECK_EQ(rx[0], 0);
+  const uint8_t run[] = {200, 1, 2, 3};
+  decodeRealtimePixels(PIXEL_FORMAT_RLE, run, sizeof(run), LEDS - 5, LEDS);
+  CHECK_EQ(rx[LEDS - 1], RGBW32(1, 2, 3, 0));
+  const uint8_t rgbw[] = {1, 2, 3, 4, 5, 6, 7};
+  decodeRealtimePixels(PIXEL_FORMAT_RGBW, rgbw, sizeof(rgbw), 0, LEDS);
+  CHECK_EQ(rx[0], RGBW32(1, 2, 3, 4));
+  CHECK_EQ(rx[1], 0);
+
+  //a truncated delta literal sets the complete pixels only, unknown encodings do nothing
+  const uint8_t delta[] = {0x81, 2, 9, 9, 9, 8, 8, 8, 7, 7};
+  decodeRealtimePixels(UDP_RT_ENC_DELTA, delta, sizeof(delta), 0, LEDS);
+  CHECK_EQ(rx[0], RGBW32(1, 2, 3, 4));
+  CHECK_EQ(rx[2], RGBW32(9, 9, 9, 0));
+  CHECK_EQ(rx[3], RGBW32(8, 8, 8, 0));
+  CHECK_EQ(rx[4], 0);
+  decodeRealtimePixels(UDP_RT_ENC_INDEXED +1, rgbw, sizeof(rgbw), 0, LEDS);
+  CHECK_EQ(rx[0], RGBW32(1, 2, 3, 4));
+}
+
+//an upload in the same formats, split into chunks that cut through pixels and the palette
+static void upload()
+{
+  strip.setMode(0, FX_MODE_STATIC);
+  strip.gammaCorrectCol = false;
+  std::vector<uint8_t> data = {0, 0, 5, PIXEL_FORMAT_PALETTE, 3, 255, 0, 0, 0, 255, 0, 0, 0, 255};
+  for (uint16_t i = 0; i < 100; i++) data.push_back(i % 4); //3 is outside of the palette
+  for (uint8_t chunk = 1; chunk < 20; chunk++) {
+    strip.getSegment(0).setOption(SEG_OPTION_FREEZE, false);
+    PixelUpload* up = new PixelUpload;
+    pixelUploadBegin(up);
+    for (size_t o = 0; o < data.size(); o += chunk) pixelUploadFeed(up, data.data() + o, std::min<size_t>(chunk, data.size() - o));
+    CHECK(pixelUploadEnd(up));
+    delete up;
+    CHECK_EQ(strip.getPixelColor(4), 0);
+    CHECK_EQ(strip.getPixelColor(5), RGBW32(255, 0, 0, 0));
+    CHECK_EQ(strip.getPixelColor(6), RGBW32(0, 255, 0, 0));
+    CHECK_EQ(strip.getPixelColor(7), RGBW32(0, 0, 255, 0));
+    CHECK_EQ(strip.getPixelColor(8), 0);
+    CHECK_EQ(strip.getPixelColor(103), RGBW32(0, 0, 255, 0));
+    CHECK_EQ(strip.getPixelColor(104), 0);
+  }
+  const uint8_t rle[] = {0, 0, 0, PIXEL_FORMAT_RLE, 3, 1, 2, 3, 0, 9, 9, 9, 2, 4, 5, 6};
+  strip.getSegment(0).setOption(SEG_OPTION_FREEZE, false);
+  PixelUpload* up = new PixelUpload;
+  pixelUploadBegin(up);
+  for (uint8_t o = 0; o < sizeof(rle); o += 3) pixelUploadFeed(up, rle + o, std::min<size_t>(3, sizeof(rle) - o));
+  CHECK(pixelUploadEnd(up));
+  delete up;
+  CHECK_EQ(strip.getPixelColor(2), RGBW32(1, 2, 3, 0));
+  CHECK_EQ(strip.getPixelColor(3), RGBW32(4, 5, 6, 0));
+  CHECK_EQ(strip.getPixelColor(5), 0);
+}
+
+int main()
+{
+  hostSetupBus(LEDS);
+  strip.finalizeInit();
+  strip.setSegment(0, 0, LEDS);
+  decoderEdges();
+  roundTrip();
+  upload();
+  return testResult("pixels");
+}
@@ -0,0 +1,99 @@
+//two nodes with the same sync seed must render identical frames after a sync, for every effect
+//each node runs in its own process, like on separate controllers
+#include "wled.h"
+#include "test.h"
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define LEDS       300
+#define SEGS       3
+#define FRAMES     60
+#define FRAME_MS   25
+#define SYNC_TIME  100000
+
+#define EFFECT_NAME(id, fn, name, pal, flags) name,
+static const char* effectNames[] = { WLED_EFFECT_LIST(EFFECT_NAME, EFFECT_NAME) };
+
+static uint32_t frameHash()
+{
+  uint32_t h = 2166136261u; //FNV-1a
+  for (uint16_t i = 0; i < LEDS; i++) {
+    uint32_t c = busses.getPixelColor(i);
+    for (uint8_t b = 0; b < 4; b++) { h ^= (c >> (b * 8)) & 0xFF; h *= 16777619u; }
+  }
+  return h;
+}
+
+/*
+ * Renders every effect on a node with the given seed. The node first shows the effect for framesBefore
+ * frames (its own history), then a sync arrives and the frame hashes from then on are recorded.
+ * junk seeds the global generators, which must not influence the result.
+ */
+static std::vector<uint32_t> renderNode(uint32_t seed, uint16_t framesBefore, uint16_t junk)
+{
+  int fd[2];
+  if (pipe(fd)) return {};
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fd[0]);
+    hostSetupBus(LEDS);
+    WS2812FX* fx = new WS2812FX();
+    fx->finalizeInit();
+    fx->rngSeed = seed;
+    for (uint8_t s = 0; s < SEGS; s++) fx->setSegment(s, s * LEDS / SEGS, (s + 1) * LEDS / SEGS);
+    random16_set_seed(junk); randomSeed(junk);
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+      uint32_t t = SYNC_TIME + m * 10000;
+      for (uint8_t s = 0; s < SEGS; s++) fx->setMode(s, m);
+      for (uint16_t f = 0; f < framesBefore; f++) {
+        hostSetMillis(t - (framesBefore - f) * FRAME_MS);
+        fx->service();
+      }
+      fx->setRange(0, LEDS -1, 0); //same pixels on all nodes, effects that fade or shift read them back
+      fx->reseed(t);
+      for (uint16_t f = 0; f < FRAMES; f++) {
+        random16(); random(7);
+        hostSetMillis(t + f * FRAME_MS);
+        fx->service();
+        uint32_t h = frameHash();
+        if (write(fd[1], &h, sizeof(h)) != sizeof(h)) _exit(1);
+      }
+    }
+    _exit(0);
+  }
+  close(fd[1]);
+  std::vector<uint32_t> hashes;
+  uint32_t h;
+  while (read(fd[0], &h, sizeof(h)) == sizeof(h)) hashes.push_back(h);
+  close(fd[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return hashes;
+}
+
+int main()
+{
+  //a has been showing each effect for a while, b just switched to it, c has another seed
+  std::vector<uint32_t> ha = renderNode(1234, 40, 11);
+  std::vector<uint32_t> hb = renderNode(1234, 0, 22);
+  std::vector<uint32_t> hc = renderNode(4321, 0, 33);
+  CHECK_EQ(ha.size(), MODE_COUNT * FRAMES);
+  CHECK_EQ(hb.size(), MODE_COUNT * FRAMES);
+  CHECK_EQ(hc.size(), MODE_COUNT * FRAMES);
+  if (testFailures) return testResult("render");
+
+  uint8_t seeded = 0;
+  for (uint8_t m = 0; m < MODE_COUNT; m++) {
+    uint32_t o = m * FRAMES;
+    uint16_t first = 0;
+    while (first < FRAMES && ha[o + first] == hb[o + first]) first++;
+    if (first < FRAMES) printf("%s: frame %u differs between nodes with the same seed\n", effectNames[m], first);
+    CHECK_EQ(first, FRAMES);
+    for (uint16_t f = 0; f < FRAMES; f++) if (ha[o + f] != hc[o + f]) { seeded++; break; }
+  }
+  //random effects must actually use the seed
+  printf("%u effects render differently with another seed\n", seeded);
+  CHECK(seeded > 20);
+  return testResult("render");
+}
@@ -0,0 +1,108 @@
+//segment storage: grows to the highest ID in use and shrinks after deletion, only while no JSON request is applied
+//built with MAX_NUM_SEGMENTS=100 and AddressSanitizer, which reports any access past the allocated segments
+#include "wled.h"
+#include "test.h"
+
+extern "C" size_t __sanitizer_get_current_allocated_bytes(); //libasan
+
+#define LEN  300
+
+static WS2812FX* fx;
+
+static size_t heap() { return __sanitizer_get_current_allocated_bytes(); }
+
+static void frames(uint8_t n)
+{
+  static uint32_t t = 1000;
+  for (uint8_t f = 0; f < n; f++) {
+    hostSetMillis(t += 25);
+    fx->service();
+  }
+}
+
+int main()
+{
+  hostSetupBus(LEN);
+  fx = new WS2812FX();
+  fx->finalizeInit();
+  CHECK_EQ(fx->getSegmentsNum(), 1);
+  CHECK_EQ(fx->getMaxSegments(), 100);
+  frames(2);
+  size_t base = heap();
+  const size_t perId = sizeof(WS2812FX::Segment) + sizeof(WS2812FX::Segment_runtime);
+
+  //the IDs up to the highest one in use get storage, the ones below hold the defaults
+  fx->setSegment(90, 0, 10);
+  CHECK_EQ(fx->getSegmentsNum(), 91);
+  CHECK(heap() >= base + 90 * perId);
+  CHECK_EQ(fx->getSegment(90).start, 0);
+  CHECK_EQ(fx->getSegment(90).stop, 10);
+  CHECK(!fx->getSegment(50).isActive());
+  CHECK_EQ(fx->getSegment(50).grouping, 1);
+  CHECK_EQ(fx->getSegment(50).opacity, 255);
+  CHECK(!fx->getSegment(99).isActive()); //no storage, the placeholder
+  fx->setSegment(0, 10, LEN);
+  fx->setSegment(80, 20, 30);
+  fx->setMode(90, FX_MODE_FIRE_2012);
+  fx->setMode(80, FX_MODE_DANCING_SHADOWS);
+  frames(5);
+  CHECK(fx->getSegmentDataUsed() > 0);
+
+  //color transitions of IDs above 63 are kept apart from the ones of the low IDs
+  fx->setTransition(1000);
+  fx->getSegment(90).setColor(0, 0xFF0000, 90);
+  fx->getSegment(26).setColor(0, 0x00FF00, 26); //90 and 26 share the lower 6 bits
+  CHECK(fx->getSegment(90).getOption(SEG_OPTION_TRANSITIONAL));
+  fx->getSegment(0).setColor(1, 0x0000FF, 0);
+  CHECK(fx->getSegment(90).getOption(SEG_OPTION_TRANSITIONAL));
+  frames(60);
+  CHECK(!fx->getSegment(90).getOption(SEG_OPTION_TRANSITIONAL));
+
+  //no growth while a JSON request is applied, a network callback may hold a segment, IDs with storage can be used
+  jsonBufferLock = 14;
+  WS2812FX::Segment* segs = fx->getSegments();
+  fx->setSegment(95, 0, 5);
+  CHECK_EQ(fx->getSegmentsNum(), 91);
+  CHECK(!fx->useSegment(95));
+  CHECK(fx->useSegment(60));
+  CHECK(fx->getSegments() == segs);
+  jsonBufferLock = 0;
+  fx->setSegment(95, 0, 5);
+  CHECK_EQ(fx->getSegmentsNum(), 96);
+  CHECK(fx->getSegment(95).isActive());
+
+  //deleting the last segments lowers the count at once, the storage is freed by the loop, not under the lock
+  fx->setSegment(95, 0, 0);
+  fx->setSegment(90, 0, 0);
+  CHECK_EQ(fx->getSegmentsNum(), 81);
+  fx->setSegment(80, 0, 0);
+  CHECK_EQ(fx->getSegmentsNum(), 1);
+  jsonBufferLock = 14;
+  frames(2); //effect data is freed
+  CHECK_EQ(fx->getSegmentDataUsed(), 0);
+  size_t grown = heap();
+  CHECK(fx->useSegment(95));
+  CHECK_EQ(fx->getSegmentsNum(), 96);
+  fx->setSegment(95, 0, 0);
+  frames(2);
+  CHECK_EQ(heap(), grown);
+  jsonBufferLock = 0;
+  frames(2);
+  CHECK(heap() + 95 * perId <= grown);
+  CHECK(heap() <= base + perId);
+  CHECK(!fx->useSegment(1));
+  CHECK_EQ(jsonBufferLock, 0);
+
+  //created again, an ID starts from the defaults
+  fx->setSegment(90, 0, 10);
+  CHECK_EQ(fx->getSegment(90).mode, FX_MODE_STATIC);
+  CHECK(!fx->getSegment(90).getOption(SEG_OPTION_TRANSITIONAL));
+  frames(2);
+  fx->resetSegments();
+  CHECK_EQ(fx->getSegmentsNum(), 1);
+  frames(2);
+  CHECK(heap() <= base + perId);
+
+  printf("%zu bytes per segment ID, %zu bytes above the start, arena %u\n", perId, heap() - base, fx->getSegmentDataSize());
+  return testResult("segments");
+}
@@ -0,0 +1,154 @@
+//Adalight over a pty: framed baud rate command, and frames per second with the default and the enlarged receive buffer
+#include "wled.h"
+#include "test.h"
+#include <vector>
+#include <pty.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define LEDS      300
+#define FRAMES    200
+#define BAUD      921600
+#define LOOP_MS   8      //rest of a loop pass (effects, network) between handleSerial() calls
+
+WS2812FX strip;
+HostPinManager pinManager;
+byte bri = 128;
+byte briLast = 128;
+byte realtimeMode = REALTIME_MODE_INACTIVE;
+byte realtimeOverride = REALTIME_OVERRIDE_NONE;
+uint16_t realtimeTimeoutMs = 2500;
+
+static uint16_t frameId = 0, framePixels = 0;
+static bool     frameOk = false;
+static uint32_t framesOk = 0, framesShown = 0;
+
+//pixel i of frame n is (n & 0xFF, n >> 8, i & 0xFF)
+void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
+{
+  if (i == 0) { frameId = r | (g << 8); frameOk = true; framePixels = 0; }
+  else if ((r | (g << 8)) != frameId) frameOk = false;
+  if (i != framePixels || b != (i & 0xFF)) frameOk = false;
+  framePixels++;
+}
+
+void realtimeLock(uint32_t timeoutMs, byte md)
+{
+  realtimeMode = md;
+  framesShown++;
+  if (frameOk && framePixels == LEDS) framesOk++;
+  frameOk = false;
+}
+
+void handleImprovPacket() { Serial.read(); }
+bool deserializeState(JsonObject root, byte callMode, byte presetId) { return false; }
+void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds) {}
+void serializeInfo(JsonObject root) {}
+
+static int master = -1;
+
+static void sendAndHandle(std::vector<uint8_t> bytes)
+{
+  if (write(master, bytes.data(), bytes.size()) != (ssize_t)bytes.size()) return;
+  for (uint8_t i = 0; i < 20; i++) { usleep(1000); handleSerial(); }
+}
+
+static std::vector<uint8_t> adalightFrame(uint16_t n)
+{
+  std::vector<uint8_t> f = {'A', 'd', 'a', (LEDS - 1) >> 8, (LEDS - 1) & 0xFF};
+  f.push_back(f[3] ^ f[4] ^ 0x55);
+  for (uint16_t i = 0; i < LEDS; i++) { f.push_back(n & 0xFF); f.push_back(n >> 8); f.push_back(i & 0xFF); }
+  return f;
+}
+
+//a sender at BAUD writes FRAMES frames, the node reads them between loop passes
+static void runStream(const char* name)
+{
+  framesOk = 0; framesShown = 0; Serial.dropped = 0;
+  pid_t pid = fork();
+  if (pid == 0) {
+    uint32_t bytesPerSec = BAUD / 10, sent = 0;
+    uint64_t start = micros();
+    for (uint16_t n = 0; n < FRAMES; n++) {
+      std::vector<uint8_t> f = adalightFrame(n);
+      for (size_t o = 0; o < f.size(); o += 64) {
+        size_t len = std::min<size_t>(64, f.size() - o);
+        uint64_t due = start + (uint64_t)sent * 1000000 / bytesPerSec;
+        while (micros() < due) usleep(100);
+        if (write(master, f.data() + o, len) != (ssize_t)len) _exit(1);
+        sent += len;
+      }
+    }
+    _exit(0);
+  }
+  uint32_t start = millis();
+  int status = 0;
+  uint8_t idle = 0;
+  while (idle < 10) { //until the sender is done and the last bytes are read
+    handleSerial();
+    usleep(LOOP_MS * 1000);
+    if (waitpid(pid, &status, WNOHANG) == pid || idle) idle++;
+  }
+  float secs = (millis() - start) / 1000.0f;
+  printf("%s: %u of %u frames intact (%u shown), %.0f fps, %u bytes dropped, %u byte receive buffer\n",
+         name, framesOk, FRAMES, framesShown, framesOk / secs, Serial.dropped, (unsigned)Serial.rxBufferSize());
+}
+
+int main()
+{
+  hostSetupBus(LEDS);
+  strip.finalizeInit();
+
+  int slave = -1;
+  struct termios tio;
+  if (openpty(&master, &slave, nullptr, nullptr, nullptr)) { printf("no pty\n"); return 1; }
+  tcgetattr(slave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+  fcntl(slave, F_SETFL, fcntl(slave, F_GETFL) | O_NONBLOCK);
+  Serial.fd = slave;
+  Serial.begin(115200);
+
+  //stray bytes and broken commands do not change the rate
+  sendAndHandle({0xB5});
+  CHECK_EQ(Serial.baud(), 115200);
+  sendAndHandle({0xBA, 0xD0, 0xB5, 0x00});
+  CHECK_EQ(Serial.baud(), 115200);
+  sendAndHandle({0xBA, 0xB5, 0xB5 ^ 0x55});
+  CHECK_EQ(Serial.baud(), 115200);
+  sendAndHandle({0xBA, 0xD0, 0xB5, 0xB5 ^ 0x55});
+  CHECK_EQ(Serial.baud(), 921600);
+  CHECK(Serial.rxBufferSize() > 256);
+  sendAndHandle({0xBA, 0xD0, 0xB0, 0xB0 ^ 0x55});
+  CHECK_EQ(Serial.baud(), 115200);
+
+  //one call reads at most a receive buffer, frames queued behind it wait for the next loop pass
+  Serial.setRxBufferSize(LEDS * 3 * 32);
+  framesShown = 0;
+  for (uint16_t n = 0; n < 20; n++) {
+    std::vector<uint8_t> f = adalightFrame(n);
+    if (write(master, f.data(), f.size()) != (ssize_t)f.size()) break;
+    Serial.available(); //into the receive buffer
+  }
+  uint32_t yields = hostYields;
+  handleSerial();
+  CHECK(framesShown > 0 && framesShown < 20);
+  CHECK(hostYields > yields);
+  for (uint8_t i = 0; i < 20 && framesShown < 20; i++) handleSerial();
+  CHECK_EQ(framesShown, 20);
+  CHECK_EQ(Serial.dropped, 0);
+
+  //a frame in the default 256 byte buffer is overwritten while the loop is busy
+  Serial.setRxBufferSize(256);
+  runStream("default buffer");
+  CHECK(framesOk < FRAMES);
+
+  updateSerialBaud(BAUD);
+  sendAndHandle(std::vector<uint8_t>(LEDS * 3 + 6, 0)); //completes the frame the first run ended in
+  runStream("enlarged buffer");
+  CHECK_EQ(framesOk, FRAMES);
+  CHECK_EQ(Serial.dropped, 0);
+  return testResult("serial");
+}
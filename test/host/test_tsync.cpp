@@ -0,0 +1,173 @@
+//Timebase sync: a follower against a simulated leader over a link with latency, jitter and queueing outliers
+//checks that the offset converges, outliers do not pull it, small leader steps are slewed and large ones jump
+#include "wled.h"
+#include "test.h"
+#include "esp_timer.h"
+
+#define LINK_US       1500 //one way latency
+#define JITTER_US     2000 //plus up to this, independently per direction
+#define OUTLIER_PCT     25 //packets queued somewhere for another
+#define OUTLIER_US   60000 //up to this, only on the way to the leader so the offset of such an exchange is wrong
+#define LEADER_US      200 //between receiving the request and sending the response
+#define DRIFT_PPM       20 //leader clock runs faster
+
+WS2812FX strip;
+byte bri = 128;
+byte briLast = 128;
+byte realtimeMode = REALTIME_MODE_INACTIVE;
+byte realtimeOverride = REALTIME_OVERRIDE_NONE;
+uint16_t realtimeTimeoutMs = 2500;
+byte timeSyncMode = TSYNC_MODE_FOLLOWER;
+NodesMap Nodes;
+WiFiUDP notifierUdp;
+uint16_t udpPort = 21324;
+bool udpConnected = true;
+
+static const IPAddress leaderIp(192, 168, 1, 10);
+
+static uint64_t now = 1000000;    //follower clock
+static int64_t  leaderOffset;     //leader clock - follower clock at startTime
+static uint64_t startTime = now;
+static uint32_t rng = 12345;
+
+static uint8_t  response[40];
+static uint64_t responseDue = 0;  //0: nothing in flight
+static double   naiveSum = 0;     //mean offset of all exchanges, what the follower would get without the delay filter
+static uint32_t exchanges = 0, outliers = 0;
+
+static uint32_t rnd(uint32_t n) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng % n; }
+
+static uint32_t latency(bool outlier)
+{
+  return LINK_US + rnd(JITTER_US) + (outlier ? rnd(OUTLIER_US) : 0);
+}
+
+static int64_t trueOffset(uint64_t t) { return leaderOffset + (int64_t)(t - startTime) * DRIFT_PPM / 1000000; }
+
+static void writeU64(uint8_t* p, uint64_t v) { for (uint8_t i = 0; i < 8; i++) p[i] = v >> (56 - 8*i); }
+static uint64_t readU64(const uint8_t* p) { uint64_t v = 0; for (uint8_t i = 0; i < 8; i++) v = v << 8 | p[i]; return v; }
+
+//the leader's answer to the request the follower just sent, delivered later by run()
+static void answer()
+{
+  const uint8_t* req = notifierUdp.tx;
+  CHECK_EQ(notifierUdp.txLen, 40);
+  CHECK_EQ(req[0], TSYNC_PACKET_ID);
+  CHECK_EQ(req[1], 0);
+  CHECK(notifierUdp.txIp == IPAddress(192, 168, 1, 255));
+  CHECK_EQ(notifierUdp.txPort, udpPort);
+  CHECK_EQ(readU64(req +4), now);
+
+  bool outlier = rnd(100) < OUTLIER_PCT;
+  if (outlier) outliers++;
+  uint64_t arrival = now + latency(outlier);
+  uint64_t t2 = arrival + trueOffset(arrival);
+  uint64_t t3 = t2 + LEADER_US;
+  memset(response, 0, sizeof(response));
+  response[0] = TSYNC_PACKET_ID;
+  response[1] = 1;
+  response[2] = req[2];
+  memcpy(response +4, req +4, 8);
+  writeU64(response +12, t2);
+  writeU64(response +20, t3);
+  responseDue = arrival + LEADER_US + latency(false);
+
+  naiveSum += ((double)(t2 - now) + ((double)t3 - (double)responseDue)) / 2;
+  exchanges++;
+}
+
+//runs the follower loop every ms for the given time, with the responses delivered when they arrive
+//calls check() after each iteration with the timebase change since the last one
+template <typename F> static void run(uint32_t ms, F check)
+{
+  uint64_t end = now + ms * 1000ULL;
+  while (now < end) {
+    uint64_t next = now + 1000;
+    uint32_t tb = strip.timebase;
+    if (responseDue && responseDue < next) {
+      now = responseDue;
+      hostSetMicros(now);
+      responseDue = 0;
+      handleTimeSyncPacket(response, sizeof(response), leaderIp);
+    }
+    now = next;
+    hostSetMicros(now);
+    uint32_t sent = notifierUdp.txPackets;
+    handleTimeSync();
+    check((int32_t)(strip.timebase - tb));
+    if (notifierUdp.txPackets != sent) answer();
+  }
+}
+
+static int32_t timebaseError() { return (int32_t)strip.timebase - (int32_t)(trueOffset(now) / 1000); }
+
+static void status(bool* lock, int32_t* ofs, uint32_t* jit, uint32_t* rtt)
+{
+  DynamicJsonDocument d(256);
+  serializeTimeSync(d.to<JsonObject>());
+  *lock = d["tsync"]["lock"];
+  *ofs = d["tsync"]["ofs"];
+  *jit = d["tsync"]["jit"];
+  *rtt = d["tsync"]["rtt"];
+}
+
+static void report(const char* phase)
+{
+  bool lock; int32_t ofs; uint32_t jit, rtt;
+  status(&lock, &ofs, &jit, &rtt);
+  printf("%-8s timebase error %3d ms, residual %5d us, jitter %5u us, rtt %5u us, lock %d\n",
+         phase, timebaseError(), ofs, jit, rtt, lock);
+  CHECK(lock);
+  CHECK(abs(timebaseError()) <= 2);  //estimate within the link asymmetry, plus the ms resolution of the timebase
+  CHECK(abs(ofs) < 1000);            //slewed to the estimate
+  CHECK(jit < JITTER_US);            //the outliers are not counted
+  CHECK(rtt < 2 * (LINK_US + JITTER_US));
+}
+
+int main()
+{
+  hostSetMicros(now);
+  NodeStruct leader;
+  leader.ip = leaderIp;
+  Nodes[10] = leader;
+  leaderOffset = 3712345; //more than TSYNC_STEP_US, the first exchange locks at once
+
+  //acquisition, with the window filling at the fast request interval
+  run(2500, [](int32_t) {});
+  CHECK(exchanges >= 8);
+  run(30000, [](int32_t) {});
+  report("acquire");
+  double naiveError = naiveSum / exchanges - trueOffset(now);
+  printf("%u exchanges, %u outliers, mean offset of all exchanges off by %.0f us\n", exchanges, outliers, naiveError);
+  CHECK(outliers > 0);
+  CHECK(fabs(naiveError) > 2000); //the filter is what makes the result usable
+
+  //the leader's timebase moves by 40ms: slewed at 1%, so the timebase changes by at most 1ms per iteration and never backwards
+  leaderOffset += 40000;
+  int32_t maxChange = 0, minChange = 0;
+  uint32_t changes = 0;
+  auto slew = [&](int32_t d) { maxChange = max(maxChange, d); minChange = min(minChange, d); if (d) changes++; };
+  run(30000, slew);
+  report("slew");
+  CHECK_EQ(maxChange, 1);
+  CHECK_EQ(minChange, 0);
+  CHECK(changes >= 38); //the 40ms in steps, drift adds a few
+
+  //a change above TSYNC_STEP_US is applied at once
+  leaderOffset -= 500000;
+  maxChange = 0; minChange = 0; changes = 0;
+  run(30000, slew);
+  report("step");
+  CHECK(minChange <= -400);
+
+  //leaving follower mode drops the lock
+  timeSyncMode = TSYNC_MODE_OFF;
+  run(10, [](int32_t) {});
+  timeSyncMode = TSYNC_MODE_FOLLOWER;
+  bool lock; int32_t ofs; uint32_t jit, rtt;
+  status(&lock, &ofs, &jit, &rtt);
+  CHECK(!lock);
+
+  CHECK(Nodes[10].syncValid);
+  return testResult("tsync");
+}
@@ -0,0 +1,118 @@
+//reduced-resolution rendering: error against full resolution per effect, effect time, and no read back from the bus
+#include "wled.h"
+#include "test.h"
+#include <chrono>
+
+#define LEDS      600
+#define FRAMES    100
+#define FRAME_MS  25
+
+#define EFFECT_NAME(id, fn, name, pal, flags) name,
+static const char* effectNames[] = { WLED_EFFECT_LIST(EFFECT_NAME, EFFECT_NAME) };
+
+static WS2812FX* fx;
+static uint32_t frames[FRAMES][LEDS];
+
+struct Run { double err, maxErr, usPerFrame; };
+
+//renders FRAMES frames of effect m from its start, compares them with frames[] unless ref (then stores them)
+static Run render(uint8_t m, uint8_t scale, bool cubic, bool ref)
+{
+  WS2812FX::Segment& seg = fx->getSegment(0);
+  seg.scale = scale;
+  seg.setOption(SEG_OPTION_CUBIC, cubic);
+  fx->setMode(0, m);
+  fx->reseed(0);
+  fx->setRange(0, LEDS -1, 0);
+  Run r = {0, 0, 0};
+  uint64_t sum = 0;
+  double ns = 0;
+  for (uint16_t f = 0; f < FRAMES; f++) {
+    hostSetMillis(100000 + f * FRAME_MS);
+    auto start = std::chrono::steady_clock::now();
+    fx->service();
+    ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    for (uint16_t i = 0; i < LEDS; i++) {
+      uint32_t c = busses.getPixelColor(i);
+      if (ref) { frames[f][i] = c; continue; }
+      for (uint8_t s = 0; s < 24; s += 8) {
+        int d = abs((int)((c >> s) & 0xFF) - (int)((frames[f][i] >> s) & 0xFF));
+        sum += d;
+        if (d > r.maxErr) r.maxErr = d;
+      }
+    }
+  }
+  r.err = (double)sum / (FRAMES * LEDS * 3);
+  r.usPerFrame = ns / FRAMES / 1000;
+  return r;
+}
+
+static uint32_t opacity(uint32_t c, uint8_t bri)
+{
+  return RGBW32(scale8(R(c), bri), scale8(G(c), bri), scale8(B(c), bri), scale8(W(c), bri));
+}
+
+//the scaled effect draws into the segment's pixel row, only the output stage writes the bus, once per pixel
+static void pipeline()
+{
+  WS2812FX::Segment& seg = fx->getSegment(0);
+  seg.opacity = 100;
+  seg.scale = 4;
+  seg.setOption(SEG_OPTION_CUBIC, false);
+  fx->setMode(0, FX_MODE_PACIFICA);
+  fx->reseed(0);
+  uint32_t reads = busses.reads;
+  for (uint16_t f = 0; f < 10; f++) { hostSetMillis(200000 + f * FRAME_MS); fx->service(); }
+  CHECK_EQ(busses.reads, reads);
+
+  //calculated pixels are output with the opacity applied once, interpolated ones lie between their neighbours
+  WS2812FX::Segment_runtime r = fx->getSegmentRuntime();
+  CHECK(r.pixels != nullptr);
+  uint16_t n = (LEDS - 1) / 4 + 1;
+  for (uint16_t i = 0; i < n; i++) CHECK_EQ(busses.getPixelColor(i * 4), opacity(r.pixels[i], 100));
+  for (uint16_t i = 0; i + 1 < n; i++) {
+    uint32_t a = busses.getPixelColor(i * 4), b = busses.getPixelColor(i * 4 + 4), c = busses.getPixelColor(i * 4 + 2);
+    for (uint8_t s = 0; s < 24; s += 8) {
+      uint8_t lo = MIN((a >> s) & 0xFF, (b >> s) & 0xFF), hi = MAX((a >> s) & 0xFF, (b >> s) & 0xFF), v = (c >> s) & 0xFF;
+      CHECK(v + 1 >= lo && v <= hi + 1);
+    }
+  }
+  seg.opacity = 255;
+
+  //full resolution needs no row
+  seg.scale = 1;
+  hostSetMillis(300000);
+  fx->service();
+  CHECK(fx->getSegmentRuntime().pixels == nullptr);
+}
+
+int main()
+{
+  hostSetupBus(LEDS);
+  fx = new WS2812FX();
+  fx->finalizeInit();
+  fx->setSegment(0, 0, LEDS);
+
+  pipeline();
+
+  const uint8_t scales[] = {2, 4, 8};
+  printf("mean (max) error per channel against full resolution, %u LEDs, and effect time per frame\n", LEDS);
+  printf("%-12s %6s", "effect", "1x us");
+  for (uint8_t k : scales) printf("   %ux linear     %ux cubic   %ux us", k, k, k);
+  printf("\n");
+  for (uint8_t m = 0; m < MODE_COUNT; m++) {
+    if (!(fx->getModeFlags(m) & FX_FLAG_SCALABLE)) continue;
+    Run full = render(m, 1, false, true);
+    printf("%-12s %6.1f", effectNames[m], full.usPerFrame);
+    for (uint8_t k : scales) {
+      Run lin = render(m, k, false, false), cub = render(m, k, true, false);
+      printf("  %5.2f (%3.0f)  %5.2f (%3.0f)  %5.1f", lin.err, lin.maxErr, cub.err, cub.maxErr, lin.usPerFrame);
+      if (k == 4) { //a scale of 4 keeps smooth effects within a few steps of full resolution
+        CHECK(lin.err < 6);
+        CHECK(cub.err < 6);
+      }
+    }
+    printf("\n");
+  }
+  return testResult("upscale");
+}
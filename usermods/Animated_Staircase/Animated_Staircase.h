@@ -104,7 +104,7 @@ class Animated_Staircase : public Usermod {
     void updateSegments() {
       mainSegmentId = strip.getMainSegmentId();
       WS2812FX::Segment* segments = strip.getSegments();
-      for (int i = 0; i < MAX_NUM_SEGMENTS; i++, segments++) {
+      for (int i = 0; i < strip.getSegmentsNum(); i++, segments++) {
         if (!segments->isActive()) {
           maxSegmentId = i - 1;
           break;
@@ -291,7 +291,7 @@ class Animated_Staircase : public Usermod {
       } else {
         // Restore segment options
         WS2812FX::Segment* segments = strip.getSegments();
-        for (int i = 0; i < MAX_NUM_SEGMENTS; i++, segments++) {
+        for (int i = 0; i < strip.getSegmentsNum(); i++, segments++) {
           if (!segments->isActive()) {
             maxSegmentId = i - 1;
             break;
@@ -32,9 +32,6 @@
 // starting with "(" will always remain at the front of the list.
 //
 
-// Number of modes at the start of the list to not sort
-#define MODE_SORT_SKIP_COUNT 1
-
 // Which list is being sorted
 char **listBeingSorted = nullptr;
 
@@ -113,7 +110,7 @@ public:
      * You can use it to initialize variables, sensors or similar.
      */
     void setup() {
-        // Sort the modes and palettes on startup
+        // Sort the palettes on startup
         // as they are guarantted to change.
         sortModesAndPalettes();
     }
@@ -145,8 +142,11 @@ public:
      */
     void sortModesAndPalettes() {
         modes_qstrings = re_findModeStrings(JSON_mode_names, strip.getModeCount());
-        modes_alpha_indexes = re_initIndexArray(strip.getModeCount());
-        re_sortModes(modes_qstrings, modes_alpha_indexes, strip.getModeCount(), MODE_SORT_SKIP_COUNT);
+        // The mode order is generated at compile time from the effect registry
+        modes_alpha_indexes = (byte *)malloc(sizeof(byte) * strip.getModeCount());
+        for (byte i = 0; i < strip.getModeCount(); i++) {
+            modes_alpha_indexes[i] = strip.getModeSortIndex(i);
+        }
 
         palettes_qstrings = re_findModeStrings(JSON_palette_names, strip.getPaletteCount());
         palettes_alpha_indexes = re_initIndexArray(strip.getPaletteCount());
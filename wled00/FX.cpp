@@ -1832,39 +1832,44 @@ uint16_t WS2812FX::mode_palette()
 uint16_t WS2812FX::mode_fire_2012()
 {
   uint32_t it = now >> 5; //div 32
+  uint16_t cols = IS_2D ? SEGW : 1;    // 2D: a fire in every column, burning upwards from the bottom row
+  uint16_t len  = IS_2D ? SEGH : SEGLEN;
 
-  if (!SEGENV.allocateData(SEGLEN)) return mode_static(); //allocation failed
-  
-  byte* heat = SEGENV.data;
+  if (!SEGENV.allocateData(cols * len)) return mode_static(); //allocation failed
 
-  if (it != SEGENV.step)
-  {
-    uint8_t ignition = max(7,SEGLEN/10);  // ignition area: 10% of segment length or minimum 7 pixels
+  for (uint16_t c = 0; c < cols; c++) {
+    byte* heat = SEGENV.data + c * len;
+
+    if (it != SEGENV.step)
+    {
+      uint8_t ignition = max(7,len/10);  // ignition area: 10% of segment length or minimum 7 pixels
     
-    // Step 1.  Cool down every cell a little
-    for (uint16_t i = 0; i < SEGLEN; i++) {
-      uint8_t temp = qsub8(heat[i], random8(0, (((20 + SEGMENT.speed /3) * 10) / SEGLEN) + 2));
-      heat[i] = (temp==0 && i<ignition) ? 16 : temp; // prevent ignition area from becoming black
-    }
+      // Step 1.  Cool down every cell a little
+      for (uint16_t i = 0; i < len; i++) {
+        uint8_t temp = qsub8(heat[i], random8(0, (((20 + SEGMENT.speed /3) * 10) / len) + 2));
+        heat[i] = (temp==0 && i<ignition) ? 16 : temp; // prevent ignition area from becoming black
+      }
   
-    // Step 2.  Heat from each cell drifts 'up' and diffuses a little
-    for (uint16_t k= SEGLEN -1; k > 1; k--) {
-      heat[k] = (heat[k - 1] + (heat[k - 2]<<1) ) / 3;  // heat[k-2] multiplied by 2
-    }
+      // Step 2.  Heat from each cell drifts 'up' and diffuses a little
+      for (uint16_t k= len -1; k > 1; k--) {
+        heat[k] = (heat[k - 1] + (heat[k - 2]<<1) ) / 3;  // heat[k-2] multiplied by 2
+      }
     
-    // Step 3.  Randomly ignite new 'sparks' of heat near the bottom
-    if (random8() <= SEGMENT.intensity) {
-      uint8_t y = random8(ignition);
-      if (y < SEGLEN) heat[y] = qadd8(heat[y], random8(160,255));
+      // Step 3.  Randomly ignite new 'sparks' of heat near the bottom
+      if (random8() <= SEGMENT.intensity) {
+        uint8_t y = random8(ignition);
+        if (y < len) heat[y] = qadd8(heat[y], random8(160,255));
+      }
     }
-    SEGENV.step = it;
-  }
 
-  // Step 4.  Map from heat cells to LED colors
-  for (uint16_t j = 0; j < SEGLEN; j++) {
-    CRGB color = ColorFromPalette(currentPalette, MIN(heat[j],240), 255, LINEARBLEND);
-    setPixelColor(j, color.red, color.green, color.blue);
+    // Step 4.  Map from heat cells to LED colors
+    for (uint16_t j = 0; j < len; j++) {
+      CRGB color = ColorFromPalette(currentPalette, MIN(heat[j],240), 255, LINEARBLEND);
+      uint16_t i = IS_2D ? XY(c, len - 1 - j) : j;
+      setPixelColor(i, color.red, color.green, color.blue);
+    }
   }
+  SEGENV.step = it;
   return FRAMETIME;
 }
 
@@ -1938,10 +1943,15 @@ uint16_t WS2812FX::mode_fillnoise8()
 {
   if (SEGENV.call == 0) SEGENV.step = random16(12345);
   CRGB fastled_col;
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-    uint8_t index = inoise8(i * SEGLEN, SEGENV.step + i * SEGLEN);
-    fastled_col = ColorFromPalette(currentPalette, index, 255, LINEARBLEND);
-    setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
+  uint8_t noise[NOISE_CHUNK];
+  uint32_t d = (uint32_t)SEGLEN << 8; //8 bit noise coordinates scaled to the 16 bit field
+  for (uint16_t i0 = 0; i0 < SEGLEN; i0 += NOISE_CHUNK) {
+    uint16_t n = MIN(NOISE_CHUNK, SEGLEN - i0);
+    fillNoise8(noise, n, i0 * d, d, (SEGENV.step << 8) + i0 * d, d, 0);
+    for (uint16_t i = 0; i < n; i++) {
+      fastled_col = ColorFromPalette(currentPalette, noise[i], 255, LINEARBLEND);
+      setPixelColor(i0 + i, fastled_col.red, fastled_col.green, fastled_col.blue);
+    }
   }
   SEGENV.step += beatsin8(SEGMENT.speed, 1, 6); //10,1,4
 
@@ -1952,24 +1962,26 @@ uint16_t WS2812FX::mode_noise16_1()
 {
   uint16_t scale = 320;                                      // the "zoom factor" for the noise
   CRGB fastled_col;
+  uint8_t noise[NOISE_CHUNK];
   SEGENV.step += (1 + SEGMENT.speed/16);
 
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-
-    uint16_t shift_x = beatsin8(11);                           // the x position of the noise field swings @ 17 bpm
-    uint16_t shift_y = SEGENV.step/42;             // the y position becomes slowly incremented
-
+  uint16_t shift_x = beatsin8(11);                           // the x position of the noise field swings @ 17 bpm
+  uint16_t shift_y = SEGENV.step/42;                         // the y position becomes slowly incremented
+  uint32_t real_z = SEGENV.step;                             // the z position becomes quickly incremented
 
-    uint16_t real_x = (i + shift_x) * scale;                  // the x position of the noise field swings @ 17 bpm
-    uint16_t real_y = (i + shift_y) * scale;                  // the y position becomes slowly incremented
-    uint32_t real_z = SEGENV.step;                          // the z position becomes quickly incremented
+  uint32_t step = scale * SEGSCALE;                          // between calculated pixels
 
-    uint8_t noise = inoise16(real_x, real_y, real_z) >> 8;   // get the noise data and scale it down
+  for (uint16_t y = 0; y < SEGH; y++) for (uint16_t x0 = 0; x0 < SEGW; x0 += NOISE_CHUNK) { //x only for 1D segments
+    uint16_t n = MIN(NOISE_CHUNK, SEGW - x0);
+    uint32_t real_x = x0 * step + shift_x * scale;
+    uint32_t real_y = IS_2D ? (y + shift_y) * scale : x0 * step + shift_y * scale;
+    fillNoise8(noise, n, real_x, step, real_y, IS_2D ? 0 : step, real_z, true); // noise data of the row, scaled down, x and y wrap at 16 bits
 
-    uint8_t index = sin8(noise * 3);                         // map LED color based on noise data
-
-    fastled_col = ColorFromPalette(currentPalette, index, 255, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
-    setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
+    for (uint16_t i = 0; i < n; i++) {
+      uint8_t index = sin8(noise[i] * 3);                    // map LED color based on noise data
+      fastled_col = ColorFromPalette(currentPalette, index, 255, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+      setPixelColor(XY(x0 + i, y), fastled_col.red, fastled_col.green, fastled_col.blue);
+    }
   }
 
   return FRAMETIME;
@@ -1979,21 +1991,20 @@ uint16_t WS2812FX::mode_noise16_1()
 uint16_t WS2812FX::mode_noise16_2()
 {
   uint16_t scale = 1000;                                       // the "zoom factor" for the noise
+  if (!SEGENV.allocateData(NoiseField::size(SEGW * SEGH))) return mode_static(); //allocation failed
+  NoiseField* field = reinterpret_cast<NoiseField*>(SEGENV.data);
   CRGB fastled_col;
   SEGENV.step += (1 + (SEGMENT.speed >> 1));
 
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-
-    uint16_t shift_x = SEGENV.step >> 6;                         // x as a function of time
-
-    uint32_t real_x = (i + shift_x) * scale;                  // calculate the coordinates within the noise field
+  uint16_t shift_x = SEGENV.step >> 6;                        // x as a function of time, the field is reused until it moves
+  const uint8_t* noise = field->fill(SEGW, SEGH, shift_x * scale, scale * SEGSCALE, 0, 0, scale, 4223); // rows at y * scale, 0 for 1D segments
 
-    uint8_t noise = inoise16(real_x, 0, 4223) >> 8;    // get the noise data and scale it down
+  for (uint16_t y = 0; y < SEGH; y++) for (uint16_t x = 0; x < SEGW; x++) {
+    uint8_t nv = *noise++;
+    uint8_t index = sin8(nv * 3);                             // map led color based on noise data
 
-    uint8_t index = sin8(noise * 3);                          // map led color based on noise data
-
-    fastled_col = ColorFromPalette(currentPalette, index, noise, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
-    setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
+    fastled_col = ColorFromPalette(currentPalette, index, nv, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+    setPixelColor(XY(x, y), fastled_col.red, fastled_col.green, fastled_col.blue);
   }
 
   return FRAMETIME;
@@ -2004,23 +2015,26 @@ uint16_t WS2812FX::mode_noise16_3()
 {
   uint16_t scale = 800;                                       // the "zoom factor" for the noise
   CRGB fastled_col;
+  uint8_t noise[NOISE_CHUNK];
   SEGENV.step += (1 + SEGMENT.speed);
 
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-
-    uint16_t shift_x = 4223;                                  // no movement along x and y
-    uint16_t shift_y = 1234;
+  uint16_t shift_x = 4223;                                    // no movement along x and y
+  uint16_t shift_y = 1234;
+  uint32_t real_z = SEGENV.step*8;
 
-    uint32_t real_x = (i + shift_x) * scale;                  // calculate the coordinates within the noise field
-    uint32_t real_y = (i + shift_y) * scale;                  // based on the precalculated positions
-    uint32_t real_z = SEGENV.step*8;  
+  uint32_t step = scale * SEGSCALE;                           // between calculated pixels
 
-    uint8_t noise = inoise16(real_x, real_y, real_z) >> 8;    // get the noise data and scale it down
+  for (uint16_t y = 0; y < SEGH; y++) for (uint16_t x0 = 0; x0 < SEGW; x0 += NOISE_CHUNK) {
+    uint16_t n = MIN(NOISE_CHUNK, SEGW - x0);
+    uint32_t real_x = x0 * step + shift_x * scale;            // calculate the coordinates within the noise field
+    uint32_t real_y = IS_2D ? (y + shift_y) * scale : x0 * step + shift_y * scale; // based on the precalculated positions
+    fillNoise8(noise, n, real_x, step, real_y, IS_2D ? 0 : step, real_z); // noise data of the row, scaled down
 
-    uint8_t index = sin8(noise * 3);                          // map led color based on noise data
-
-    fastled_col = ColorFromPalette(currentPalette, index, noise, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
-    setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
+    for (uint16_t i = 0; i < n; i++) {
+      uint8_t index = sin8(noise[i] * 3);                     // map led color based on noise data
+      fastled_col = ColorFromPalette(currentPalette, index, noise[i], LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+      setPixelColor(XY(x0 + i, y), fastled_col.red, fastled_col.green, fastled_col.blue);
+    }
   }
 
   return FRAMETIME;
@@ -2031,11 +2045,16 @@ uint16_t WS2812FX::mode_noise16_3()
 uint16_t WS2812FX::mode_noise16_4()
 {
   CRGB fastled_col;
+  uint16_t noise[NOISE_CHUNK];
   uint32_t stp = (now * SEGMENT.speed) >> 7;
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-    int16_t index = inoise16(uint32_t(i) << 12, stp);
-    fastled_col = ColorFromPalette(currentPalette, index);
-    setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
+  for (uint16_t y = 0; y < SEGH; y++) for (uint16_t x0 = 0; x0 < SEGW; x0 += NOISE_CHUNK) {
+    uint16_t n = MIN(NOISE_CHUNK, SEGW - x0);
+    if (IS_2D) fillNoise16(noise, n, uint32_t(x0) << 12, 1 << 12, uint32_t(y) << 12, 0, stp);
+    else       fillNoise16_2D(noise, n, uint32_t(x0) << 12, 1 << 12, stp);
+    for (uint16_t i = 0; i < n; i++) {
+      fastled_col = ColorFromPalette(currentPalette, noise[i]); //low byte as index
+      setPixelColor(XY(x0 + i, y), fastled_col.red, fastled_col.green, fastled_col.blue);
+    }
   }
   return FRAMETIME;
 }
@@ -3288,12 +3307,13 @@ uint16_t WS2812FX::mode_plasma(void) {
   uint8_t thisPhase = beatsin8(6+SEGENV.aux0,-64,64);
   uint8_t thatPhase = beatsin8(7+SEGENV.aux0,-64,64);
 
-  for (int i = 0; i < SEGLEN; i++) {   // For each of the LED's in the strand, set color &  brightness based on a wave as follows:
-    uint8_t colorIndex = cubicwave8((i*(2+ 3*(SEGMENT.speed >> 5))+thisPhase) & 0xFF)/2   // factor=23 // Create a wave and add a phase change and add another wave with its own phase change.
-                             + cos8((i*(1+ 2*(SEGMENT.speed >> 5))+thatPhase) & 0xFF)/2;  // factor=15 // Hey, you can even change the frequencies if you wish.
+  for (uint16_t y = 0; y < SEGH; y++) for (uint16_t x = 0; x < SEGW; x++) {   // For each of the LED's in the strand, set color &  brightness based on a wave as follows:
+    uint16_t x2 = IS_2D ? y : x;  // 2D: second wave runs along the columns
+    uint8_t colorIndex = cubicwave8((x*(2+ 3*(SEGMENT.speed >> 5))+thisPhase) & 0xFF)/2   // factor=23 // Create a wave and add a phase change and add another wave with its own phase change.
+                             + cos8((x2*(1+ 2*(SEGMENT.speed >> 5))+thatPhase) & 0xFF)/2; // factor=15 // Hey, you can even change the frequencies if you wish.
     uint8_t thisBright = qsub8(colorIndex, beatsin8(7,0, (128 - (SEGMENT.intensity>>1))));
     CRGB color = ColorFromPalette(currentPalette, colorIndex, thisBright, LINEARBLEND);
-    setPixelColor(i, color.red, color.green, color.blue);
+    setPixelColor(XY(x, y), color.red, color.green, color.blue);
   }
 
   return FRAMETIME;
@@ -3448,15 +3468,16 @@ uint16_t WS2812FX::mode_pacifica()
   
   for( uint16_t i = 0; i < SEGLEN; i++) {
     CRGB c = CRGB(2, 6, 10);
+    uint16_t x = i * SEGSCALE; //position on the strip
     // Render each of four layers, with different scales and speeds, that vary over time
-    c += pacifica_one_layer(i, pacifica_palette_1, sCIStart1, beatsin16(3, 11 * 256, 14 * 256), beatsin8(10, 70, 130), 0-beat16(301));
-    c += pacifica_one_layer(i, pacifica_palette_2, sCIStart2, beatsin16(4,  6 * 256,  9 * 256), beatsin8(17, 40,  80),   beat16(401));
-    c += pacifica_one_layer(i, pacifica_palette_3, sCIStart3,                         6 * 256 , beatsin8(9, 10,38)   , 0-beat16(503));
-    c += pacifica_one_layer(i, pacifica_palette_3, sCIStart4,                         5 * 256 , beatsin8(8, 10,28)   ,   beat16(601));
+    c += pacifica_one_layer(x, pacifica_palette_1, sCIStart1, beatsin16(3, 11 * 256, 14 * 256), beatsin8(10, 70, 130), 0-beat16(301));
+    c += pacifica_one_layer(x, pacifica_palette_2, sCIStart2, beatsin16(4,  6 * 256,  9 * 256), beatsin8(17, 40,  80),   beat16(401));
+    c += pacifica_one_layer(x, pacifica_palette_3, sCIStart3,                         6 * 256 , beatsin8(9, 10,38)   , 0-beat16(503));
+    c += pacifica_one_layer(x, pacifica_palette_3, sCIStart4,                         5 * 256 , beatsin8(8, 10,28)   ,   beat16(601));
     
     // Add extra 'white' to areas where the four layers of light have lined up brightly
     uint8_t threshold = scale8( sin8( wave), 20) + basethreshold;
-    wave += 7;
+    wave += 7 * SEGSCALE;
     uint8_t l = c.getAverageLight();
     if (l > threshold) {
       uint8_t overage = l - threshold;
@@ -3563,17 +3584,21 @@ uint16_t WS2812FX::mode_sunrise() {
 uint16_t WS2812FX::phased_base(uint8_t moder) {                  // We're making sine waves here. By Andrew Tuline.
 
   uint8_t allfreq = 16;                                          // Base frequency.
-  //float* phasePtr = reinterpret_cast<float*>(SEGENV.step);       // Phase change value gets calculated.
-  static float phase = 0;//phasePtr[0];
+  SEGENV.step += SEGMENT.speed;                                  // Phase in 1/32 steps, kept per segment so synced nodes stay in step.
+  float phase = SEGENV.step/32.0;                                // You can change the speed of the wave. AKA SPEED (was .4)
   uint8_t cutOff = (255-SEGMENT.intensity);                      // You can change the number of pixels.  AKA INTENSITY (was 192).
   uint8_t modVal = 5;//SEGMENT.fft1/8+1;                         // You can change the modulus. AKA FFT1 (was 5).
 
   uint8_t index = now/64;                                    // Set color rotation speed
-  phase += SEGMENT.speed/32.0;                                   // You can change the speed of the wave. AKA SPEED (was .4)
-  //phasePtr[0] = phase; 
+
+  const uint8_t* noise = nullptr;
+  if (moder == 1) {                                              // the noise does not move, so it is only calculated once
+    if (!SEGENV.allocateData(NoiseField::size(SEGLEN))) return mode_static(); //allocation failed
+    noise = reinterpret_cast<NoiseField*>(SEGENV.data)->fill(SEGLEN, 1, 0, 20 << 8, 0, 0, 0, 0);
+  }
 
   for (int i = 0; i < SEGLEN; i++) {
-    if (moder == 1) modVal = (inoise8(i*10 + i*10) /16);         // Let's randomize our mod length with some Perlin noise.
+    if (moder == 1) modVal = noise[i] /16;                       // Let's randomize our mod length with some Perlin noise.
     uint16_t val = (i+1) * allfreq;                              // This sets the frequency of the waves. The +1 makes sure that leds[0] is used.
     if (modVal == 0) modVal = 1;
     val += phase * (i % modVal +1) /2;                           // This sets the varying phase change of the waves. By Andrew Tuline.
@@ -3641,10 +3666,15 @@ uint16_t WS2812FX::mode_noisepal(void) {                                    // S
 
   if (SEGMENT.palette > 0) palettes[0] = currentPalette;
 
-  for(int i = 0; i < SEGLEN; i++) {
-    uint8_t index = inoise8(i*scale, SEGENV.aux0+i*scale);                // Get a value from the noise function. I'm using both x and y axis.
-    color = ColorFromPalette(palettes[0], index, 255, LINEARBLEND);       // Use the my own palette.
-    setPixelColor(i, color.red, color.green, color.blue);
+  uint8_t noise[NOISE_CHUNK];
+  uint32_t d = (uint32_t)scale << 8;                                      // 8 bit noise coordinates scaled to the 16 bit field
+  for(uint16_t i0 = 0; i0 < SEGLEN; i0 += NOISE_CHUNK) {
+    uint16_t n = MIN(NOISE_CHUNK, SEGLEN - i0);
+    fillNoise8(noise, n, i0 * d, d, ((uint32_t)SEGENV.aux0 << 8) + i0 * d, d, 0); // Get values from the noise function. I'm using both x and y axis.
+    for (uint16_t i = 0; i < n; i++) {
+      color = ColorFromPalette(palettes[0], noise[i], 255, LINEARBLEND);  // Use the my own palette.
+      setPixelColor(i0 + i, color.red, color.green, color.blue);
+    }
   }
 
   SEGENV.aux0 += beatsin8(10,1,4);                                        // Moving along the distance. Vary it a bit with a sine wave.
@@ -4079,16 +4109,16 @@ class AuroraWave {
     bool alive = true;
 
   public:
-    void init(uint32_t segment_length, CRGB color) {
-      ttl = random(500, 1501);
+    void init(uint32_t segment_length, CRGB color, WS2812FX* fx) { //random numbers from the segment's sequence
+      ttl = fx->random(500, 1501);
       basecolor = color;
-      basealpha = random(60, 101) / (float)100;
+      basealpha = fx->random(60, 101) / (float)100;
       age = 0;
-      width = random(segment_length / 20, segment_length / W_WIDTH_FACTOR); //half of width to make math easier
+      width = fx->random(segment_length / 20, segment_length / W_WIDTH_FACTOR); //half of width to make math easier
       if (!width) width = 1;
-      center = random(101) / (float)100 * segment_length;
-      goingleft = random(0, 2) == 0;
-      speed_factor = (random(10, 31) / (float)100 * W_MAX_SPEED / 255);
+      center = fx->random(101) / (float)100 * segment_length;
+      goingleft = fx->random(0, 2) == 0;
+      speed_factor = (fx->random(10, 31) / (float)100 * W_MAX_SPEED / 255);
       alive = true;
     }
 
@@ -4170,7 +4200,7 @@ uint16_t WS2812FX::mode_aurora(void) {
     waves = reinterpret_cast<AuroraWave*>(SEGENV.data);
 
     for(int i = 0; i < SEGENV.aux1; i++) {
-      waves[i].init(SEGLEN, col_to_crgb(color_from_palette(random8(), false, false, random(0, 3))));
+      waves[i].init(SEGLEN, col_to_crgb(color_from_palette(random8(), false, false, random(0, 3))), this);
     }
   } else {
     waves = reinterpret_cast<AuroraWave*>(SEGENV.data);
@@ -4182,7 +4212,7 @@ uint16_t WS2812FX::mode_aurora(void) {
 
     if(!(waves[i].stillAlive())) {
       //If a wave dies, reinitialize it starts over.
-      waves[i].init(SEGLEN, col_to_crgb(color_from_palette(random8(), false, false, random(0, 3))));
+      waves[i].init(SEGLEN, col_to_crgb(color_from_palette(random8(), false, false, random(0, 3))), this);
     }
   }
 
@@ -4208,4 +4238,81 @@ uint16_t WS2812FX::mode_aurora(void) {
   }
   
   return FRAMETIME;
-}
\ No newline at end of file
+}
+
+/*
+ * Runs the expression in /fx<n>.txt for every pixel, n is the segment "prog" value (see fxvm.cpp).
+ * Pixels are evaluated FXVM_SPAN at a time. If that takes longer than FXVM_FRAME_BUDGET_US,
+ * the remaining pixels are calculated in the next frame.
+ */
+uint16_t WS2812FX::mode_expression(void) {
+  uint32_t key = (((uint32_t)fxvmVersion() << 8) | SEGMENT.program) + 1; //reload if the program changed
+  if (SEGENV.step != key) {
+    SEGENV.step = key;
+    SEGENV.aux1 = 0;
+    SEGENV.deallocateData();
+    FxProgram prog;
+    if (fxvmLoad(SEGMENT.program, &prog) && SEGENV.allocateData(fxvmDataSize(&prog))) {
+      memcpy(SEGENV.data, &prog, sizeof(prog));
+      fxvmInit(reinterpret_cast<FxProgram*>(SEGENV.data));
+    }
+  }
+  if (!SEGENV.data) return mode_static(); //no valid program or allocation failed
+
+  FxProgram* prog = reinterpret_cast<FxProgram*>(SEGENV.data);
+  uint16_t w = SEGW, len = w * SEGH;
+  fxvmSetUniforms(prog, now, len, w, SEGH, SEGMENT.speed, SEGMENT.intensity);
+
+  uint32_t out[FXVM_SPAN];
+  uint32_t start = micros();
+  uint16_t i = (SEGENV.aux1 < len) ? SEGENV.aux1 : 0;
+  do {
+    uint16_t n = MIN(FXVM_SPAN, len - i);
+    fxvmRun(prog, i, n, w, out);
+    for (uint16_t k = 0; k < n; k++, i++) {
+      uint32_t c = (prog->out == FXVM_OUT_PALETTE) ? color_from_palette(out[k], false, PALETTE_SOLID_WRAP, 0) : out[k];
+      setPixelColor(XY(i % w, i / w), c);
+    }
+  } while (i < len && micros() - start < FXVM_FRAME_BUDGET_US);
+  SEGENV.aux1 = (i < len) ? i : 0;
+
+  return FRAMETIME;
+}
+
+
+/*
+ * Effect registry tables, generated from WLED_EFFECT_LIST (FX.h) at compile time
+ */
+#define FX_ENTRY(id, fn, name, pal, flags) {&WS2812FX::fn, pal, flags},
+const WS2812FX::effect_info WS2812FX::_effects[MODE_COUNT] PROGMEM = {
+  WLED_EFFECT_LIST(FX_ENTRY, FX_ENTRY)
+};
+
+#define FX_ID(id, fn, name, pal, flags) id,
+static constexpr uint8_t fxIds[] = { WLED_EFFECT_LIST(FX_ID, FX_ID) };
+constexpr bool fxIdsInOrder(uint8_t i = 0) {
+  return i >= MODE_COUNT || (fxIds[i] == i && fxIdsInOrder(i +1));
+}
+static_assert(sizeof(fxIds) == MODE_COUNT && fxIdsInOrder(), "WLED_EFFECT_LIST must list all effects in FX_MODE_ order");
+
+//alphabetical order, case insensitive like the former runtime sort of usermod_v2_mode_sort
+#define FX_NAME(id, fn, name, pal, flags) name,
+static constexpr const char* fxNames[] = { WLED_EFFECT_LIST(FX_NAME, FX_NAME) };
+constexpr char fxUpper(char c) {
+  return (c >= 'a' && c <= 'z') ? c - 32 : c;
+}
+constexpr bool fxNameLess(const char* a, const char* b) {
+  return (*a == 0 || *b == 0 || fxUpper(*a) != fxUpper(*b)) ? fxUpper(*a) < fxUpper(*b) : fxNameLess(a +1, b +1);
+}
+//number of modes sorted before m ("Solid" always stays first), equal names keep their mode order
+constexpr uint8_t fxRank(uint8_t m, uint8_t j = 1) {
+  return j >= MODE_COUNT ? 0 : (j != m && (fxNameLess(fxNames[j], fxNames[m]) || (!fxNameLess(fxNames[m], fxNames[j]) && j < m))) + fxRank(m, j +1);
+}
+#define FX_RANK0(id, fn, name, pal, flags) 0,
+#define FX_RANK(id, fn, name, pal, flags) uint8_t(1 + fxRank(id)),
+static constexpr uint8_t fxRanks[] = { WLED_EFFECT_LIST(FX_RANK0, FX_RANK) };
+constexpr uint8_t fxAtRank(uint8_t r, uint8_t m = 0) {
+  return (m >= MODE_COUNT || fxRanks[m] == r) ? m : fxAtRank(r, m +1);
+}
+#define FX_SORTED(id, fn, name, pal, flags) fxAtRank(id),
+const uint8_t WS2812FX::_modeSortOrder[MODE_COUNT] PROGMEM = { WLED_EFFECT_LIST(FX_SORTED, FX_SORTED) };
@@ -32,6 +32,9 @@
 #define FASTLED_INTERNAL //remove annoying pragma messages
 #define USE_GET_MILLISECOND_TIMER
 #include "FastLED.h"
+#include "colorkernels.h"
+#include "noisefield.h"
+#include "fxvm.h"
 
 #define DEFAULT_BRIGHTNESS (uint8_t)127
 #define DEFAULT_MODE       (uint8_t)0
@@ -48,12 +51,19 @@
 
 /* Not used in all effects yet */
 #define WLED_FPS         42
-#define FRAMETIME        (1000/WLED_FPS)
+#define WLED_FPS_MAX     120
+#define FRAMETIME_FIXED  (1000/WLED_FPS)
+#define FRAMETIME        _frametime //runtime target, see setTargetFps()
 
-/* each segment uses 52 bytes of SRAM memory, so if you're application fails because of
-  insufficient memory, decreasing MAX_NUM_SEGMENTS may help */
+/* frame time histogram, 1ms per bucket, last bucket counts all longer frames */
+#define FRAMETIME_HIST_SIZE 64
+
+/* Highest number of segments. Storage is allocated for the IDs in use only (about 76 bytes each),
+  so a higher limit costs nothing until the segments are created */
 #ifdef ESP8266
-  #define MAX_NUM_SEGMENTS    16
+  #ifndef MAX_NUM_SEGMENTS
+    #define MAX_NUM_SEGMENTS  16
+  #endif
   /* How many color transitions can run at once */
   #define MAX_NUM_TRANSITIONS  8
   /* How much data bytes all segments combined may allocate */
@@ -66,12 +76,24 @@
   #define MAX_SEGMENT_DATA  20480
 #endif
 
+#if MAX_NUM_SEGMENTS > 255
+  #error "MAX_NUM_SEGMENTS can be at most 255, segment IDs are 8 bit"
+#endif
+
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / MAX_NUM_SEGMENTS)
 
+/* Segment data is kept in 4 byte aligned blocks, so effects can store structs with floats in it */
+#define SEGMENT_DATA_ALIGN(len) (((len) + 3) & ~3)
+
+/* The segment data arena grows and shrinks in steps of this size, up to MAX_SEGMENT_DATA */
+#ifndef SEGMENT_DATA_CHUNK
+  #define SEGMENT_DATA_CHUNK 512
+#endif
+
 #define LED_SKIP_AMOUNT  1
-#define MIN_SHOW_DELAY  15
+#define MIN_SHOW_DELAY  (_frametime < 16 ? 8 : 15)
 
 #define NUM_COLORS       3 /* number of colors per segment */
 #define SEGMENT          _segments[_segment_index]
@@ -80,7 +102,7 @@
 #define SEGLEN           _virtualSegmentLength
 #define SEGACT           SEGMENT.stop
 #define SPEED_FORMULA_L  5U + (50U*(255U - SEGMENT.speed))/SEGLEN
-#define RESET_RUNTIME    memset(_segment_runtimes, 0, sizeof(_segment_runtimes))
+#define RESET_RUNTIME    for (uint8_t i = 0; i < _segmentsAllocated; i++) { _segment_runtimes[i].deallocateData(); _segment_runtimes[i].deallocatePixels(); memset(&_segment_runtimes[i], 0, sizeof(segment_runtime)); }
 
 // some common colors
 #define RED        (uint32_t)0xFF0000
@@ -115,7 +137,26 @@
 #define IS_REVERSE      ((SEGMENT.options & REVERSE     ) == REVERSE     )
 #define IS_SELECTED     ((SEGMENT.options & SELECTED    ) == SELECTED    )
 
-#define MODE_COUNT  118
+// 2D segments (Segment.width > 0), see FX_2D.cpp
+#define SEG_LAYOUT_SERPENTINE (uint8_t)0x01 //every other row is wired right to left
+#define SEG_LAYOUT_TRANSPOSE  (uint8_t)0x02 //effects see columns as rows
+
+#ifndef MAX_RENDER_SCALE
+  #define MAX_RENDER_SCALE 16 //highest Segment.scale, pixels interpolated per calculated pixel + 1
+#endif
+#define IS_2D           (SEGMENT.width > 0)
+#define SEGW            segmentWidth()  //canvas width, SEGLEN for 1D segments
+#define SEGH            segmentHeight() //canvas height, 1 for 1D segments
+#define SEGSCALE        _renderScale    //virtual pixels per calculated pixel, FX_FLAG_SCALABLE effects multiply their steps along the strip by it
+
+#define MODE_COUNT  119
+
+// effect flags (see WLED_EFFECT_LIST)
+#define FX_FLAG_2D            (uint8_t)0x01 //draws on the SEGW x SEGH canvas of 2D segments
+#define FX_FLAG_DATA          (uint8_t)0x02 //allocates segment data of a fixed size
+#define FX_FLAG_DATA_PER_LED  (uint8_t)0x04 //allocates segment data that grows with the segment length
+#define FX_FLAG_KEEP_CALL     (uint8_t)0x08 //SEGENV.call is not counted up, the effect uses it as state
+#define FX_FLAG_SCALABLE      (uint8_t)0x10 //smooth along the strip, may be calculated at reduced resolution (Segment.scale)
 
 #define FX_MODE_STATIC                   0
 #define FX_MODE_BLINK                    1
@@ -235,7 +276,9 @@
 #define FX_MODE_BLENDS                 115
 #define FX_MODE_TV_SIMULATOR           116
 #define FX_MODE_DYNAMIC_SMOOTH         117
+#define FX_MODE_EXPRESSION             118
 
+class AuroraWave;
 
 class WS2812FX {
   typedef uint16_t (WS2812FX::*mode_ptr)(void);
@@ -247,7 +290,14 @@ class WS2812FX {
   
   // segment parameters
   public:
-    typedef struct Segment { // 30 (32 in memory) bytes
+    //effect registry entry, the table is generated from WLED_EFFECT_LIST and kept in flash
+    typedef struct EffectInfo {
+      mode_ptr fn;
+      uint8_t  palette; //used if the segment has the Default palette
+      uint8_t  flags;   //FX_FLAG_*, also tells whether the effect allocates segment data
+    } effect_info;
+
+    typedef struct Segment { // 37 (40 in memory) bytes
       uint16_t start;
       uint16_t stop; //segment invalid if stop == 0
       uint16_t offset;
@@ -258,8 +308,13 @@ class WS2812FX {
       uint8_t  options; //bit pattern: msb first: transitional needspixelstate tbd tbd (paused) on reverse selected
       uint8_t  grouping, spacing;
       uint8_t  opacity;
+      uint16_t width;  //2D: LEDs per row, 0 for 1D segments
       uint32_t colors[NUM_COLORS];
       uint8_t  cct; //0==1900K, 255==10091K
+      uint8_t  layout; //2D: SEG_LAYOUT_* wiring of the rows
+      uint8_t  program; //Expression effect: runs /fx<program>.txt
+      uint8_t  scale;   //1D render scale: FX_FLAG_SCALABLE effects calculate every scale-th pixel, the rest is interpolated (0/1: off)
+      uint8_t  clone;   //shows the output of segment clone-1 instead of running an effect (0: off)
       char *name;
       bool setColor(uint8_t slot, uint32_t c, uint8_t segn) { //returns true if changed
         if (slot >= NUM_COLORS || segn >= MAX_NUM_SEGMENTS) return false;
@@ -322,6 +377,10 @@ class WS2812FX {
       {
         return stop - start;
       }
+      inline uint16_t height()
+      {
+        return width ? length() / width : 1;
+      }
       inline uint16_t groupLength()
       {
         return grouping + spacing;
@@ -341,6 +400,8 @@ class WS2812FX {
         if (offset != b.offset)       d |= SEG_DIFFERS_GSO;
         if (grouping != b.grouping)   d |= SEG_DIFFERS_GSO;
         if (spacing != b.spacing)     d |= SEG_DIFFERS_GSO;
+        if (width != b.width)         d |= SEG_DIFFERS_BOUNDS;
+        if (layout != b.layout)       d |= SEG_DIFFERS_BOUNDS;
         if (opacity != b.opacity)     d |= SEG_DIFFERS_BRI;
         if (mode != b.mode)           d |= SEG_DIFFERS_FX;
         if (speed != b.speed)         d |= SEG_DIFFERS_FX;
@@ -358,36 +419,45 @@ class WS2812FX {
     } segment;
 
   // segment runtime parameters
-    typedef struct Segment_runtime { // 28 bytes
+    typedef struct Segment_runtime { // 36 bytes
       unsigned long next_time;  // millis() of next update
       uint32_t step;  // custom "step" var
       uint32_t call;  // call counter
       uint16_t aux0;  // custom var
       uint16_t aux1;  // custom var
-      byte* data = nullptr;
+      uint32_t rng;   // random number generator state, see random8()
+      byte* data = nullptr; // in the segment data arena, may move between effect calls (do not keep pointers to it)
       bool allocateData(uint16_t len){
         if (data && _dataLen == len) return true; //already allocated
         deallocateData();
-        if (WS2812FX::instance->_usedSegmentData + len > MAX_SEGMENT_DATA) return false; //not enough memory
-        // if possible use SPI RAM on ESP32
-        #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
-        if (psramFound())
-          data = (byte*) ps_malloc(len);
-        else
-        #endif
-          data = (byte*) malloc(len);
-        if (!data) return false; //allocation failed
-        WS2812FX::instance->_usedSegmentData += len;
+        if (!len) return true; //nothing to allocate
+        data = WS2812FX::instance->allocateSegmentData(len);
+        if (!data) return false; //not enough memory
         _dataLen = len;
         memset(data, 0, len);
         return true;
       }
       void deallocateData(){
-        free(data);
+        if (data) WS2812FX::instance->freeSegmentData(data, _dataLen);
         data = nullptr;
-        WS2812FX::instance->_usedSegmentData -= _dataLen;
         _dataLen = 0;
       }
+      uint32_t* pixels = nullptr; // calculated colors before opacity and output, every scale-th virtual pixel (see showSegmentPixels())
+      bool allocatePixels(uint16_t len, uint8_t scale){
+        _pixelsScale = scale;
+        if (len == _pixelsLen) return pixels || !len;
+        deallocatePixels();
+        if (!len) return true;
+        pixels = (uint32_t*) calloc(len, sizeof(uint32_t));
+        if (!pixels) return false; //not enough memory
+        _pixelsLen = len;
+        return true;
+      }
+      void deallocatePixels(){
+        free(pixels);
+        pixels = nullptr;
+        _pixelsLen = 0;
+      }
 
       /** 
        * If reset of this segment was request, clears runtime
@@ -399,6 +469,7 @@ class WS2812FX {
       void resetIfRequired() {
         if (_requiresReset) {
           next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0; 
+          rng = instance->segmentSeed(this - instance->_segment_runtimes);
           deallocateData();
           _requiresReset = false;
         }
@@ -409,30 +480,33 @@ class WS2812FX {
        * the internal segment state should be reset. 
        * Call resetIfRequired before calling the next effect function.
        */
-      inline void reset() { _requiresReset = true; }
+      inline void reset() { _requiresReset = true; if (instance) instance->_nextFrame = 0; }
       private:
+        friend class WS2812FX; //for segment data compaction
         uint16_t _dataLen = 0;
+        uint16_t _pixelsLen = 0;
+        uint8_t _pixelsScale = 1;
         bool _requiresReset = false;
     } segment_runtime;
 
-    typedef struct ColorTransition { // 12 bytes
+    typedef struct ColorTransition { // 16 bytes
       uint32_t colorOld = 0;
       uint32_t transitionStart;
       uint16_t transitionDur;
-      uint8_t segment = 0xFF; //lower 6 bits: the segment this transition is for (255 indicates transition not in use/available) upper 2 bits: color channel
+      uint8_t segment = 0xFF; //the segment this transition is for (255 indicates transition not in use/available)
+      uint8_t slot = 0;       //color channel
       uint8_t briOld = 0;
       static void startTransition(uint8_t oldBri, uint32_t oldCol, uint16_t dur, uint8_t segn, uint8_t slot) {
-        if (segn >= MAX_NUM_SEGMENTS || slot >= NUM_COLORS || dur == 0) return;
+        if (segn >= instance->_segmentsNum || slot >= NUM_COLORS || dur == 0) return;
         if (instance->_brightness == 0) return; //do not need transitions if master bri is off
         if (!instance->_segments[segn].getOption(SEG_OPTION_ON)) return; //not if segment is off either
         uint8_t tIndex = 0xFF; //none found
         uint16_t tProgression = 0;
-        uint8_t s = segn + (slot << 6); //merge slot and segment into one byte
 
         for (uint8_t i = 0; i < MAX_NUM_TRANSITIONS; i++) {
           uint8_t tSeg = instance->transitions[i].segment;
           //see if this segment + color already has a running transition
-          if (tSeg == s) {
+          if (tSeg == segn && instance->transitions[i].slot == slot) {
             tIndex = i; break;
           }
           if (tSeg == 0xFF) { //free transition
@@ -451,7 +525,7 @@ class WS2812FX {
         }
 
         ColorTransition& t = instance->transitions[tIndex];
-        if (t.segment == s) //this is an active transition on the same segment+color
+        if (t.segment == segn && t.slot == slot) //this is an active transition on the same segment+color
         {
           bool wasTurningOff = (oldBri == 0);
           t.briOld = t.currentBri(wasTurningOff, slot);
@@ -459,22 +533,26 @@ class WS2812FX {
         } else {
           t.briOld = oldBri;
           t.colorOld = oldCol;
-          uint8_t prevSeg = t.segment & 0x3F;
-          if (prevSeg < MAX_NUM_SEGMENTS) instance->_segments[prevSeg].setOption(SEG_OPTION_TRANSITIONAL, false);
+          uint8_t prevSeg = t.segment;
+          if (prevSeg < instance->_segmentsNum) instance->_segments[prevSeg].setOption(SEG_OPTION_TRANSITIONAL, false);
         }
         t.transitionDur = dur;
         t.transitionStart = millis();
-        t.segment = s;
+        t.segment = segn;
+        t.slot = slot;
         instance->_segments[segn].setOption(SEG_OPTION_TRANSITIONAL, true);
         //refresh immediately, required for Solid mode
-        if (instance->_segment_runtimes[segn].next_time > t.transitionStart + 22) instance->_segment_runtimes[segn].next_time = t.transitionStart;
+        if (instance->_segment_runtimes[segn].next_time > t.transitionStart + 22) {
+          instance->_segment_runtimes[segn].next_time = t.transitionStart;
+          if (instance->_nextFrame > t.transitionStart) instance->_nextFrame = t.transitionStart;
+        }
       }
       uint16_t progress(bool allowEnd = false) { //transition progression between 0-65535
         uint32_t timeNow = millis();
         if (timeNow - transitionStart > transitionDur) {
           if (allowEnd) {
-            uint8_t segn = segment & 0x3F;
-            if (segn < MAX_NUM_SEGMENTS) instance->_segments[segn].setOption(SEG_OPTION_TRANSITIONAL, false);
+            uint8_t segn = segment;
+            if (segn < instance->_segmentsNum) instance->_segments[segn].setOption(SEG_OPTION_TRANSITIONAL, false);
             segment = 0xFF;
           }
           return 0xFFFF;
@@ -487,8 +565,8 @@ class WS2812FX {
         return instance->color_blend(colorOld, colorNew, progress(true), true);
       }
       uint8_t currentBri(bool turningOff = false, uint8_t slot = 0) {
-        uint8_t segn = segment & 0x3F;
-        if (segn >= MAX_NUM_SEGMENTS) return 0;
+        uint8_t segn = segment;
+        if (segn >= instance->_segmentsNum) return 0;
         uint8_t briNew = instance->_segments[segn].opacity;
         if (slot == 0) {
           if (!instance->_segments[segn].getOption(SEG_OPTION_ON) || turningOff) briNew = 0;
@@ -502,132 +580,14 @@ class WS2812FX {
 
     WS2812FX() {
       WS2812FX::instance = this;
-      //assign each member of the _mode[] array to its respective function reference 
-      _mode[FX_MODE_STATIC]                  = &WS2812FX::mode_static;
-      _mode[FX_MODE_BLINK]                   = &WS2812FX::mode_blink;
-      _mode[FX_MODE_COLOR_WIPE]              = &WS2812FX::mode_color_wipe;
-      _mode[FX_MODE_COLOR_WIPE_RANDOM]       = &WS2812FX::mode_color_wipe_random;
-      _mode[FX_MODE_RANDOM_COLOR]            = &WS2812FX::mode_random_color;
-      _mode[FX_MODE_COLOR_SWEEP]             = &WS2812FX::mode_color_sweep;
-      _mode[FX_MODE_DYNAMIC]                 = &WS2812FX::mode_dynamic;
-      _mode[FX_MODE_RAINBOW]                 = &WS2812FX::mode_rainbow;
-      _mode[FX_MODE_RAINBOW_CYCLE]           = &WS2812FX::mode_rainbow_cycle;
-      _mode[FX_MODE_SCAN]                    = &WS2812FX::mode_scan;
-      _mode[FX_MODE_DUAL_SCAN]               = &WS2812FX::mode_dual_scan;
-      _mode[FX_MODE_FADE]                    = &WS2812FX::mode_fade;
-      _mode[FX_MODE_THEATER_CHASE]           = &WS2812FX::mode_theater_chase;
-      _mode[FX_MODE_THEATER_CHASE_RAINBOW]   = &WS2812FX::mode_theater_chase_rainbow;
-      _mode[FX_MODE_SAW]                     = &WS2812FX::mode_saw;
-      _mode[FX_MODE_TWINKLE]                 = &WS2812FX::mode_twinkle;
-      _mode[FX_MODE_DISSOLVE]                = &WS2812FX::mode_dissolve;
-      _mode[FX_MODE_DISSOLVE_RANDOM]         = &WS2812FX::mode_dissolve_random;
-      _mode[FX_MODE_SPARKLE]                 = &WS2812FX::mode_sparkle;
-      _mode[FX_MODE_FLASH_SPARKLE]           = &WS2812FX::mode_flash_sparkle;
-      _mode[FX_MODE_HYPER_SPARKLE]           = &WS2812FX::mode_hyper_sparkle;
-      _mode[FX_MODE_STROBE]                  = &WS2812FX::mode_strobe;
-      _mode[FX_MODE_STROBE_RAINBOW]          = &WS2812FX::mode_strobe_rainbow;
-      _mode[FX_MODE_MULTI_STROBE]            = &WS2812FX::mode_multi_strobe;
-      _mode[FX_MODE_BLINK_RAINBOW]           = &WS2812FX::mode_blink_rainbow;
-      _mode[FX_MODE_ANDROID]                 = &WS2812FX::mode_android;
-      _mode[FX_MODE_CHASE_COLOR]             = &WS2812FX::mode_chase_color;
-      _mode[FX_MODE_CHASE_RANDOM]            = &WS2812FX::mode_chase_random;
-      _mode[FX_MODE_CHASE_RAINBOW]           = &WS2812FX::mode_chase_rainbow;
-      _mode[FX_MODE_CHASE_FLASH]             = &WS2812FX::mode_chase_flash;
-      _mode[FX_MODE_CHASE_FLASH_RANDOM]      = &WS2812FX::mode_chase_flash_random;
-      _mode[FX_MODE_CHASE_RAINBOW_WHITE]     = &WS2812FX::mode_chase_rainbow_white;
-      _mode[FX_MODE_COLORFUL]                = &WS2812FX::mode_colorful;
-      _mode[FX_MODE_TRAFFIC_LIGHT]           = &WS2812FX::mode_traffic_light;
-      _mode[FX_MODE_COLOR_SWEEP_RANDOM]      = &WS2812FX::mode_color_sweep_random;
-      _mode[FX_MODE_RUNNING_COLOR]           = &WS2812FX::mode_running_color;
-      _mode[FX_MODE_AURORA]                  = &WS2812FX::mode_aurora;
-      _mode[FX_MODE_RUNNING_RANDOM]          = &WS2812FX::mode_running_random;
-      _mode[FX_MODE_LARSON_SCANNER]          = &WS2812FX::mode_larson_scanner;
-      _mode[FX_MODE_COMET]                   = &WS2812FX::mode_comet;
-      _mode[FX_MODE_FIREWORKS]               = &WS2812FX::mode_fireworks;
-      _mode[FX_MODE_RAIN]                    = &WS2812FX::mode_rain;
-      _mode[FX_MODE_TETRIX]                  = &WS2812FX::mode_tetrix;
-      _mode[FX_MODE_FIRE_FLICKER]            = &WS2812FX::mode_fire_flicker;
-      _mode[FX_MODE_GRADIENT]                = &WS2812FX::mode_gradient;
-      _mode[FX_MODE_LOADING]                 = &WS2812FX::mode_loading;
-      _mode[FX_MODE_POLICE]                  = &WS2812FX::mode_police;
-      _mode[FX_MODE_FAIRY]                   = &WS2812FX::mode_fairy;
-      _mode[FX_MODE_TWO_DOTS]                = &WS2812FX::mode_two_dots;
-      _mode[FX_MODE_FAIRYTWINKLE]            = &WS2812FX::mode_fairytwinkle;
-      _mode[FX_MODE_RUNNING_DUAL]            = &WS2812FX::mode_running_dual;
-      _mode[FX_MODE_HALLOWEEN]               = &WS2812FX::mode_halloween;
-      _mode[FX_MODE_TRICOLOR_CHASE]          = &WS2812FX::mode_tricolor_chase;
-      _mode[FX_MODE_TRICOLOR_WIPE]           = &WS2812FX::mode_tricolor_wipe;
-      _mode[FX_MODE_TRICOLOR_FADE]           = &WS2812FX::mode_tricolor_fade;
-      _mode[FX_MODE_BREATH]                  = &WS2812FX::mode_breath;
-      _mode[FX_MODE_RUNNING_LIGHTS]          = &WS2812FX::mode_running_lights;
-      _mode[FX_MODE_LIGHTNING]               = &WS2812FX::mode_lightning;
-      _mode[FX_MODE_ICU]                     = &WS2812FX::mode_icu;
-      _mode[FX_MODE_MULTI_COMET]             = &WS2812FX::mode_multi_comet;
-      _mode[FX_MODE_DUAL_LARSON_SCANNER]     = &WS2812FX::mode_dual_larson_scanner;
-      _mode[FX_MODE_RANDOM_CHASE]            = &WS2812FX::mode_random_chase;
-      _mode[FX_MODE_OSCILLATE]               = &WS2812FX::mode_oscillate;
-      _mode[FX_MODE_FIRE_2012]               = &WS2812FX::mode_fire_2012;
-      _mode[FX_MODE_PRIDE_2015]              = &WS2812FX::mode_pride_2015;
-      _mode[FX_MODE_BPM]                     = &WS2812FX::mode_bpm;
-      _mode[FX_MODE_JUGGLE]                  = &WS2812FX::mode_juggle;
-      _mode[FX_MODE_PALETTE]                 = &WS2812FX::mode_palette;
-      _mode[FX_MODE_COLORWAVES]              = &WS2812FX::mode_colorwaves;
-      _mode[FX_MODE_FILLNOISE8]              = &WS2812FX::mode_fillnoise8;
-      _mode[FX_MODE_NOISE16_1]               = &WS2812FX::mode_noise16_1;
-      _mode[FX_MODE_NOISE16_2]               = &WS2812FX::mode_noise16_2;
-      _mode[FX_MODE_NOISE16_3]               = &WS2812FX::mode_noise16_3;
-      _mode[FX_MODE_NOISE16_4]               = &WS2812FX::mode_noise16_4;
-      _mode[FX_MODE_COLORTWINKLE]            = &WS2812FX::mode_colortwinkle;
-      _mode[FX_MODE_LAKE]                    = &WS2812FX::mode_lake;
-      _mode[FX_MODE_METEOR]                  = &WS2812FX::mode_meteor;
-      _mode[FX_MODE_METEOR_SMOOTH]           = &WS2812FX::mode_meteor_smooth;
-      _mode[FX_MODE_RAILWAY]                 = &WS2812FX::mode_railway;
-      _mode[FX_MODE_RIPPLE]                  = &WS2812FX::mode_ripple;
-      _mode[FX_MODE_TWINKLEFOX]              = &WS2812FX::mode_twinklefox;
-      _mode[FX_MODE_TWINKLECAT]              = &WS2812FX::mode_twinklecat;
-      _mode[FX_MODE_HALLOWEEN_EYES]          = &WS2812FX::mode_halloween_eyes;
-      _mode[FX_MODE_STATIC_PATTERN]          = &WS2812FX::mode_static_pattern;
-      _mode[FX_MODE_TRI_STATIC_PATTERN]      = &WS2812FX::mode_tri_static_pattern;
-      _mode[FX_MODE_SPOTS]                   = &WS2812FX::mode_spots;
-      _mode[FX_MODE_SPOTS_FADE]              = &WS2812FX::mode_spots_fade;
-      _mode[FX_MODE_GLITTER]                 = &WS2812FX::mode_glitter;
-      _mode[FX_MODE_CANDLE]                  = &WS2812FX::mode_candle;
-      _mode[FX_MODE_STARBURST]               = &WS2812FX::mode_starburst;
-      _mode[FX_MODE_EXPLODING_FIREWORKS]     = &WS2812FX::mode_exploding_fireworks;
-      _mode[FX_MODE_BOUNCINGBALLS]           = &WS2812FX::mode_bouncing_balls;
-      _mode[FX_MODE_SINELON]                 = &WS2812FX::mode_sinelon;
-      _mode[FX_MODE_SINELON_DUAL]            = &WS2812FX::mode_sinelon_dual;
-      _mode[FX_MODE_SINELON_RAINBOW]         = &WS2812FX::mode_sinelon_rainbow;
-      _mode[FX_MODE_POPCORN]                 = &WS2812FX::mode_popcorn;
-      _mode[FX_MODE_DRIP]                    = &WS2812FX::mode_drip;
-      _mode[FX_MODE_PLASMA]                  = &WS2812FX::mode_plasma;
-      _mode[FX_MODE_PERCENT]                 = &WS2812FX::mode_percent;
-      _mode[FX_MODE_RIPPLE_RAINBOW]          = &WS2812FX::mode_ripple_rainbow;
-      _mode[FX_MODE_HEARTBEAT]               = &WS2812FX::mode_heartbeat;
-      _mode[FX_MODE_PACIFICA]                = &WS2812FX::mode_pacifica;
-      _mode[FX_MODE_CANDLE_MULTI]            = &WS2812FX::mode_candle_multi;
-      _mode[FX_MODE_SOLID_GLITTER]           = &WS2812FX::mode_solid_glitter;
-      _mode[FX_MODE_SUNRISE]                 = &WS2812FX::mode_sunrise;
-      _mode[FX_MODE_PHASED]                  = &WS2812FX::mode_phased;
-      _mode[FX_MODE_TWINKLEUP]               = &WS2812FX::mode_twinkleup;
-      _mode[FX_MODE_NOISEPAL]                = &WS2812FX::mode_noisepal;
-      _mode[FX_MODE_SINEWAVE]                = &WS2812FX::mode_sinewave;
-      _mode[FX_MODE_PHASEDNOISE]             = &WS2812FX::mode_phased_noise;
-      _mode[FX_MODE_FLOW]                    = &WS2812FX::mode_flow;
-      _mode[FX_MODE_CHUNCHUN]                = &WS2812FX::mode_chunchun;
-      _mode[FX_MODE_DANCING_SHADOWS]         = &WS2812FX::mode_dancing_shadows;
-      _mode[FX_MODE_WASHING_MACHINE]         = &WS2812FX::mode_washing_machine;
-      _mode[FX_MODE_CANDY_CANE]              = &WS2812FX::mode_candy_cane;
-      _mode[FX_MODE_BLENDS]                  = &WS2812FX::mode_blends;
-      _mode[FX_MODE_TV_SIMULATOR]            = &WS2812FX::mode_tv_simulator;
-      _mode[FX_MODE_DYNAMIC_SMOOTH]          = &WS2812FX::mode_dynamic_smooth;
-
       _brightness = DEFAULT_BRIGHTNESS;
       currentPalette = CRGBPalette16(CRGB::Black);
       targetPalette = CloudColors_p;
       ablMilliampsMax = 850;
       currentMilliamps = 0;
       timebase = 0;
+      rngSeed = 0;
+      resizeSegments(1);
       resetSegments();
     }
 
@@ -647,12 +607,19 @@ class WS2812FX {
       setTransitionMode(bool t),
       calcGammaTable(float),
       trigger(void),
+      setTargetFps(uint8_t fps),
+      reseed(uint32_t epoch),
       setSegment(uint8_t n, uint16_t start, uint16_t stop, uint8_t grouping = 0, uint8_t spacing = 0, uint16_t offset = UINT16_MAX),
       resetSegments(),
       makeAutoSegments(),
       fixInvalidSegments(),
       setPixelColor(uint16_t n, uint32_t c),
       setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0),
+      setPixelColorXY(uint16_t x, uint16_t y, uint32_t c),
+      fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t c),
+      drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t c),
+      shift2D(int16_t dx, int16_t dy),
+      blur2D(uint8_t amount),
       show(void),
       setPixelSegment(uint8_t n),
       deserializeMap(uint8_t n=0);
@@ -664,6 +631,8 @@ class WS2812FX {
       gammaCorrectCol = true,
       applyToAllSelected = true,
       setEffectConfig(uint8_t m, uint8_t s, uint8_t i, uint8_t p),
+      ensureSegment(uint8_t n),
+      useSegment(uint8_t n),
       checkSegmentAlignment(void),
 			hasCCTBus(void),
       // return true if the strip is being sent pixel updates
@@ -679,11 +648,16 @@ class WS2812FX {
       getMode(void),
       getSpeed(void),
       getModeCount(void),
+      getModeDefaultPalette(uint8_t m),
+      getModeFlags(uint8_t m),
+      getModeSortIndex(uint8_t pos),
       getPaletteCount(void),
       getMaxSegments(void),
+      getSegmentsNum(void),
       getActiveSegmentsNum(void),
       //getFirstSelectedSegment(void),
       getMainSegmentId(void),
+      getTargetFps(void),
       gamma8(uint8_t),
       gamma8_cal(uint8_t, float),
       sin_gap(uint16_t),
@@ -698,20 +672,41 @@ class WS2812FX {
       triwave16(uint16_t),
       getLengthTotal(void),
       getLengthPhysical(void),
-      getFps();
+      timeToNextFrame(void),
+      getSegmentDataUsed(void),
+      getSegmentDataPeak(void),
+      getSegmentDataSize(void),
+      getSegmentDataFragmentation(void),
+      getFrameTimePercentile(uint8_t p),
+      getFrameTimeMax(void),
+      getFps(),
+      XY(uint16_t x, uint16_t y),
+      segmentWidth(void),
+      segmentHeight(void);
 
     uint32_t
       now,
       timebase,
+      rngSeed, // nodes with the same seed render the same random effect frames after a sync, see reseed()
       color_wheel(uint8_t),
       color_from_palette(uint16_t, bool mapping, bool wrap, uint8_t mcol, uint8_t pbri = 255),
       color_blend(uint32_t,uint32_t,uint16_t,bool b16=false),
       currentColor(uint32_t colorNew, uint8_t tNr),
       gamma32(uint32_t),
       getLastShow(void),
+      getMissedFrames(void),
+      getFramesRendered(void),
+      getFramesShown(void),
+      getSegmentDataCompactions(void),
+      getSegmentDataFails(void),
       getPixelColor(uint16_t),
+      getPixelColorXY(uint16_t x, uint16_t y),
       getColor(void);
 
+    uint64_t
+      getEffectMicros(void),
+      getShowMicros(void);
+
     WS2812FX::Segment&
       getSegment(uint8_t n);
 
@@ -841,7 +836,8 @@ class WS2812FX {
       mode_candy_cane(void),
       mode_blends(void),
       mode_tv_simulator(void),
-      mode_dynamic_smooth(void);
+      mode_dynamic_smooth(void),
+      mode_expression(void);
 
   private:
     uint32_t crgb_to_col(CRGB fastled);
@@ -852,15 +848,35 @@ class WS2812FX {
     uint16_t _length, _virtualSegmentLength;
     uint16_t _rand16seed;
     uint8_t _brightness;
-    uint16_t _usedSegmentData = 0;
+    byte*    _segmentData = nullptr;   //arena for all effect data, sized to what is in use, see allocateSegmentData()
+    uint16_t _segmentDataSize = 0;     //bytes allocated for the arena, at most MAX_SEGMENT_DATA
+    uint16_t _usedSegmentData = 0;     //bytes in live blocks
+    uint16_t _segmentDataTop = 0;      //end of the last live block, new blocks are placed here
+    uint16_t _segmentDataPeak = 0;
+    uint32_t _segmentDataCompactions = 0;
+    uint32_t _segmentDataFails = 0;
     uint16_t _transitionDur = 750;
 
     uint16_t _cumulativeFps = 2;
+    uint8_t  _targetFps = WLED_FPS;
+    uint16_t _frametime = FRAMETIME_FIXED;
+    uint16_t _pacingDelay = 0; //added to segment delays while frames take longer than _frametime
+    uint16_t _frameTimeHist[FRAMETIME_HIST_SIZE] = {0};
+    uint16_t _frameTimeCount = 0;
+    uint16_t _frameTimeMax = 0;
+    uint32_t _missedFrames = 0;
+    uint32_t _framesRendered = 0;
+    uint32_t _framesShown = 0;
+    uint64_t _effectMicros = 0; //time spent in effect functions, incl. segment setup
+    uint64_t _showMicros = 0;   //time spent in show()
 
     bool
       _triggered;
 
-    mode_ptr _mode[MODE_COUNT]; // SRAM footprint: 4 bytes per element
+    static const effect_info _effects[MODE_COUNT]; //in flash, indexed by mode
+    static const uint8_t _modeSortOrder[MODE_COUNT]; //modes in alphabetical order, "Solid" first
+
+    mode_ptr getModeFunction(uint8_t m);
 
     show_callback _callback = nullptr;
 
@@ -892,50 +908,213 @@ class WS2812FX {
       blendPixelColor(uint16_t n, uint32_t color, uint8_t blend),
       startTransition(uint8_t oldBri, uint32_t oldCol, uint16_t dur, uint8_t segn, uint8_t slot),
       estimateCurrentAndLimitBri(void),
+      recordFrameTime(uint32_t us),
+      initSegment(uint8_t n),
+      freeSegmentData(byte* p, uint16_t len),
+      compactSegmentData(void),
       load_gradient_palette(uint8_t),
+      showSegmentPixels(uint8_t src),
+      copySegment(uint8_t src),
       handle_palette(void);
 
+    byte* allocateSegmentData(uint16_t len);
+    bool resizeSegmentData(uint16_t size);
+    bool resizeSegments(uint8_t num);
+    uint32_t segmentSeed(uint8_t n);
+
+    /*
+     * Per-segment pseudo random numbers. These hide the FastLED/Arduino functions of the same name
+     * inside effects, so every segment draws from its own sequence that only depends on the seed.
+     * LCG from Numerical Recipes, the upper bits are used as they have the longest period.
+     */
+    uint32_t _rngEpoch = 0; // sync time the sequences were last restarted at
+
+    inline uint16_t random16() {
+      SEGENV.rng = SEGENV.rng * 1664525 + 1013904223;
+      return SEGENV.rng >> 16;
+    }
+    inline uint16_t random16(uint16_t lim) { return ((uint32_t)random16() * lim) >> 16; }
+    inline uint16_t random16(uint16_t min, uint16_t lim) { return min + random16(lim - min); }
+    inline uint8_t random8() { return random16() >> 8; }
+    inline uint8_t random8(uint8_t lim) { return ((uint16_t)random8() * lim) >> 8; }
+    inline uint8_t random8(uint8_t min, uint8_t lim) { return min + random8(lim - min); }
+    inline long random(long howsmall, long howbig) {
+      if (howsmall >= howbig) return howsmall;
+      return howsmall + (((uint32_t)random16() << 16 | random16()) % (uint32_t)(howbig - howsmall));
+    }
+    inline long random(long howbig) { return random(0, howbig); }
+    inline void random16_set_seed(uint16_t seed) { SEGENV.rng = seed; }
+    friend class AuroraWave; //draws from the segment's sequence
+
     uint16_t* customMappingTable = nullptr;
     uint16_t  customMappingSize  = 0;
     
     uint32_t _lastPaletteChange = 0;
     uint32_t _lastShow = 0;
+    uint32_t _nextFrame = 0; // earliest next_time of all active segments, service() has nothing to do before
 
     uint32_t _colors_t[3];
     uint8_t _bri_t;
+    uint8_t _renderScale = 1; //effect pixel i is virtual pixel i*_renderScale, see showSegmentPixels()
+    uint32_t* _renderPixels = nullptr; //the effect draws into SEGENV.pixels instead of the bus
     
     uint8_t _segment_index = 0;
-    uint8_t _segment_index_palette_last = 99;
-    segment _segments[MAX_NUM_SEGMENTS] = { // SRAM footprint: 24 bytes per element
-      // start, stop, offset, speed, intensity, palette, mode, options, grouping, spacing, opacity (unused), color[]
-      {0, 7, 0, DEFAULT_SPEED, 128, 0, DEFAULT_MODE, NO_OPTIONS, 1, 0, 255, {DEFAULT_COLOR}}
-    };
-    segment_runtime _segment_runtimes[MAX_NUM_SEGMENTS]; // SRAM footprint: 28 bytes per element
+    uint8_t _segment_index_palette_last = 255;
+    // storage for the IDs in use, only resized from the loop, see ensureSegment()
+    segment* _segments = nullptr;                 // SRAM footprint: 40 bytes per element
+    segment_runtime* _segment_runtimes = nullptr; // SRAM footprint: 36 bytes per element
+    uint8_t _segmentsNum = 0;                     // IDs in use, the allocated ones above hold the defaults
+    uint8_t _segmentsAllocated = 0;
+    uint8_t _segmentsServiced = 0;                // segments service() ran for, effect data of trimmed ones is freed there
+    segment _noSegment;                           // returned by getSegment() for IDs not in use
     friend class Segment_runtime;
 
-    ColorTransition transitions[MAX_NUM_TRANSITIONS]; //12 bytes per element
+    ColorTransition transitions[MAX_NUM_TRANSITIONS]; //16 bytes per element
     friend class ColorTransition;
 
+    void
+      blurLine2D(uint16_t n, bool column, uint8_t amount);
+
+    uint8_t
+      cloneSource(uint8_t n);
+
+    bool
+      hasClones(uint8_t n);
+
     uint16_t
       realPixelIndex(uint16_t i),
       transitionProgress(uint8_t tNr);
 };
 
-//10 names per line
-const char JSON_mode_names[] PROGMEM = R"=====([
-"Solid","Blink","Breathe","Wipe","Wipe Random","Random Colors","Sweep","Dynamic","Colorloop","Rainbow",
-"Scan","Scan Dual","Fade","Theater","Theater Rainbow","Running","Saw","Twinkle","Dissolve","Dissolve Rnd",
-"Sparkle","Sparkle Dark","Sparkle+","Strobe","Strobe Rainbow","Strobe Mega","Blink Rainbow","Android","Chase","Chase Random",
-"Chase Rainbow","Chase Flash","Chase Flash Rnd","Rainbow Runner","Colorful","Traffic Light","Sweep Random","Chase 2","Aurora","Stream",
-"Scanner","Lighthouse","Fireworks","Rain","Tetrix","Fire Flicker","Gradient","Loading","Police","Fairy",
-"Two Dots","Fairytwinkle","Running Dual","Halloween","Chase 3","Tri Wipe","Tri Fade","Lightning","ICU","Multi Comet",
-"Scanner Dual","Stream 2","Oscillate","Pride 2015","Juggle","Palette","Fire 2012","Colorwaves","Bpm","Fill Noise",
-"Noise 1","Noise 2","Noise 3","Noise 4","Colortwinkles","Lake","Meteor","Meteor Smooth","Railway","Ripple",
-"Twinklefox","Twinklecat","Halloween Eyes","Solid Pattern","Solid Pattern Tri","Spots","Spots Fade","Glitter","Candle","Fireworks Starburst",
-"Fireworks 1D","Bouncing Balls","Sinelon","Sinelon Dual","Sinelon Rainbow","Popcorn","Drip","Plasma","Percent","Ripple Rainbow",
-"Heartbeat","Pacifica","Candle Multi", "Solid Glitter","Sunrise","Phased","Twinkleup","Noise Pal", "Sine","Phased Noise",
-"Flow","Chunchun","Dancing Shadows","Washing Machine","Candy Cane","Blends","TV Simulator","Dynamic Smooth"
-])=====";
+/*
+ * Effect registry: id, effect function, name, default palette, flags (FX_FLAG_*)
+ * Entries must be in FX_MODE_ order. The function table (FX.cpp), the names JSON below and the
+ * alphabetical order are generated from this list at compile time. The first entry uses E0.
+ */
+#define WLED_EFFECT_LIST(E0, E) \
+  E0(FX_MODE_STATIC,                mode_static,                   "Solid",                0, 0)                               \
+  E (FX_MODE_BLINK,                 mode_blink,                    "Blink",                0, 0)                               \
+  E (FX_MODE_BREATH,                mode_breath,                   "Breathe",              0, 0)                               \
+  E (FX_MODE_COLOR_WIPE,            mode_color_wipe,               "Wipe",                 0, 0)                               \
+  E (FX_MODE_COLOR_WIPE_RANDOM,     mode_color_wipe_random,        "Wipe Random",          0, 0)                               \
+  E (FX_MODE_RANDOM_COLOR,          mode_random_color,             "Random Colors",        0, 0)                               \
+  E (FX_MODE_COLOR_SWEEP,           mode_color_sweep,              "Sweep",                0, 0)                               \
+  E (FX_MODE_DYNAMIC,               mode_dynamic,                  "Dynamic",              0, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_RAINBOW,               mode_rainbow,                  "Colorloop",            0, 0)                               \
+  E (FX_MODE_RAINBOW_CYCLE,         mode_rainbow_cycle,            "Rainbow",              0, FX_FLAG_SCALABLE)                \
+  E (FX_MODE_SCAN,                  mode_scan,                     "Scan",                 0, 0)                               \
+  E (FX_MODE_DUAL_SCAN,             mode_dual_scan,                "Scan Dual",            0, 0)                               \
+  E (FX_MODE_FADE,                  mode_fade,                     "Fade",                 0, 0)                               \
+  E (FX_MODE_THEATER_CHASE,         mode_theater_chase,            "Theater",              0, 0)                               \
+  E (FX_MODE_THEATER_CHASE_RAINBOW, mode_theater_chase_rainbow,    "Theater Rainbow",      0, 0)                               \
+  E (FX_MODE_RUNNING_LIGHTS,        mode_running_lights,           "Running",              0, 0)                               \
+  E (FX_MODE_SAW,                   mode_saw,                      "Saw",                  0, 0)                               \
+  E (FX_MODE_TWINKLE,               mode_twinkle,                  "Twinkle",              0, 0)                               \
+  E (FX_MODE_DISSOLVE,              mode_dissolve,                 "Dissolve",             0, 0)                               \
+  E (FX_MODE_DISSOLVE_RANDOM,       mode_dissolve_random,          "Dissolve Rnd",         0, 0)                               \
+  E (FX_MODE_SPARKLE,               mode_sparkle,                  "Sparkle",              0, 0)                               \
+  E (FX_MODE_FLASH_SPARKLE,         mode_flash_sparkle,            "Sparkle Dark",         0, 0)                               \
+  E (FX_MODE_HYPER_SPARKLE,         mode_hyper_sparkle,            "Sparkle+",             0, 0)                               \
+  E (FX_MODE_STROBE,                mode_strobe,                   "Strobe",               0, 0)                               \
+  E (FX_MODE_STROBE_RAINBOW,        mode_strobe_rainbow,           "Strobe Rainbow",       0, 0)                               \
+  E (FX_MODE_MULTI_STROBE,          mode_multi_strobe,             "Strobe Mega",          0, 0)                               \
+  E (FX_MODE_BLINK_RAINBOW,         mode_blink_rainbow,            "Blink Rainbow",        0, 0)                               \
+  E (FX_MODE_ANDROID,               mode_android,                  "Android",              0, 0)                               \
+  E (FX_MODE_CHASE_COLOR,           mode_chase_color,              "Chase",                0, 0)                               \
+  E (FX_MODE_CHASE_RANDOM,          mode_chase_random,             "Chase Random",         0, 0)                               \
+  E (FX_MODE_CHASE_RAINBOW,         mode_chase_rainbow,            "Chase Rainbow",        0, 0)                               \
+  E (FX_MODE_CHASE_FLASH,           mode_chase_flash,              "Chase Flash",          0, 0)                               \
+  E (FX_MODE_CHASE_FLASH_RANDOM,    mode_chase_flash_random,       "Chase Flash Rnd",      0, 0)                               \
+  E (FX_MODE_CHASE_RAINBOW_WHITE,   mode_chase_rainbow_white,      "Rainbow Runner",       0, 0)                               \
+  E (FX_MODE_COLORFUL,              mode_colorful,                 "Colorful",             0, 0)                               \
+  E (FX_MODE_TRAFFIC_LIGHT,         mode_traffic_light,            "Traffic Light",        0, 0)                               \
+  E (FX_MODE_COLOR_SWEEP_RANDOM,    mode_color_sweep_random,       "Sweep Random",         0, 0)                               \
+  E (FX_MODE_RUNNING_COLOR,         mode_running_color,            "Chase 2",              0, 0)                               \
+  E (FX_MODE_AURORA,                mode_aurora,                   "Aurora",               0, FX_FLAG_DATA)                    \
+  E (FX_MODE_RUNNING_RANDOM,        mode_running_random,           "Stream",               0, 0)                               \
+  E (FX_MODE_LARSON_SCANNER,        mode_larson_scanner,           "Scanner",              0, 0)                               \
+  E (FX_MODE_COMET,                 mode_comet,                    "Lighthouse",           0, 0)                               \
+  E (FX_MODE_FIREWORKS,             mode_fireworks,                "Fireworks",            0, 0)                               \
+  E (FX_MODE_RAIN,                  mode_rain,                     "Rain",                 0, 0)                               \
+  E (FX_MODE_TETRIX,                mode_tetrix,                   "Tetrix",               0, FX_FLAG_DATA)                    \
+  E (FX_MODE_FIRE_FLICKER,          mode_fire_flicker,             "Fire Flicker",         0, 0)                               \
+  E (FX_MODE_GRADIENT,              mode_gradient,                 "Gradient",             0, 0)                               \
+  E (FX_MODE_LOADING,               mode_loading,                  "Loading",              0, 0)                               \
+  E (FX_MODE_POLICE,                mode_police,                   "Police",               0, 0)                               \
+  E (FX_MODE_FAIRY,                 mode_fairy,                    "Fairy",                0, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_TWO_DOTS,              mode_two_dots,                 "Two Dots",             0, 0)                               \
+  E (FX_MODE_FAIRYTWINKLE,          mode_fairytwinkle,             "Fairytwinkle",         0, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_RUNNING_DUAL,          mode_running_dual,             "Running Dual",         0, 0)                               \
+  E (FX_MODE_HALLOWEEN,             mode_halloween,                "Halloween",            0, 0)                               \
+  E (FX_MODE_TRICOLOR_CHASE,        mode_tricolor_chase,           "Chase 3",              0, 0)                               \
+  E (FX_MODE_TRICOLOR_WIPE,         mode_tricolor_wipe,            "Tri Wipe",             0, 0)                               \
+  E (FX_MODE_TRICOLOR_FADE,         mode_tricolor_fade,            "Tri Fade",             0, 0)                               \
+  E (FX_MODE_LIGHTNING,             mode_lightning,                "Lightning",            0, 0)                               \
+  E (FX_MODE_ICU,                   mode_icu,                      "ICU",                  0, 0)                               \
+  E (FX_MODE_MULTI_COMET,           mode_multi_comet,              "Multi Comet",          0, FX_FLAG_DATA)                    \
+  E (FX_MODE_DUAL_LARSON_SCANNER,   mode_dual_larson_scanner,      "Scanner Dual",         0, 0)                               \
+  E (FX_MODE_RANDOM_CHASE,          mode_random_chase,             "Stream 2",             0, 0)                               \
+  E (FX_MODE_OSCILLATE,             mode_oscillate,                "Oscillate",            0, FX_FLAG_DATA)                    \
+  E (FX_MODE_PRIDE_2015,            mode_pride_2015,               "Pride 2015",           0, 0)                               \
+  E (FX_MODE_JUGGLE,                mode_juggle,                   "Juggle",               0, 0)                               \
+  E (FX_MODE_PALETTE,               mode_palette,                  "Palette",              0, FX_FLAG_SCALABLE)                \
+  E (FX_MODE_FIRE_2012,             mode_fire_2012,                "Fire 2012",           35, FX_FLAG_2D|FX_FLAG_DATA_PER_LED) \
+  E (FX_MODE_COLORWAVES,            mode_colorwaves,               "Colorwaves",          26, 0)                               \
+  E (FX_MODE_BPM,                   mode_bpm,                      "Bpm",                  0, 0)                               \
+  E (FX_MODE_FILLNOISE8,            mode_fillnoise8,               "Fill Noise",           9, 0)                               \
+  E (FX_MODE_NOISE16_1,             mode_noise16_1,                "Noise 1",             20, FX_FLAG_2D|FX_FLAG_SCALABLE)     \
+  E (FX_MODE_NOISE16_2,             mode_noise16_2,                "Noise 2",             43, FX_FLAG_2D|FX_FLAG_DATA_PER_LED|FX_FLAG_SCALABLE) \
+  E (FX_MODE_NOISE16_3,             mode_noise16_3,                "Noise 3",             35, FX_FLAG_2D|FX_FLAG_SCALABLE)     \
+  E (FX_MODE_NOISE16_4,             mode_noise16_4,                "Noise 4",             26, FX_FLAG_2D)                      \
+  E (FX_MODE_COLORTWINKLE,          mode_colortwinkle,             "Colortwinkles",        0, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_LAKE,                  mode_lake,                     "Lake",                 0, 0)                               \
+  E (FX_MODE_METEOR,                mode_meteor,                   "Meteor",               4, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_METEOR_SMOOTH,         mode_meteor_smooth,            "Meteor Smooth",        4, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_RAILWAY,               mode_railway,                  "Railway",              4, 0)                               \
+  E (FX_MODE_RIPPLE,                mode_ripple,                   "Ripple",               4, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_TWINKLEFOX,            mode_twinklefox,               "Twinklefox",           4, 0)                               \
+  E (FX_MODE_TWINKLECAT,            mode_twinklecat,               "Twinklecat",           4, 0)                               \
+  E (FX_MODE_HALLOWEEN_EYES,        mode_halloween_eyes,           "Halloween Eyes",       4, FX_FLAG_KEEP_CALL)               \
+  E (FX_MODE_STATIC_PATTERN,        mode_static_pattern,           "Solid Pattern",        4, 0)                               \
+  E (FX_MODE_TRI_STATIC_PATTERN,    mode_tri_static_pattern,       "Solid Pattern Tri",    4, 0)                               \
+  E (FX_MODE_SPOTS,                 mode_spots,                    "Spots",                4, 0)                               \
+  E (FX_MODE_SPOTS_FADE,            mode_spots_fade,               "Spots Fade",           4, 0)                               \
+  E (FX_MODE_GLITTER,               mode_glitter,                  "Glitter",             11, 0)                               \
+  E (FX_MODE_CANDLE,                mode_candle,                   "Candle",               4, 0)                               \
+  E (FX_MODE_STARBURST,             mode_starburst,                "Fireworks Starburst",  4, FX_FLAG_DATA)                    \
+  E (FX_MODE_EXPLODING_FIREWORKS,   mode_exploding_fireworks,      "Fireworks 1D",         4, FX_FLAG_DATA)                    \
+  E (FX_MODE_BOUNCINGBALLS,         mode_bouncing_balls,           "Bouncing Balls",       4, FX_FLAG_DATA)                    \
+  E (FX_MODE_SINELON,               mode_sinelon,                  "Sinelon",              4, 0)                               \
+  E (FX_MODE_SINELON_DUAL,          mode_sinelon_dual,             "Sinelon Dual",         4, 0)                               \
+  E (FX_MODE_SINELON_RAINBOW,       mode_sinelon_rainbow,          "Sinelon Rainbow",      4, 0)                               \
+  E (FX_MODE_POPCORN,               mode_popcorn,                  "Popcorn",              4, FX_FLAG_DATA)                    \
+  E (FX_MODE_DRIP,                  mode_drip,                     "Drip",                 4, FX_FLAG_DATA)                    \
+  E (FX_MODE_PLASMA,                mode_plasma,                   "Plasma",               4, FX_FLAG_2D)                      \
+  E (FX_MODE_PERCENT,               mode_percent,                  "Percent",              4, 0)                               \
+  E (FX_MODE_RIPPLE_RAINBOW,        mode_ripple_rainbow,           "Ripple Rainbow",       4, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_HEARTBEAT,             mode_heartbeat,                "Heartbeat",            4, 0)                               \
+  E (FX_MODE_PACIFICA,              mode_pacifica,                 "Pacifica",             4, FX_FLAG_SCALABLE)                \
+  E (FX_MODE_CANDLE_MULTI,          mode_candle_multi,             "Candle Multi",         4, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_SOLID_GLITTER,         mode_solid_glitter,            "Solid Glitter",        4, 0)                               \
+  E (FX_MODE_SUNRISE,               mode_sunrise,                  "Sunrise",             35, 0)                               \
+  E (FX_MODE_PHASED,                mode_phased,                   "Phased",               4, 0)                               \
+  E (FX_MODE_TWINKLEUP,             mode_twinkleup,                "Twinkleup",            4, 0)                               \
+  E (FX_MODE_NOISEPAL,              mode_noisepal,                 "Noise Pal",            4, FX_FLAG_DATA)                    \
+  E (FX_MODE_SINEWAVE,              mode_sinewave,                 "Sine",                 4, 0)                               \
+  E (FX_MODE_PHASEDNOISE,           mode_phased_noise,             "Phased Noise",         4, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_FLOW,                  mode_flow,                     "Flow",                 6, 0)                               \
+  E (FX_MODE_CHUNCHUN,              mode_chunchun,                 "Chunchun",             4, 0)                               \
+  E (FX_MODE_DANCING_SHADOWS,       mode_dancing_shadows,          "Dancing Shadows",      4, FX_FLAG_DATA)                    \
+  E (FX_MODE_WASHING_MACHINE,       mode_washing_machine,          "Washing Machine",      4, 0)                               \
+  E (FX_MODE_CANDY_CANE,            mode_candy_cane,               "Candy Cane",           4, 0)                               \
+  E (FX_MODE_BLENDS,                mode_blends,                   "Blends",               4, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_TV_SIMULATOR,          mode_tv_simulator,             "TV Simulator",         4, FX_FLAG_DATA)                    \
+  E (FX_MODE_DYNAMIC_SMOOTH,        mode_dynamic_smooth,           "Dynamic Smooth",       4, FX_FLAG_DATA_PER_LED)            \
+  E (FX_MODE_EXPRESSION,            mode_expression,               "Expression",           0, FX_FLAG_2D|FX_FLAG_DATA)
+
+#define FX_JSON_NAME0(id, fn, name, pal, flags) "[\"" name "\""
+#define FX_JSON_NAME(id, fn, name, pal, flags)  ",\"" name "\""
+const char JSON_mode_names[] PROGMEM = WLED_EFFECT_LIST(FX_JSON_NAME0, FX_JSON_NAME) "]";
 
 
 const char JSON_palette_names[] PROGMEM = R"=====([
@@ -0,0 +1,128 @@
+/*
+  FX_2D.cpp contains the 2D segment helpers used by effects
+
+  LICENSE
+  The MIT License (MIT)
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+#include "wled.h"
+#include "FX.h"
+
+/*
+ * A segment with a width is a matrix of width x (length / width) LEDs, wired row after row from its start.
+ * Effects draw on a row-major canvas of SEGW x SEGH pixels, XY() turns a canvas position into the
+ * segment pixel index, taking serpentine wiring and transposition into account. Plain matrices therefore
+ * need no ledmap. 2D segments are meant to be used with grouping 1.
+ */
+
+uint16_t WS2812FX::segmentWidth() {
+  if (!SEGMENT.width) return SEGLEN;
+  return (SEGMENT.layout & SEG_LAYOUT_TRANSPOSE) ? SEGMENT.height() : SEGMENT.width;
+}
+
+uint16_t WS2812FX::segmentHeight() {
+  if (!SEGMENT.width) return 1;
+  return (SEGMENT.layout & SEG_LAYOUT_TRANSPOSE) ? SEGMENT.width : SEGMENT.height();
+}
+
+//segment pixel index of canvas position x/y
+uint16_t WS2812FX::XY(uint16_t x, uint16_t y) {
+  uint16_t w = SEGMENT.width;
+  if (!w) return x;
+  if (SEGMENT.layout & SEG_LAYOUT_TRANSPOSE) {
+    uint16_t t = x; x = y; y = t;
+  }
+  if ((SEGMENT.layout & SEG_LAYOUT_SERPENTINE) && (y & 1)) x = w - 1 - x;
+  return y * w + x;
+}
+
+void WS2812FX::setPixelColorXY(uint16_t x, uint16_t y, uint32_t c) {
+  if (x >= SEGW || y >= SEGH) return;
+  setPixelColor(XY(x, y), c);
+}
+
+uint32_t WS2812FX::getPixelColorXY(uint16_t x, uint16_t y) {
+  if (x >= SEGW || y >= SEGH) return 0;
+  return getPixelColor(XY(x, y));
+}
+
+void WS2812FX::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t c) {
+  uint16_t x1 = MIN(x + w, SEGW), y1 = MIN(y + h, SEGH);
+  for (uint16_t j = y; j < y1; j++) {
+    for (uint16_t i = x; i < x1; i++) setPixelColor(XY(i, j), c);
+  }
+}
+
+//Bresenham line, both end points included
+void WS2812FX::drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t c) {
+  int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int16_t err = dx + dy;
+  for (;;) {
+    setPixelColorXY(x0, y0, c);
+    if (x0 == x1 && y0 == y1) break;
+    int16_t e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+//moves the canvas content by dx/dy pixels (positive: right/down), uncovered pixels turn black
+void WS2812FX::shift2D(int16_t dx, int16_t dy) {
+  int16_t w = SEGW, h = SEGH;
+  if ((!dx && !dy) || !w) return;
+  //walk against the shift direction, so every source pixel is read before it is overwritten
+  for (int16_t j = 0; j < h; j++) {
+    int16_t y = (dy > 0) ? h - 1 - j : j;
+    for (int16_t i = 0; i < w; i++) {
+      int16_t x = (dx > 0) ? w - 1 - i : i;
+      int16_t sx = x - dx, sy = y - dy;
+      uint32_t c = (sx >= 0 && sx < w && sy >= 0 && sy < h) ? getPixelColor(XY(sx, sy)) : BLACK;
+      setPixelColor(XY(x, y), c);
+    }
+  }
+}
+
+//same as blur(), along row or column n of the canvas
+void WS2812FX::blurLine2D(uint16_t n, bool column, uint8_t amount) {
+  uint8_t keep = 255 - amount;
+  uint8_t seep = amount >> 1;
+  uint16_t len = column ? SEGH : SEGW;
+  uint32_t carryover = BLACK;
+  uint16_t prev = 0;
+  for (uint16_t i = 0; i < len; i++) {
+    uint16_t idx = column ? XY(n, i) : XY(i, n);
+    uint32_t cur = getPixelColor(idx);
+    uint32_t part = colorScale(cur, seep);
+    cur = colorAdd(colorScale(cur, keep), carryover);
+    if (i > 0) setPixelColor(prev, colorAdd(getPixelColor(prev), part));
+    setPixelColor(idx, cur);
+    carryover = part;
+    prev = idx;
+  }
+}
+
+//blurs rows, then columns
+void WS2812FX::blur2D(uint8_t amount) {
+  if (!IS_2D) {
+    blur(amount);
+    return;
+  }
+  uint16_t w = SEGW, h = SEGH;
+  for (uint16_t y = 0; y < h; y++) blurLine2D(y, false, amount);
+  for (uint16_t x = 0; x < w; x++) blurLine2D(x, true, amount);
+}
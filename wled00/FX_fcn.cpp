@@ -41,6 +41,11 @@
   {"map":[
   0, 1, 2, 3, 4, 9, 8, 7, 6, 5, 10, 11, 12, 13, 14,
   19, 18, 17, 16, 15, 20, 21, 22, 23, 24, 29, 28, 27, 26, 25]}
+
+  matrices can be described instead of listing every LED (see generateLayoutMap()), e.g. a 16x16 serpentine panel:
+  {"layout":{"w":16,"h":16,"serp":true}}
+
+  large maps load faster from "ledmap.bin" (see readBinaryMap()), which is used instead of ledmap.json if present.
 */
 
 //factory defaults LED setup
@@ -115,10 +120,20 @@ void WS2812FX::finalizeInit(void)
 void WS2812FX::service() {
   uint32_t nowUp = millis(); // Be aware, millis() rolls over every 49 days
   now = nowUp + timebase;
+  //effect data of segments trimmed since the last call is freed here, where the effects use it
+  uint8_t num = _segmentsNum;
+  for (uint8_t i = num; i < _segmentsServiced; i++) { _segment_runtimes[i].resetIfRequired(); _segment_runtimes[i].deallocatePixels(); }
+  _segmentsServiced = num;
+  if (_segmentsAllocated > num) resizeSegments(num); //storage of trimmed IDs, retried while a JSON request is applied
   if (nowUp - _lastShow < MIN_SHOW_DELAY) return;
+  #ifndef WLED_DISABLE_FRAME_SKIP //every call walks all segments, the reference for the frame timing test
+  if (nowUp <= _nextFrame && !_triggered) return; //no segment due yet
+  #endif
+  uint32_t frameStart = micros();
   bool doShow = false;
+  uint32_t nextFrame = UINT32_MAX;
 
-  for(uint8_t i=0; i < MAX_NUM_SEGMENTS; i++)
+  for(uint8_t i=0; i < _segmentsNum; i++)
   {
     _segment_index = i;
 
@@ -126,7 +141,8 @@ void WS2812FX::service() {
     // segment's buffers are cleared
     SEGENV.resetIfRequired();
 
-    if (!SEGMENT.isActive()) continue;
+    if (!SEGMENT.isActive()) { SEGENV.deallocatePixels(); continue; }
+    if (cloneSource(i) < _segmentsNum) continue; //copied from its source once all effects ran
 
     if(nowUp > SEGENV.next_time || _triggered || (doShow && SEGMENT.mode == 0)) //last is temporary
     {
@@ -136,12 +152,24 @@ void WS2812FX::service() {
 
       if (!SEGMENT.getOption(SEG_OPTION_FREEZE)) { //only run effect function if not frozen
         _virtualSegmentLength = SEGMENT.virtualLength();
+        //at reduced resolution the effect draws every scale-th pixel into SEGENV.pixels, they are interpolated on output
+        //sources of clones draw into it too, the clones output it with their own settings
+        uint8_t scale = 1;
+        if (SEGMENT.scale > 1 && !IS_2D && _virtualSegmentLength > SEGMENT.scale && (getModeFlags(SEGMENT.mode) & FX_FLAG_SCALABLE)) {
+          scale = MIN(SEGMENT.scale, MAX_RENDER_SCALE);
+        }
+        uint16_t rowLen = (_virtualSegmentLength - 1) / scale + 1; //first and last calculated pixel at most scale-1 apart from the ends
+        if ((scale > 1 || hasClones(i)) && SEGENV.allocatePixels(rowLen, scale)) { //full resolution if there is no memory for it
+          _renderScale = scale;
+          _renderPixels = SEGENV.pixels;
+          _virtualSegmentLength = rowLen;
+        } else SEGENV.deallocatePixels();
         _bri_t = SEGMENT.opacity; _colors_t[0] = SEGMENT.colors[0]; _colors_t[1] = SEGMENT.colors[1]; _colors_t[2] = SEGMENT.colors[2];
         uint8_t _cct_t = SEGMENT.cct;
         if (!IS_SEGMENT_ON) _bri_t = 0;
         for (uint8_t t = 0; t < MAX_NUM_TRANSITIONS; t++) {
-          if ((transitions[t].segment & 0x3F) != i) continue;
-          uint8_t slot = transitions[t].segment >> 6;
+          if (transitions[t].segment != i) continue;
+          uint8_t slot = transitions[t].slot;
           if (slot == 0) _bri_t = transitions[t].currentBri();
           if (slot == 1) _cct_t = transitions[t].currentBri(false, 1);
           _colors_t[slot] = transitions[t].currentColor(SEGMENT.colors[slot]);
@@ -149,22 +177,132 @@ void WS2812FX::service() {
         if (!cctFromRgb || correctWB) busses.setSegmentCCT(_cct_t, correctWB);
         for (uint8_t c = 0; c < 3; c++) _colors_t[c] = gamma32(_colors_t[c]);
         handle_palette();
-        delay = (this->*_mode[SEGMENT.mode])(); //effect function
-        if (SEGMENT.mode != FX_MODE_HALLOWEEN_EYES) SEGENV.call++;
+        delay = (this->*getModeFunction(SEGMENT.mode))(); //effect function
+        if (_renderPixels) {
+          _renderPixels = nullptr;
+          _renderScale = 1;
+          showSegmentPixels(i);
+        }
+        if (!(getModeFlags(SEGMENT.mode) & FX_FLAG_KEEP_CALL)) SEGENV.call++;
       }
 
-      SEGENV.next_time = nowUp + delay;
+      SEGENV.next_time = nowUp + delay + _pacingDelay;
+    }
+    if (SEGENV.next_time < nextFrame) nextFrame = SEGENV.next_time;
+  }
+  if (doShow) {
+    for (uint8_t i = 0; i < _segmentsNum; i++) {
+      uint8_t src = cloneSource(i);
+      if (src >= _segmentsNum || !_segments[i].isActive()) continue;
+      _segment_index = i;
+      copySegment(src);
     }
   }
+  _nextFrame = nextFrame;
   _virtualSegmentLength = 0;
   busses.setSegmentCCT(-1);
   if(doShow) {
+    _effectMicros += micros() - frameStart;
+    _framesRendered++;
     yield();
     show();
+    recordFrameTime(micros() - frameStart);
   }
   _triggered = false;
 }
 
+/*
+ * Adds the time it took to compute and show a frame to the histogram.
+ * If frames take longer than the target frame time, all segments are slowed down
+ * so that the main loop still gets time to handle network traffic.
+ */
+void WS2812FX::recordFrameTime(uint32_t us) {
+  uint16_t ms = us / 1000;
+  if (ms > _frameTimeMax) _frameTimeMax = ms;
+  _frameTimeHist[ms < FRAMETIME_HIST_SIZE ? ms : FRAMETIME_HIST_SIZE -1]++;
+  if (++_frameTimeCount >= 4096) { //age the histogram so it reflects recent frames
+    for (uint8_t i = 0; i < FRAMETIME_HIST_SIZE; i++) _frameTimeHist[i] >>= 1;
+    _frameTimeCount >>= 1;
+  }
+
+  uint16_t overrun = 0;
+  if (ms > _frametime) {
+    _missedFrames++;
+    overrun = ms - _frametime;
+  }
+  if (overrun > _pacingDelay) _pacingDelay = (_pacingDelay + overrun +1) >> 1; //back off quickly
+  else                        _pacingDelay = (3 * _pacingDelay + overrun) >> 2; //recover slowly
+}
+
+//frame time in ms below which p percent of the recent frames were computed and shown
+uint16_t WS2812FX::getFrameTimePercentile(uint8_t p) {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < FRAMETIME_HIST_SIZE; i++) total += _frameTimeHist[i];
+  if (total == 0) return 0;
+  uint32_t rank = (total * p + 99) / 100;
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < FRAMETIME_HIST_SIZE; i++) {
+    sum += _frameTimeHist[i];
+    if (sum >= rank) return i;
+  }
+  return FRAMETIME_HIST_SIZE -1;
+}
+
+uint16_t WS2812FX::getFrameTimeMax() {
+  return _frameTimeMax;
+}
+
+uint32_t WS2812FX::getMissedFrames() {
+  return _missedFrames;
+}
+
+uint32_t WS2812FX::getFramesRendered() {
+  return _framesRendered;
+}
+
+uint32_t WS2812FX::getFramesShown() {
+  return _framesShown;
+}
+
+uint64_t WS2812FX::getEffectMicros() {
+  return _effectMicros;
+}
+
+uint64_t WS2812FX::getShowMicros() {
+  return _showMicros;
+}
+
+//initial random generator state of segment n, the same on all nodes with the same seed and sync epoch
+uint32_t WS2812FX::segmentSeed(uint8_t n) {
+  uint32_t h = rngSeed ^ (_rngEpoch * 0x9E3779B1) ^ ((uint32_t)n << 24 | n);
+  h ^= h >> 16; h *= 0x85EBCA6B; //murmur3 finalizer
+  h ^= h >> 13; h *= 0xC2B2AE35;
+  return h ^ (h >> 16);
+}
+
+/*
+ * Restarts the effects of all segments with fresh random sequences.
+ * Called by the sender and the receivers of a sync notification that changes effects, with the time in the packet,
+ * so that synced nodes running the same effect start from the same state and draw the same random numbers.
+ * Effect state (step, aux0/1, data) is reset too, as it holds the results of earlier random draws.
+ * Pixels are kept, effects that fade or shift continue from what the strip shows.
+ */
+void WS2812FX::reseed(uint32_t epoch) {
+  _rngEpoch = epoch;
+  for (uint8_t i = 0; i < _segmentsNum; i++) _segment_runtimes[i].reset(); //rng is seeded in resetIfRequired()
+}
+
+void WS2812FX::setTargetFps(uint8_t fps) {
+  if (fps == 0) fps = WLED_FPS;
+  if (fps > WLED_FPS_MAX) fps = WLED_FPS_MAX;
+  _targetFps = fps;
+  _frametime = 1000 / fps;
+}
+
+uint8_t WS2812FX::getTargetFps() {
+  return _targetFps;
+}
+
 void WS2812FX::setPixelColor(uint16_t n, uint32_t c) {
   setPixelColor(n, R(c), G(c), B(c), W(c));
 }
@@ -187,8 +325,101 @@ uint16_t WS2812FX::realPixelIndex(uint16_t i) {
   return realIndex;
 }
 
+//source segment a clone shows, 255 if n is no clone or the source can not be shown (inactive or a clone itself)
+uint8_t WS2812FX::cloneSource(uint8_t n) {
+  uint8_t src = _segments[n].clone - 1;
+  if (src >= _segmentsNum || src == n) return 255;
+  if (!_segments[src].isActive() || _segments[src].clone) return 255;
+  return src;
+}
+
+bool WS2812FX::hasClones(uint8_t n) {
+  for (uint8_t i = 0; i < _segmentsNum; i++) {
+    if (_segments[i].isActive() && cloneSource(i) == n) return true;
+  }
+  return false;
+}
+
+/*
+ * Shows the calculated pixels of segment src (before its opacity) on the current segment, which applies its own
+ * grouping, reverse, mirror, offset, opacity and CCT. The effect of src is only calculated once.
+ */
+void WS2812FX::copySegment(uint8_t src) {
+  uint8_t seg = _segment_index;
+  _bri_t = IS_SEGMENT_ON ? SEGMENT.opacity : 0;
+  for (uint8_t t = 0; t < MAX_NUM_TRANSITIONS; t++) {
+    if (transitions[t].segment == seg) _bri_t = transitions[t].currentBri(); //slot 0
+  }
+  if (!cctFromRgb || correctWB) busses.setSegmentCCT(SEGMENT.cct, correctWB);
+  showSegmentPixels(src); //black until the source has drawn its first frame
+}
+
+//Catmull-Rom weights (sum 256) of the pixels before, at, after and 2 after the calculated pixel, at fraction t/256 towards the next
+static void cubicWeights(int16_t* w, uint16_t t)
+{
+  int32_t t2 = (t * t) >> 8, t3 = (t2 * t) >> 8;
+  w[0] = (-t3 + 2*t2 - t) / 2;
+  w[1] = (3*t3 - 5*t2 + 512) / 2;
+  w[2] = (-3*t3 + 4*t2 + t) / 2;
+  w[3] = 256 - w[0] - w[1] - w[2];
+}
+
+static uint32_t cubicBlend(uint32_t p0, uint32_t p1, uint32_t p2, uint32_t p3, const int16_t* w)
+{
+  uint32_t c = 0;
+  for (uint8_t s = 0; s < 32; s += 8) {
+    int32_t v = w[0] * (int32_t)((p0 >> s) & 0xFF) + w[1] * (int32_t)((p1 >> s) & 0xFF)
+              + w[2] * (int32_t)((p2 >> s) & 0xFF) + w[3] * (int32_t)((p3 >> s) & 0xFF);
+    v = (v + 128) >> 8;
+    c |= (uint32_t)(v < 0 ? 0 : v > 255 ? 255 : v) << s;
+  }
+  return c;
+}
+
+/*
+ * Outputs the calculated pixels of segment src (SEGENV.pixels) to the current segment, applying its opacity.
+ * A row rendered at reduced resolution holds every scale-th virtual pixel, the pixels between are interpolated
+ * (linearly or with SEG_OPTION_CUBIC cubically), the tail after the last one repeats it.
+ * The pixels are never read back from the bus, which holds them after brightness and white balance.
+ */
+void WS2812FX::showSegmentPixels(uint8_t src) {
+  Segment_runtime& r = _segment_runtimes[src];
+  const uint32_t* row = r.pixels;
+  uint16_t n = row ? r._pixelsLen : 0;
+  uint8_t k = r._pixelsScale ? r._pixelsScale : 1;
+  uint16_t len = SEGMENT.virtualLength();
+  uint16_t end = MIN(len, _segments[src].virtualLength()); //pixels after the source are black
+  _virtualSegmentLength = len;
+
+  int16_t w[MAX_RENDER_SCALE][4];
+  bool cubic = k > 1 && _segments[src].getOption(SEG_OPTION_CUBIC);
+  if (cubic) for (uint8_t j = 1; j < k; j++) cubicWeights(w[j], (j << 8) / k);
+
+  uint16_t i = 0;
+  for (uint16_t a = 0; a < n && i < end; a++) {
+    uint32_t c0 = row[a];
+    setPixelColor(i++, c0);
+    if (a + 1 == n) { //tail
+      while (i < end) setPixelColor(i++, c0);
+      break;
+    }
+    uint32_t c1 = row[a + 1];
+    if (cubic) {
+      uint32_t cb = row[a ? a - 1 : 0], ca = row[a + 2 < n ? a + 2 : a + 1];
+      for (uint8_t j = 1; j < k && i < end; j++) setPixelColor(i++, cubicBlend(cb, c0, c1, ca, w[j]));
+    } else {
+      for (uint8_t j = 1; j < k && i < end; j++) setPixelColor(i++, color_blend(c0, c1, (j << 8) / k));
+    }
+  }
+  while (i < len) setPixelColor(i++, BLACK);
+}
+
 void WS2812FX::setPixelColor(uint16_t i, byte r, byte g, byte b, byte w)
 {
+  if (_renderPixels) { //output after the effect, see showSegmentPixels()
+    if (i < SEGLEN) _renderPixels[i] = RGBW32(r, g, b, w);
+    return;
+  }
   if (SEGLEN) {//from segment
     uint16_t realIndex = realPixelIndex(i);
     uint16_t len = SEGMENT.length();
@@ -241,6 +472,14 @@ void WS2812FX::setPixelColor(uint16_t i, byte r, byte g, byte b, byte w)
 #define MA_FOR_ESP        100 //how much mA does the ESP use (Wemos D1 about 80mA, ESP32 about 120mA)
                               //you can set it to 0 if the ESP is powered by USB and the LEDs by external
 
+//scale (0-255) needed to bring power down to budget, 255 if within budget
+static uint8_t powerBudgetScale(uint32_t powerBudget, uint32_t power) {
+  if (power <= powerBudget) return 255;
+  float scale = (float)powerBudget / (float)power;
+  uint16_t scaleI = scale * 255;
+  return (scaleI > 255) ? 255 : scaleI;
+}
+
 void WS2812FX::estimateCurrentAndLimitBri() {
   //power limit calculation
   //each LED can draw up 195075 "power units" (approx. 53mA)
@@ -256,6 +495,7 @@ void WS2812FX::estimateCurrentAndLimitBri() {
 
   if (ablMilliampsMax < 150 || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
     currentMilliamps = 0;
+    for (uint8_t b = 0; b < busses.getNumBusses(); b++) busses.getBus(b)->setMilliamps(0);
     busses.setBrightness(_brightness);
     return;
   }
@@ -270,50 +510,51 @@ void WS2812FX::estimateCurrentAndLimitBri() {
   }
 
   uint32_t powerSum = 0;
+  uint32_t busPowerSums[WLED_MAX_BUSSES];
+  uint8_t scaleB = 255; //most restrictive scale of the global and all per-bus budgets
 
   for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
     Bus *bus = busses.getBus(b);
+    busPowerSums[b] = 0;
     if (bus->getType() >= TYPE_NET_DDP_RGB) continue; //exclude non-physical network busses
-    uint16_t len = bus->getLength();
-    uint32_t busPowerSum = 0;
-    for (uint16_t i = 0; i < len; i++) { //sum up the usage of each LED
-      uint32_t c = bus->getPixelColor(i);
-      byte r = R(c), g = G(c), b = B(c), w = W(c);
-
-      if(useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-        busPowerSum += (MAX(MAX(r,g),b)) * 3;
-      } else {
-        busPowerSum += (r + g + b + w);
-      }
-    }
+    uint32_t busPowerSum = bus->getPowerSum(useWackyWS2815PowerModel);
 
     if (bus->isRgbw()) { //RGBW led total output with white LEDs enabled is still 50mA, so each channel uses less
       busPowerSum *= 3;
       busPowerSum = busPowerSum >> 2; //same as /= 4
     }
+    busPowerSums[b] = busPowerSum;
     powerSum += busPowerSum;
-  }
 
-  uint32_t powerSum0 = powerSum;
-  powerSum *= _brightness;
-  
-  if (powerSum > powerBudget) //scale brightness down to stay in current limit
-  {
-    float scale = (float)powerBudget / (float)powerSum;
-    uint16_t scaleI = scale * 255;
-    uint8_t scaleB = (scaleI > 255) ? 255 : scaleI;
-    uint8_t newBri = scale8(_brightness, scaleB);
-    busses.setBrightness(newBri); //to keep brightness uniform, sets virtual busses too
-    currentMilliamps = (powerSum0 * newBri) / puPerMilliamp;
-  } else {
-    currentMilliamps = powerSum / puPerMilliamp;
-    busses.setBrightness(_brightness);
+    //bus with its own power supply
+    uint16_t busMaxPower = bus->getMaxPower();
+    if (busMaxPower) {
+      uint16_t len = bus->getLength();
+      uint32_t busBudget = (busMaxPower > len) ? (busMaxPower - len) * puPerMilliamp : 0; //standby power excluded
+      uint8_t busScale = powerBudgetScale(busBudget, busPowerSum * _brightness);
+      if (busScale < scaleB) scaleB = busScale;
+    }
   }
+
+  uint8_t globalScale = powerBudgetScale(powerBudget, powerSum * _brightness);
+  if (globalScale < scaleB) scaleB = globalScale;
+
+  //scale brightness down to stay in current limit
+  uint8_t newBri = (scaleB < 255) ? scale8(_brightness, scaleB) : _brightness;
+  busses.setBrightness(newBri); //to keep brightness uniform, sets virtual busses too
+  currentMilliamps = (powerSum * newBri) / puPerMilliamp;
   currentMilliamps += MA_FOR_ESP; //add power of ESP back to estimate
   currentMilliamps += pLen; //add standby power back to estimate
+
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
+    Bus *bus = busses.getBus(b);
+    if (bus->getType() >= TYPE_NET_DDP_RGB) continue;
+    bus->setMilliamps((busPowerSums[b] * newBri) / puPerMilliamp + bus->getLength());
+  }
 }
 
 void WS2812FX::show(void) {
+  uint32_t showStart = micros();
 
   // avoid race condition, caputre _callback value
   show_callback callback = _callback;
@@ -331,6 +572,8 @@ void WS2812FX::show(void) {
   if (diff > 0) fpsCurr = 1000 / diff;
   _cumulativeFps = (3 * _cumulativeFps + fpsCurr) >> 2;
   _lastShow = now;
+  _framesShown++;
+  _showMicros += micros() - showStart;
 }
 
 /**
@@ -350,6 +593,19 @@ uint16_t WS2812FX::getFps() {
   return _cumulativeFps +1;
 }
 
+/**
+ * Returns the time in ms until service() has the next frame to compute (capped at 1s), 0 if one is due.
+ * Can be used to sleep or do other work in the meantime.
+ */
+uint16_t WS2812FX::timeToNextFrame() {
+  if (_triggered) return 0;
+  uint32_t nowUp = millis();
+  uint32_t next = _lastShow + MIN_SHOW_DELAY;
+  if (_nextFrame >= next) next = (_nextFrame == UINT32_MAX) ? UINT32_MAX : _nextFrame + 1; //segments are due once millis() exceeds next_time
+  if (nowUp >= next) return 0;
+  return (next - nowUp > 1000) ? 1000 : next - nowUp;
+}
+
 /**
  * Forces the next frame to be computed on all active segments.
  */
@@ -358,7 +614,7 @@ void WS2812FX::trigger() {
 }
 
 void WS2812FX::setMode(uint8_t segid, uint8_t m) {
-  if (segid >= MAX_NUM_SEGMENTS) return;
+  if (segid >= _segmentsNum) return;
    
   if (m >= MODE_COUNT) m = MODE_COUNT - 1;
 
@@ -374,6 +630,34 @@ uint8_t WS2812FX::getModeCount()
   return MODE_COUNT;
 }
 
+//effect registry lookups (_effects is in flash)
+WS2812FX::mode_ptr WS2812FX::getModeFunction(uint8_t m)
+{
+  mode_ptr fn;
+  if (m >= MODE_COUNT) m = 0;
+  memcpy_P(&fn, &_effects[m].fn, sizeof(fn));
+  return fn;
+}
+
+uint8_t WS2812FX::getModeDefaultPalette(uint8_t m)
+{
+  if (m >= MODE_COUNT) return 0;
+  return pgm_read_byte(&_effects[m].palette);
+}
+
+uint8_t WS2812FX::getModeFlags(uint8_t m)
+{
+  if (m >= MODE_COUNT) return 0;
+  return pgm_read_byte(&_effects[m].flags);
+}
+
+//mode at position pos of the alphabetical list
+uint8_t WS2812FX::getModeSortIndex(uint8_t pos)
+{
+  if (pos >= MODE_COUNT) return 0;
+  return pgm_read_byte(&_modeSortOrder[pos]);
+}
+
 uint8_t WS2812FX::getPaletteCount()
 {
   return 13 + GRADIENT_PALETTE_COUNT;
@@ -389,7 +673,7 @@ bool WS2812FX::setEffectConfig(uint8_t m, uint8_t s, uint8_t in, uint8_t p) {
   bool applied = false;
   
   if (applyToAllSelected) {
-    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+    for (uint8_t i = 0; i < _segmentsNum; i++)
     {
       if (_segments[i].isSelected())
       {
@@ -423,7 +707,7 @@ void WS2812FX::setColor(uint8_t slot, uint32_t c) {
   bool applied = false;
   
   if (applyToAllSelected) {
-    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+    for (uint8_t i = 0; i < _segmentsNum; i++)
     {
       if (_segments[i].isSelected()) {
         _segments[i].setColor(slot, c, i);
@@ -443,7 +727,7 @@ void WS2812FX::setBrightness(uint8_t b) {
   if (_brightness == b) return;
   _brightness = b;
   if (_brightness == 0) { //unfreeze all segments on power off
-    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+    for (uint8_t i = 0; i < _segmentsNum; i++)
     {
       _segments[i].setOption(SEG_OPTION_FREEZE, false);
     }
@@ -482,18 +766,22 @@ uint8_t WS2812FX::getMaxSegments(void) {
 }*/
 
 uint8_t WS2812FX::getMainSegmentId(void) {
-  if (mainSegment >= MAX_NUM_SEGMENTS) return 0;
-  if (_segments[mainSegment].isActive()) return mainSegment;
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) //get first active
+  if (mainSegment < _segmentsNum && _segments[mainSegment].isActive()) return mainSegment;
+  for (uint8_t i = 0; i < _segmentsNum; i++) //get first active
   {
     if (_segments[i].isActive()) return i;
   }
   return 0;
 }
 
+//number of segment IDs that have storage (active or not)
+uint8_t WS2812FX::getSegmentsNum(void) {
+  return _segmentsNum;
+}
+
 uint8_t WS2812FX::getActiveSegmentsNum(void) {
   uint8_t c = 0;
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t i = 0; i < _segmentsNum; i++)
   {
     if (_segments[i].isActive()) c++;
   }
@@ -506,6 +794,7 @@ uint32_t WS2812FX::getColor(void) {
 
 uint32_t WS2812FX::getPixelColor(uint16_t i)
 {
+  if (_renderPixels) return i < SEGLEN ? _renderPixels[i] : 0;
   i = realPixelIndex(i);
 
   if (SEGLEN) {
@@ -520,8 +809,12 @@ uint32_t WS2812FX::getPixelColor(uint16_t i)
   return busses.getPixelColor(i);
 }
 
+//IDs without storage return an inactive placeholder, changes to it are discarded
 WS2812FX::Segment& WS2812FX::getSegment(uint8_t id) {
-  if (id >= MAX_NUM_SEGMENTS) return _segments[0];
+  if (id >= _segmentsNum) {
+    memset(&_noSegment, 0, sizeof(_noSegment));
+    return _noSegment;
+  }
   return _segments[id];
 }
 
@@ -529,6 +822,135 @@ WS2812FX::Segment_runtime WS2812FX::getSegmentRuntime(void) {
   return SEGENV;
 }
 
+/*
+ * Segment effect data arena
+ * All SEGENV.data blocks live in one buffer, so cycling through effects does not fragment the heap.
+ * Blocks are placed at the top, freed blocks leave holes that are closed by moving the remaining
+ * blocks down (and updating their owners' data pointers) once the top is reached.
+ * The buffer grows in SEGMENT_DATA_CHUNK steps up to MAX_SEGMENT_DATA as effects need more, shrinks
+ * when much of it is unused and is freed when no effect uses data, so no memory is reserved up front.
+ * Effects fetch SEGENV.data on every call, so moving is safe.
+ */
+byte* WS2812FX::allocateSegmentData(uint16_t len) {
+  uint16_t alen = SEGMENT_DATA_ALIGN(len);
+  if (!alen) return nullptr;
+  if (_usedSegmentData + alen > MAX_SEGMENT_DATA) { //not enough memory
+    _segmentDataFails++;
+    return nullptr;
+  }
+  if (_segmentDataTop + alen > _segmentDataSize) compactSegmentData();
+  if (_segmentDataTop + alen > _segmentDataSize) {
+    uint32_t size = ((uint32_t)_segmentDataTop + alen + SEGMENT_DATA_CHUNK - 1) / SEGMENT_DATA_CHUNK * SEGMENT_DATA_CHUNK;
+    if (!resizeSegmentData(MIN(size, MAX_SEGMENT_DATA))) { //allocation failed
+      _segmentDataFails++;
+      return nullptr;
+    }
+  }
+
+  byte* p = _segmentData + _segmentDataTop;
+  _segmentDataTop += alen;
+  _usedSegmentData += alen;
+  if (_usedSegmentData > _segmentDataPeak) _segmentDataPeak = _usedSegmentData;
+  return p;
+}
+
+void WS2812FX::freeSegmentData(byte* p, uint16_t len) {
+  _usedSegmentData -= SEGMENT_DATA_ALIGN(len);
+  //lower the top to the end of the highest remaining block
+  uint16_t top = 0;
+  for (uint8_t i = 0; i < _segmentsNum; i++) {
+    Segment_runtime& r = _segment_runtimes[i];
+    if (r.data == p) r.data = nullptr; //not moved or kept by compaction, the owner clears it anyway
+    if (!r.data) continue;
+    uint16_t end = (r.data - _segmentData) + SEGMENT_DATA_ALIGN(r._dataLen);
+    if (end > top) top = end;
+  }
+  _segmentDataTop = top;
+
+  //give memory back once more than two chunks are unused
+  if (!_usedSegmentData) resizeSegmentData(0);
+  else if (_segmentDataSize - _usedSegmentData > 2 * SEGMENT_DATA_CHUNK) {
+    compactSegmentData();
+    resizeSegmentData((_segmentDataTop + SEGMENT_DATA_CHUNK - 1) / SEGMENT_DATA_CHUNK * SEGMENT_DATA_CHUNK + SEGMENT_DATA_CHUNK);
+  }
+}
+
+//moves the arena to a buffer of the given size (0 frees it), the blocks must fit below size
+bool WS2812FX::resizeSegmentData(uint16_t size) {
+  if (size == _segmentDataSize) return true;
+  if (!size) {
+    free(_segmentData);
+    _segmentData = nullptr;
+    _segmentDataSize = _segmentDataTop = 0;
+    return true;
+  }
+  byte* arena;
+  // if possible use SPI RAM on ESP32
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+  if (psramFound())
+    arena = (byte*) ps_realloc(_segmentData, size);
+  else
+  #endif
+    arena = (byte*) realloc(_segmentData, size);
+  if (!arena) return false; //the old buffer is still valid
+  for (uint8_t i = 0; i < _segmentsNum; i++) {
+    Segment_runtime& r = _segment_runtimes[i];
+    if (r.data) r.data = arena + (r.data - _segmentData);
+  }
+  _segmentData = arena;
+  _segmentDataSize = size;
+  return true;
+}
+
+//moves all blocks to the start of the arena in address order, closing the holes between them
+void WS2812FX::compactSegmentData() {
+  uint16_t top = 0;
+  while (true) {
+    Segment_runtime* next = nullptr; //lowest block not yet moved
+    for (uint8_t i = 0; i < _segmentsNum; i++) {
+      Segment_runtime& r = _segment_runtimes[i];
+      if (!r.data || r.data < _segmentData + top) continue;
+      if (!next || r.data < next->data) next = &r;
+    }
+    if (!next) break;
+    uint16_t alen = SEGMENT_DATA_ALIGN(next->_dataLen);
+    if (next->data != _segmentData + top) {
+      memmove(_segmentData + top, next->data, alen);
+      next->data = _segmentData + top;
+    }
+    top += alen;
+  }
+  _segmentDataTop = top;
+  _segmentDataCompactions++;
+}
+
+uint16_t WS2812FX::getSegmentDataUsed() {
+  return _usedSegmentData;
+}
+
+uint16_t WS2812FX::getSegmentDataPeak() {
+  return _segmentDataPeak;
+}
+
+uint16_t WS2812FX::getSegmentDataSize() {
+  return _segmentDataSize;
+}
+
+//percentage of free segment data memory that is in holes below the top (needs compaction before it can be used)
+uint16_t WS2812FX::getSegmentDataFragmentation() {
+  uint16_t free = MAX_SEGMENT_DATA - _usedSegmentData;
+  if (!free) return 0;
+  return ((uint32_t)(_segmentDataTop - _usedSegmentData) * 100) / free;
+}
+
+uint32_t WS2812FX::getSegmentDataCompactions() {
+  return _segmentDataCompactions;
+}
+
+uint32_t WS2812FX::getSegmentDataFails() {
+  return _segmentDataFails;
+}
+
 WS2812FX::Segment* WS2812FX::getSegments(void) {
   return _segments;
 }
@@ -566,8 +988,13 @@ bool WS2812FX::hasCCTBus(void) {
 }
 
 void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping, uint8_t spacing, uint16_t offset) {
-  if (n >= MAX_NUM_SEGMENTS) return;
+  if (n >= _segmentsNum && i2 <= i1) return; //nothing to delete
+  if (!ensureSegment(n)) return;
   Segment& seg = _segments[n];
+  if (i2 <= i1 && !seg.isActive()) { //already deleted, only the IDs in use are trimmed
+    while (_segmentsNum > 1 && !_segments[_segmentsNum -1].isActive()) initSegment(--_segmentsNum);
+    return;
+  }
 
   //return if neither bounds nor grouping have changed
   if (seg.start == i1 && seg.stop == i2
@@ -577,14 +1004,11 @@ void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping,
   if (seg.stop) setRange(seg.start, seg.stop -1, 0); //turn old segment range off
   if (i2 <= i1) //disable segment
   {
-    seg.stop = 0;
-    if (seg.name) {
-      delete[] seg.name;
-      seg.name = nullptr;
-    }
+    initSegment(n); //a segment created with this ID later starts from the defaults
+    while (_segmentsNum > 1 && !_segments[_segmentsNum -1].isActive()) initSegment(--_segmentsNum);
     if (n == mainSegment) //if main segment is deleted, set first active as main segment
     {
-      for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+      for (uint8_t i = 0; i < _segmentsNum; i++)
       {
         if (_segments[i].isActive()) {
           mainSegment = i;
@@ -607,11 +1031,11 @@ void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping,
 }
 
 void WS2812FX::resetSegments() {
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) if (_segments[i].name) delete _segments[i].name;
   mainSegment = 0;
-  memset(_segments, 0, sizeof(_segments));
-  //memset(_segment_runtimes, 0, sizeof(_segment_runtimes));
   _segment_index = 0;
+  for (uint8_t i = 0; i < _segmentsAllocated; i++) initSegment(i);
+  _segmentsNum = 0;
+  if (!ensureSegment(0)) return; //storage beyond the first segment is freed in service()
   _segments[0].mode = DEFAULT_MODE;
   _segments[0].colors[0] = DEFAULT_COLOR;
   _segments[0].start = 0;
@@ -623,25 +1047,90 @@ void WS2812FX::resetSegments() {
   _segments[0].setOption(SEG_OPTION_ON, 1);
   _segments[0].opacity = 255;
   _segments[0].cct = 127;
+  _segment_runtimes[0].reset();
+}
 
-  for (uint16_t i = 1; i < MAX_NUM_SEGMENTS; i++)
-  {
-    _segments[i].colors[0] = color_wheel(i*51);
-    _segments[i].grouping = 1;
-    _segments[i].setOption(SEG_OPTION_ON, 1);
-    _segments[i].opacity = 255;
-    _segments[i].cct = 127;
-    _segments[i].speed = DEFAULT_SPEED;
-    _segments[i].intensity = DEFAULT_INTENSITY;
-    _segment_runtimes[i].reset();
+/*
+ * Segment storage
+ * Segments are kept in heap arrays sized to the highest ID in use. Only the loop moves them, under the JSON
+ * buffer lock, so a JSON request applied from a network callback never holds a segment that is moved.
+ * Callbacks use useSegment(), which never allocates, and queue segments without storage (queueSegment()).
+ * Deleting the last segments lowers the count right away, their storage is freed in service().
+ */
+//do not call this method from system context (network callback)
+bool WS2812FX::ensureSegment(uint8_t n) {
+  if (useSegment(n)) return true;
+  if (n >= MAX_NUM_SEGMENTS || !resizeSegments(n +1)) return false;
+  _segmentsNum = n +1;
+  return true;
+}
+
+//marks the ID as in use if it has storage, safe from any context
+bool WS2812FX::useSegment(uint8_t n) {
+  if (n >= _segmentsAllocated) return false;
+  if (n >= _segmentsNum) _segmentsNum = n +1;
+  return true;
+}
+
+//grows or shrinks the storage to num IDs (at least the ones in use), new IDs get the defaults
+//fails while a JSON request is applied, which may hold a segment
+bool WS2812FX::resizeSegments(uint8_t num) {
+  if (num < _segmentsNum) num = _segmentsNum;
+  if (!num) num = 1;
+  if (num == _segmentsAllocated) return true;
+  bool locked = (_segments != nullptr); //the first allocation is from the constructor
+  if (locked && (jsonBufferLock || !requestJSONBufferLock(18))) return false;
+
+  for (uint8_t i = num; i < _segmentsAllocated; i++) {
+    initSegment(i); //frees the name, drops transitions
+    _segment_runtimes[i].deallocateData();
+    _segment_runtimes[i].deallocatePixels();
+  }
+  if (num < _segmentsAllocated) _segmentsAllocated = num; //the removed IDs are gone even if realloc fails
+  if (_segmentsServiced > _segmentsAllocated) _segmentsServiced = _segmentsAllocated;
+  if (mainSegment >= _segmentsAllocated) mainSegment = 0;
+
+  segment* segs = (segment*) realloc(_segments, num * sizeof(segment));
+  if (segs) _segments = segs;
+  segment_runtime* runtimes = segs ? (segment_runtime*) realloc(_segment_runtimes, num * sizeof(segment_runtime)) : nullptr;
+  if (runtimes) {
+    _segment_runtimes = runtimes;
+    for (uint8_t i = _segmentsAllocated; i < num; i++) {
+      memset(&_segments[i], 0, sizeof(segment));
+      memset(&_segment_runtimes[i], 0, sizeof(segment_runtime));
+      initSegment(i);
+    }
+    _segmentsAllocated = num;
+  }
+  if (locked) releaseJSONBufferLock();
+  return runtimes != nullptr;
+}
+
+//defaults of a newly created (inactive) segment
+void WS2812FX::initSegment(uint8_t n) {
+  Segment& seg = _segments[n];
+  if (seg.name) delete[] seg.name;
+  memset(&seg, 0, sizeof(segment));
+  uint8_t pos = 255 - (uint8_t)(n*51); //color wheel, not using the palette of the current segment
+  if (pos < 85)       seg.colors[0] = RGBW32(255 - pos * 3, 0, pos * 3, 0);
+  else if (pos < 170) seg.colors[0] = RGBW32(0, (pos - 85) * 3, 255 - (pos - 85) * 3, 0);
+  else                seg.colors[0] = RGBW32((pos - 170) * 3, 255 - (pos - 170) * 3, 0, 0);
+  seg.grouping = 1;
+  seg.setOption(SEG_OPTION_ON, 1);
+  seg.opacity = 255;
+  seg.cct = 127;
+  seg.speed = DEFAULT_SPEED;
+  seg.intensity = DEFAULT_INTENSITY;
+  _segment_runtimes[n].reset(); //effect data is freed in service()
+  for (uint8_t t = 0; t < MAX_NUM_TRANSITIONS; t++) {
+    if (transitions[t].segment == n) transitions[t].segment = 0xFF;
   }
-  _segment_runtimes[0].reset();
 }
 
 void WS2812FX::makeAutoSegments() {
   if (autoSegments) { //make one segment per bus
-    uint16_t segStarts[MAX_NUM_SEGMENTS] = {0};
-    uint16_t segStops [MAX_NUM_SEGMENTS] = {0};
+    uint16_t segStarts[WLED_MAX_BUSSES] = {0};
+    uint16_t segStops [WLED_MAX_BUSSES] = {0};
     uint8_t s = 0;
     for (uint8_t i = 0; i < busses.getNumBusses(); i++) {
       Bus* b = busses.getBus(i);
@@ -660,9 +1149,8 @@ void WS2812FX::makeAutoSegments() {
       }
       s++;
     }
-    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
-      setSegment(i, segStarts[i], segStops[i]);
-    }
+    for (uint8_t i = 0; i < s; i++) setSegment(i, segStarts[i], segStops[i]);
+    for (uint8_t i = _segmentsNum; i > s; i--) setSegment(i -1, 0, 0); //delete the others
   } else {
     //expand the main seg to the entire length, but only if there are no other segments
     uint8_t mainSeg = getMainSegmentId();
@@ -677,7 +1165,7 @@ void WS2812FX::makeAutoSegments() {
 
 void WS2812FX::fixInvalidSegments() {
   //make sure no segment is longer than total (sanity check)
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t i = 0; i < _segmentsNum; i++)
   {
     if (_segments[i].start >= _length) setSegment(i, 0, 0); 
     if (_segments[i].stop  >  _length) setSegment(i, _segments[i].start, _length);
@@ -686,7 +1174,7 @@ void WS2812FX::fixInvalidSegments() {
 
 //true if all segments align with a bus, or if a segment covers the total length
 bool WS2812FX::checkSegmentAlignment() {
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t i = 0; i < _segmentsNum; i++)
   {
     if (_segments[i].start >= _segments[i].stop) continue; //inactive segment
     bool aligned = false;
@@ -711,7 +1199,7 @@ bool _ps_set = false;
 
 void WS2812FX::setPixelSegment(uint8_t n)
 {
-  if (n < MAX_NUM_SEGMENTS) {
+  if (n < _segmentsNum) {
 		#ifdef ARDUINO_ARCH_ESP32
 		if (!_ps_set) {
 			_segment_index_prev = _segment_index;
@@ -757,7 +1245,7 @@ void WS2812FX::setTransition(uint16_t t)
 void WS2812FX::setTransitionMode(bool t)
 {
 	unsigned long waitMax = millis() + 20; //refresh after 20 ms if transition enabled
-  for (uint16_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint16_t i = 0; i < _segmentsNum; i++)
   {
     _segments[i].setOption(SEG_OPTION_TRANSITIONAL, t);
 
@@ -773,24 +1261,7 @@ uint32_t WS2812FX::color_blend(uint32_t color1, uint32_t color2, uint16_t blend,
   if(blend == 0)   return color1;
   uint16_t blendmax = b16 ? 0xFFFF : 0xFF;
   if(blend == blendmax) return color2;
-  uint8_t shift = b16 ? 16 : 8;
-
-  uint32_t w1 = W(color1);
-  uint32_t r1 = R(color1);
-  uint32_t g1 = G(color1);
-  uint32_t b1 = B(color1);
-
-  uint32_t w2 = W(color2);
-  uint32_t r2 = R(color2);
-  uint32_t g2 = G(color2);
-  uint32_t b2 = B(color2);
-
-  uint32_t w3 = ((w2 * blend) + (w1 * (blendmax - blend))) >> shift;
-  uint32_t r3 = ((r2 * blend) + (r1 * (blendmax - blend))) >> shift;
-  uint32_t g3 = ((g2 * blend) + (g1 * (blendmax - blend))) >> shift;
-  uint32_t b3 = ((b2 * blend) + (b1 * (blendmax - blend))) >> shift;
-
-  return RGBW32(r3, g3, b3, w3);
+  return b16 ? colorBlend<true>(color1, color2, blend) : colorBlend<false>(color1, color2, blend);
 }
 
 /*
@@ -815,33 +1286,11 @@ void WS2812FX::blendPixelColor(uint16_t n, uint32_t color, uint8_t blend)
  */
 void WS2812FX::fade_out(uint8_t rate) {
   rate = (255-rate) >> 1;
-  float mappedRate = float(rate) +1.1;
-
-  uint32_t color = SEGCOLOR(1); // target color
-  int w2 = W(color);
-  int r2 = R(color);
-  int g2 = G(color);
-  int b2 = B(color);
+  uint8_t amount = 2550 / (10 * rate + 11); //1/(rate+1.1) of the difference per call
 
+  uint32_t target = SEGCOLOR(1);
   for(uint16_t i = 0; i < SEGLEN; i++) {
-    color = getPixelColor(i);
-    int w1 = W(color);
-    int r1 = R(color);
-    int g1 = G(color);
-    int b1 = B(color);
-
-    int wdelta = (w2 - w1) / mappedRate;
-    int rdelta = (r2 - r1) / mappedRate;
-    int gdelta = (g2 - g1) / mappedRate;
-    int bdelta = (b2 - b1) / mappedRate;
-
-    // if fade isn't complete, make sure delta is at least 1 (fixes rounding issues)
-    wdelta += (w2 == w1) ? 0 : (w2 > w1) ? 1 : -1;
-    rdelta += (r2 == r1) ? 0 : (r2 > r1) ? 1 : -1;
-    gdelta += (g2 == g1) ? 0 : (g2 > g1) ? 1 : -1;
-    bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
-
-    setPixelColor(i, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    setPixelColor(i, colorFadeToward(getPixelColor(i), target, amount));
   }
 }
 
@@ -852,22 +1301,14 @@ void WS2812FX::blur(uint8_t blur_amount)
 {
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
-  CRGB carryover = CRGB::Black;
+  uint32_t carryover = BLACK;
   for(uint16_t i = 0; i < SEGLEN; i++)
   {
-    CRGB cur = col_to_crgb(getPixelColor(i));
-    CRGB part = cur;
-    part.nscale8(seep);
-    cur.nscale8(keep);
-    cur += carryover;
-    if(i > 0) {
-      uint32_t c = getPixelColor(i-1);
-      uint8_t r = R(c);
-      uint8_t g = G(c);
-      uint8_t b = B(c);
-      setPixelColor(i-1, qadd8(r, part.red), qadd8(g, part.green), qadd8(b, part.blue));
-    }
-    setPixelColor(i,cur.red, cur.green, cur.blue);
+    uint32_t cur = getPixelColor(i);
+    uint32_t part = colorScale(cur, seep);
+    cur = colorAdd(colorScale(cur, keep), carryover);
+    if(i > 0) setPixelColor(i-1, colorAdd(getPixelColor(i-1), part));
+    setPixelColor(i, cur);
     carryover = part;
   }
 }
@@ -979,27 +1420,11 @@ void WS2812FX::handle_palette(void)
   _segment_index_palette_last = _segment_index;
 
   byte paletteIndex = SEGMENT.palette;
-  if (paletteIndex == 0) //default palette. Differs depending on effect
-  {
-    switch (SEGMENT.mode)
-    {
-      case FX_MODE_FIRE_2012  : paletteIndex = 35; break; //heat palette
-      case FX_MODE_COLORWAVES : paletteIndex = 26; break; //landscape 33
-      case FX_MODE_FILLNOISE8 : paletteIndex =  9; break; //ocean colors
-      case FX_MODE_NOISE16_1  : paletteIndex = 20; break; //Drywet
-      case FX_MODE_NOISE16_2  : paletteIndex = 43; break; //Blue cyan yellow
-      case FX_MODE_NOISE16_3  : paletteIndex = 35; break; //heat palette
-      case FX_MODE_NOISE16_4  : paletteIndex = 26; break; //landscape 33
-      case FX_MODE_GLITTER    : paletteIndex = 11; break; //rainbow colors
-      case FX_MODE_SUNRISE    : paletteIndex = 35; break; //heat palette
-      case FX_MODE_FLOW       : paletteIndex =  6; break; //party
-    }
-  }
-  if (SEGMENT.mode >= FX_MODE_METEOR && paletteIndex == 0) paletteIndex = 4;
+  if (paletteIndex == 0) paletteIndex = getModeDefaultPalette(SEGMENT.mode); //default palette, differs depending on effect
   
   switch (paletteIndex)
   {
-    case 0: //default palette. Exceptions for specific effects above
+    case 0: //default palette, unless the effect has another one in the registry
       targetPalette = PartyColors_p; break;
     case 1: {//periodically replace palette with a random one. Doesn't work with multiple FastLED segments
       if (!singleSegmentMode)
@@ -1097,13 +1522,126 @@ uint32_t WS2812FX::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8
 }
 
 
-//load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
+//binary ledmap: "WLMP", entry count (uint16), 2 reserved bytes, then the entries (uint16), all little endian
+#define LEDMAP_BIN_HEADER 8
+#define LEDMAP_CHUNK    256 //bytes read from the file at once
+
+static uint16_t* readBinaryMap(File& f, uint16_t& size)
+{
+  uint8_t hdr[LEDMAP_BIN_HEADER];
+  if (f.read(hdr, LEDMAP_BIN_HEADER) != LEDMAP_BIN_HEADER || memcmp_P(hdr, PSTR("WLMP"), 4)) return nullptr;
+  size = hdr[4] | (hdr[5] << 8);
+  if (!size || f.size() < LEDMAP_BIN_HEADER + size * 2u) return nullptr;
+  uint16_t* map = new uint16_t[size];
+  if (map == nullptr) return nullptr;
+
+  //the ESPs are little endian as well, so entries are read straight into the table
+  uint8_t* p = (uint8_t*)map;
+  size_t left = size * 2u;
+  while (left) {
+    size_t n = f.read(p, left > LEDMAP_CHUNK ? LEDMAP_CHUNK : left);
+    if (!n) {
+      delete[] map;
+      return nullptr;
+    }
+    p += n; left -= n;
+  }
+  return map;
+}
+
+//parses the numbers of a JSON array up to the closing bracket, only counts them if map is null
+static uint16_t parseJsonMap(File& f, uint16_t* map, uint16_t size)
+{
+  uint8_t buf[LEDMAP_CHUNK];
+  uint16_t i = 0;
+  uint32_t v = 0;
+  bool inNum = false, neg = false;
+  size_t n;
+  while ((n = f.read(buf, sizeof(buf))) > 0) {
+    for (size_t j = 0; j < n; j++) {
+      uint8_t c = buf[j];
+      if (c >= '0' && c <= '9') {
+        v = v * 10 + c - '0';
+        inNum = true;
+        continue;
+      }
+      if (inNum) {
+        if (map) map[i] = neg ? -v : v; //negative entries wrap as before (-1 = 65535)
+        if (++i == size && map) return i;
+        v = 0; inNum = false; neg = false;
+      }
+      if (c == '-') neg = true;
+      if (c == ']') return i;
+    }
+  }
+  return i;
+}
+
+//reads the "map" array of a JSON ledmap without the JSON buffer, so its size is not limited by it
+static uint16_t* readJsonMap(File& f, uint16_t& size)
+{
+  size_t start = f.position();
+  size = parseJsonMap(f, nullptr, UINT16_MAX);
+  if (!size) return nullptr;
+  uint16_t* map = new uint16_t[size];
+  if (map == nullptr) return nullptr;
+  f.seek(start);
+  parseJsonMap(f, map, size);
+  return map;
+}
+
+/*
+ * Generates the table for a matrix of one or more panels, so it does not need to be stored.
+ * ledmap file {"layout":{"w":16,"h":16,"pw":2,"ph":1,"serp":true,"pserp":false,"rot":90,"fx":false,"fy":false}}
+ * w/h: LEDs per panel, pw/ph: panels, serp: rows in a panel are wired back and forth,
+ * pserp: same for rows of panels, rot: 0/90/180/270 degrees clockwise, fx/fy: mirror horizontally/vertically
+ */
+static uint16_t* generateLayoutMap(JsonObject lo, uint16_t& size)
+{
+  uint16_t w  = lo["w"] | 0,       h  = lo["h"] | 0;
+  uint16_t pw = lo[F("pw")] | 1,   ph = lo[F("ph")] | 1;
+  bool serp   = lo[F("serp")],     pserp = lo[F("pserp")];
+  bool flipX  = lo[F("fx")],       flipY = lo[F("fy")];
+  uint8_t rot = ((lo[F("rot")] | 0) % 360) / 90;
+  uint32_t width = w * pw, height = h * ph;
+  if (!width || !height || width * height > UINT16_MAX) return nullptr;
+
+  size = width * height;
+  uint16_t* map = new uint16_t[size];
+  if (map == nullptr) return nullptr;
+  uint16_t lw = (rot & 1) ? height : width; //logical size after rotation
+  uint16_t lh = (rot & 1) ? width : height;
+  for (uint16_t ly = 0; ly < lh; ly++) {
+    for (uint16_t lx = 0; lx < lw; lx++) {
+      uint16_t x = flipX ? lw - 1 - lx : lx;
+      uint16_t y = flipY ? lh - 1 - ly : ly;
+      uint16_t px, py; //position on the physical matrix
+      switch (rot) {
+        case 1:  px = y;             py = height - 1 - x; break;
+        case 2:  px = width - 1 - x; py = height - 1 - y; break;
+        case 3:  px = width - 1 - y; py = x;              break;
+        default: px = x;             py = y;
+      }
+      uint16_t panelRow = py / h, panelCol = px / w;
+      if (pserp && (panelRow & 1)) panelCol = pw - 1 - panelCol;
+      uint16_t cx = px % w, cy = py % h;
+      if (serp && (cy & 1)) cx = w - 1 - cx;
+      map[ly * lw + lx] = (panelRow * pw + panelCol) * w * h + cy * w + cx;
+    }
+  }
+  return map;
+}
+
+//load custom mapping table from /ledmapN.bin or /ledmapN.json (called from finalizeInit() or deserializeState())
 void WS2812FX::deserializeMap(uint8_t n) {
   char fileName[32];
   strcpy_P(fileName, PSTR("/ledmap"));
   if (n) sprintf(fileName +7, "%d", n);
-  strcat(fileName, ".json");
-  bool isFile = WLED_FS.exists(fileName);
+  char* ext = fileName + strlen(fileName);
+  strcpy_P(ext, PSTR(".bin"));
+  bool isBinary = WLED_FS.exists(fileName);
+  if (!isBinary) strcpy_P(ext, PSTR(".json"));
+  bool isFile = isBinary || WLED_FS.exists(fileName);
 
   if (!isFile) {
     // erase custom mapping if selecting nonexistent ledmap.json (n==0)
@@ -1115,19 +1653,36 @@ void WS2812FX::deserializeMap(uint8_t n) {
     return;
   }
 
-  #ifdef WLED_USE_DYNAMIC_JSON
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-  #else
-  if (!requestJSONBufferLock(7)) return;
-  #endif
-
   DEBUG_PRINT(F("Reading LED map from "));
   DEBUG_PRINTLN(fileName);
 
-  if (!readObjectFromFile(fileName, nullptr, &doc)) {
+  File f = WLED_FS.open(fileName, "r");
+  if (!f) return;
+  f.setTimeout(0); //find() must not wait for more data at the end of the file
+
+  uint16_t size = 0;
+  uint16_t* map = nullptr;
+  if (isBinary) {
+    map = readBinaryMap(f, size);
+  } else if (f.find("\"map\"") && f.find("[")) {
+    map = readJsonMap(f, size);
+  } else { //procedural layout, small enough for the JSON buffer
+    #ifdef WLED_USE_DYNAMIC_JSON
+    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    #else
+    if (!requestJSONBufferLock(7)) {
+      f.close();
+      return;
+    }
+    #endif
+    f.seek(0);
+    if (!deserializeJson(doc, f)) {
+      JsonObject layout = doc[F("layout")];
+      if (!layout.isNull()) map = generateLayoutMap(layout, size);
+    }
     releaseJSONBufferLock();
-    return; //if file does not exist just exit
   }
+  f.close();
 
   // erase old custom ledmap
   if (customMappingTable != nullptr) {
@@ -1136,16 +1691,10 @@ void WS2812FX::deserializeMap(uint8_t n) {
     customMappingTable = nullptr;
   }
 
-  JsonArray map = doc[F("map")];
-  if (!map.isNull() && map.size()) {  // not an empty map
-    customMappingSize  = map.size();
-    customMappingTable = new uint16_t[customMappingSize];
-    for (uint16_t i=0; i<customMappingSize; i++) {
-      customMappingTable[i] = (uint16_t) map[i];
-    }
+  if (map != nullptr) {
+    customMappingTable = map;
+    customMappingSize  = size;
   }
-
-  releaseJSONBufferLock();
 }
 
 //gamma 2.8 lookup table used for color correction
@@ -0,0 +1,223 @@
+/*
+  FX_noise.cpp contains the batched noise functions used by effects
+
+  LICENSE
+  The MIT License (MIT)
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+#include "wled.h"
+#include "FX.h"
+
+/*
+ * Effects sample noise at evenly spaced coordinates, so neighbouring samples usually share their lattice cell.
+ * inoise16() hashes the 8 corners of the cell (14 table lookups) and eases all three fractions for every sample.
+ * Here the corner hashes are only looked up again when a sample enters another cell, and everything derived
+ * from z (and from y if dy is 0) is calculated once per row. Results are identical to the per sample version.
+ */
+
+static const uint8_t noisePerm[257] PROGMEM = {
+  151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23,
+  190,6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,
+  88,237,149,56,87,174,20,125,136,171,168,68,175,74,165,71,134,139,48,27,166,
+  77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,55,46,245,40,244,
+  102,143,54,65,25,63,161,1,216,80,73,209,76,132,187,208,89,18,169,200,196,
+  135,130,116,188,159,86,164,100,109,198,173,186,3,64,52,217,226,250,124,123,
+  5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,
+  223,183,170,213,119,248,152,2,44,154,163,70,221,153,101,155,167,43,172,9,
+  129,22,39,253,19,98,108,110,79,113,224,232,178,185,112,104,218,246,97,228,
+  251,34,242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239,107,
+  49,192,214,31,181,199,106,157,184,84,204,176,115,121,50,45,127,4,150,254,
+  138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180,151
+};
+
+#define NP(i) pgm_read_byte(&noisePerm[i])
+
+static inline int16_t grad16(uint8_t hash, int16_t x, int16_t y, int16_t z)
+{
+  hash &= 15;
+  int16_t u = hash < 8 ? x : y;
+  int16_t v = hash < 4 ? y : (hash == 12 || hash == 14) ? x : z;
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg15(u, v);
+}
+
+//2D version of grad16(), as in FastLED inoise16(x,y)
+static inline int16_t grad16(uint8_t hash, int16_t x, int16_t y)
+{
+  hash &= 7;
+  int16_t u = hash < 4 ? x : y;
+  int16_t v = hash < 4 ? y : x;
+  if (hash & 1) u = -u;
+  if (hash & 2) v = -v;
+  return avg15(u, v);
+}
+
+/*
+ * Along a row only x changes within a cell, so grad16() of a corner is split into a part without x, calculated
+ * when the cell (or y) changes, and one of five terms of x: avg15() takes half of u rounded up and half of v
+ * rounded down, and x is either u, v or neither, negated or not. Sums are the same as in grad16().
+ */
+typedef struct NoiseGrad {
+  int16_t c;   //part without x
+  uint8_t sel; //x term: 0 ceil(x/2), 1 ceil(-x/2), 2 floor(x/2), 3 floor(-x/2), 4 none
+} noise_grad;
+
+static inline int16_t halfUp(int16_t i) { return (i >> 1) + (i & 1); }
+
+static inline NoiseGrad gradWithoutX(uint8_t hash, int16_t y, int16_t z)
+{
+  hash &= 15;
+  int16_t ny = -y, nz = -z;
+  if (hash < 8) { //u = x
+    int16_t v = (hash < 4) ? ((hash & 2) ? ny : y) : ((hash & 2) ? nz : z);
+    return {int16_t(v >> 1), uint8_t(hash & 1)};
+  }
+  int16_t u = (hash & 1) ? ny : y;
+  if (hash == 12 || hash == 14) return {halfUp(u), uint8_t((hash & 2) ? 3 : 2)}; //v = x
+  return {avg15(u, (hash & 2) ? nz : z), 4};
+}
+
+//2D: u and v are x and y, in either order
+static inline NoiseGrad gradWithoutX(uint8_t hash, int16_t y)
+{
+  hash &= 7;
+  int16_t ny = -y;
+  if (hash < 4) return {int16_t(((hash & 2) ? ny : y) >> 1), uint8_t(hash & 1)};
+  return {halfUp((hash & 1) ? ny : y), uint8_t((hash & 2) ? 3 : 2)};
+}
+
+static inline void xTerms(int16_t* t, int16_t x)
+{
+  int16_t nx = -x;
+  t[0] = halfUp(x); t[1] = halfUp(nx); t[2] = x >> 1; t[3] = nx >> 1; t[4] = 0;
+}
+
+//wrap: x and y are taken modulo 65536 per sample, like uint16_t coordinates passed to inoise16()
+template<typename T, uint8_t shift, bool wrap>
+static void fillNoiseRow(T* out, uint16_t len, uint32_t x, uint32_t dx, uint32_t y, uint32_t dy, uint32_t z)
+{
+  const int16_t N = 0x8000;
+  uint8_t  Z  = z >> 16;
+  int16_t  zz = (z >> 1) & 0x7FFF;
+  uint16_t w  = ease16InOutQuad(z);
+  int16_t  yy = (y >> 1) & 0x7FFF;
+  uint16_t v  = ease16InOutQuad(y);
+  const uint32_t mask = wrap ? 0xFFFF : 0xFFFFFFFF;
+
+  uint8_t h[8] = {0}; //hashes of the cell corners
+  NoiseGrad g[8];
+  const bool split = !dy && dx < 0x8000; //at least two samples per cell, and y fixed
+  uint16_t cell = 0;
+  for (uint16_t i = 0; i < len; i++, x += dx, y += dy) {
+    uint16_t c = (((x & mask) >> 8) & 0xFF00) | (((y & mask) >> 16) & 0xFF);
+    bool newCell = (i == 0 || c != cell);
+    if (newCell) {
+      cell = c;
+      uint8_t X = (x & mask) >> 16, Y = (y & mask) >> 16;
+      uint8_t A  = NP(X) + Y,   B  = NP(X+1) + Y;
+      uint8_t AA = NP(A) + Z,   AB = NP(A+1) + Z;
+      uint8_t BA = NP(B) + Z,   BB = NP(B+1) + Z;
+      h[0] = NP(AA);   h[1] = NP(BA);   h[2] = NP(AB);   h[3] = NP(BB);
+      h[4] = NP(AA+1); h[5] = NP(BA+1); h[6] = NP(AB+1); h[7] = NP(BB+1);
+    }
+    if (dy) {
+      yy = (y >> 1) & 0x7FFF;
+      v  = ease16InOutQuad(y);
+    }
+    int16_t  xx = (x >> 1) & 0x7FFF;
+    uint16_t u  = ease16InOutQuad(x);
+
+    int16_t X1, X2, X3, X4;
+    if (split) {
+      if (newCell) for (uint8_t k = 0; k < 8; k++) g[k] = gradWithoutX(h[k], (k & 2) ? yy-N : yy, (k & 4) ? zz-N : zz);
+      int16_t t0[5], t1[5]; //x terms of the corners at x and x+1
+      xTerms(t0, xx);
+      xTerms(t1, xx-N);
+      X1 = lerp15by16(g[0].c + t0[g[0].sel], g[1].c + t1[g[1].sel], u);
+      X2 = lerp15by16(g[2].c + t0[g[2].sel], g[3].c + t1[g[3].sel], u);
+      X3 = lerp15by16(g[4].c + t0[g[4].sel], g[5].c + t1[g[5].sel], u);
+      X4 = lerp15by16(g[6].c + t0[g[6].sel], g[7].c + t1[g[7].sel], u);
+    } else {
+      X1 = lerp15by16(grad16(h[0], xx, yy,   zz),   grad16(h[1], xx-N, yy,   zz),   u);
+      X2 = lerp15by16(grad16(h[2], xx, yy-N, zz),   grad16(h[3], xx-N, yy-N, zz),   u);
+      X3 = lerp15by16(grad16(h[4], xx, yy,   zz-N), grad16(h[5], xx-N, yy,   zz-N), u);
+      X4 = lerp15by16(grad16(h[6], xx, yy-N, zz-N), grad16(h[7], xx-N, yy-N, zz-N), u);
+    }
+    int16_t Y1 = lerp15by16(X1, X2, v);
+    int16_t Y2 = lerp15by16(X3, X4, v);
+    uint32_t n = (int32_t)lerp15by16(Y1, Y2, w) + 19052; //scaled to 0-65535 like inoise16()
+    n *= 440;
+    out[i] = (uint16_t)(n >> 8) >> shift;
+  }
+}
+
+void fillNoise16(uint16_t* out, uint16_t len, uint32_t x, uint32_t dx, uint32_t y, uint32_t dy, uint32_t z)
+{
+  fillNoiseRow<uint16_t, 0, false>(out, len, x, dx, y, dy, z);
+}
+
+void fillNoise8(uint8_t* out, uint16_t len, uint32_t x, uint32_t dx, uint32_t y, uint32_t dy, uint32_t z, bool wrap16)
+{
+  if (wrap16) fillNoiseRow<uint8_t, 8, true>(out, len, x, dx, y, dy, z);
+  else        fillNoiseRow<uint8_t, 8, false>(out, len, x, dx, y, dy, z);
+}
+
+//row of the 2D field of FastLED inoise16(x,y), which differs from the z = 0 plane of the 3D one
+void fillNoise16_2D(uint16_t* out, uint16_t len, uint32_t x, uint32_t dx, uint32_t y)
+{
+  const int16_t N = 0x8000;
+  uint8_t  Y  = y >> 16;
+  int16_t  yy = (y >> 1) & 0x7FFF;
+  uint16_t v  = ease16InOutQuad(y);
+
+  NoiseGrad g[4];
+  uint8_t cell = 0;
+  for (uint16_t i = 0; i < len; i++, x += dx) {
+    uint8_t X = x >> 16;
+    if (i == 0 || X != cell) {
+      cell = X;
+      uint8_t A = NP(X) + Y, B = NP(X+1) + Y;
+      g[0] = gradWithoutX(NP(NP(A)), yy);   g[1] = gradWithoutX(NP(NP(B)), yy);
+      g[2] = gradWithoutX(NP(NP(A+1)), yy-N); g[3] = gradWithoutX(NP(NP(B+1)), yy-N);
+    }
+    int16_t  xx = (x >> 1) & 0x7FFF;
+    uint16_t u  = ease16InOutQuad(x);
+    int16_t t0[5], t1[5];
+    xTerms(t0, xx);
+    xTerms(t1, xx-N);
+
+    int16_t X1 = lerp15by16(g[0].c + t0[g[0].sel], g[1].c + t1[g[1].sel], u);
+    int16_t X2 = lerp15by16(g[2].c + t0[g[2].sel], g[3].c + t1[g[3].sel], u);
+    uint32_t n = (int32_t)lerp15by16(X1, X2, v) + 17308; //scaled to 0-65535 like inoise16(x,y)
+    n *= 484;
+    out[i] = n >> 8;
+  }
+}
+
+const uint8_t* NoiseField::fill(uint16_t w, uint16_t h, uint32_t x, uint32_t dx, uint32_t y, uint32_t dy, uint32_t rowDy, uint32_t z)
+{
+  uint8_t* out = values();
+  if (valid && this->w == w && this->h == h && this->x == x && this->dx == dx && this->y == y && this->dy == dy
+      && this->rowDy == rowDy && this->z == z) return out; //same as last frame
+
+  this->w = w; this->h = h; this->x = x; this->dx = dx;
+  this->y = y; this->dy = dy; this->rowDy = rowDy; this->z = z;
+  valid = true;
+  for (uint16_t r = 0; r < h; r++, y += rowDy, out += w) fillNoise8(out, w, x, dx, y, dy, z);
+  return values();
+}
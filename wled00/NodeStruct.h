@@ -23,8 +23,12 @@ struct NodeStruct
   uint8_t   age;
   uint8_t   nodeType;
   uint32_t  build;
+  int32_t   syncOffset; //timebase sync, remaining offset to the leader (us)
+  uint32_t  syncJitter;
+  uint32_t  syncRtt;
+  bool      syncValid;
 
-  NodeStruct() : age(0), nodeType(0), build(0)
+  NodeStruct() : age(0), nodeType(0), build(0), syncOffset(0), syncJitter(0), syncRtt(0), syncValid(false)
   {
     for (uint8_t i = 0; i < 4; ++i) { ip[i] = 0; }
   }
@@ -48,6 +48,7 @@ struct BusConfig {
   bool reversed;
   uint8_t skipAmount;
   bool refreshReq;
+  uint16_t maxPower = 0; //current budget of the bus' own power supply in mA, 0 = none
   uint8_t pins[5] = {LEDPIN, 255, 255, 255, 255};
   BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0) {
     refreshReq = (bool) GET_BIT(busType,7);
@@ -100,8 +101,26 @@ class Bus {
     inline  uint8_t  getType() { return _type; }
     inline  bool     isOk() { return _valid; }
     inline  bool     isOffRefreshRequired() { return _needsRefresh; }
+    inline  uint16_t getMaxPower() { return _maxPower; }
+    inline  void     setMaxPower(uint16_t mA) { _maxPower = mA; }
+    inline  uint16_t getMilliamps() { return _milliamps; }
+    inline  void     setMilliamps(uint16_t mA) { _milliamps = mA; }
             bool     containsPixel(uint16_t pix) { return pix >= _start && pix < _start+_len; }
 
+    //sum of all channel values at full brightness, used for current estimation
+    //ws2815 model: only count the brightest of the RGB channels (times 3), ignore white
+    virtual uint32_t getPowerSum(bool ws2815) {
+      uint32_t sum = 0;
+      uint16_t len = getLength();
+      for (uint16_t i = 0; i < len; i++) {
+        uint32_t c = getPixelColor(i);
+        byte r = R(c), g = G(c), b = B(c), w = W(c);
+        if (ws2815) sum += max(max(r,g),b) * 3;
+        else        sum += (r + g + b + w);
+      }
+      return sum;
+    }
+
     virtual bool isRgbw() { return Bus::isRgbw(_type); }
     static  bool isRgbw(uint8_t type) {
       if (type == TYPE_SK6812_RGBW || type == TYPE_TM1814) return true;
@@ -129,6 +148,8 @@ class Bus {
     uint8_t  _bri = 255;
     uint16_t _start = 0;
     uint16_t _len = 1;
+    uint16_t _maxPower = 0;
+    uint16_t _milliamps = 0;
     bool     _valid = false;
     bool     _needsRefresh = false;
     static uint8_t _autoWhiteMode;
@@ -216,6 +237,23 @@ class BusDigital : public Bus {
     return PolyBus::getPixelColor(_busPtr, _iType, pix, _colorOrder);
   }
 
+  //sums the raw NeoPixelBus buffer directly instead of decoding every pixel
+  uint32_t getPowerSum(bool ws2815) {
+    uint8_t* pixels = PolyBus::getPixels(_busPtr, _iType);
+    uint8_t channels = Bus::isRgbw(_type) ? 4 : 3;
+    if (pixels == nullptr || (ws2815 && channels == 4)) return Bus::getPowerSum(ws2815); //white position differs per chip
+    uint32_t sum = 0;
+    const uint8_t* p   = pixels + _skip * channels; //skipped LEDs are always at the start of the buffer
+    const uint8_t* end = pixels + _len  * channels;
+    if (ws2815) {
+      for (; p < end; p += 3) sum += max(max(p[0],p[1]),p[2]) * 3;
+    } else {
+      while (p < end) sum += *p++;
+    }
+    //NeoPixelBrightnessBus stores (c * (bri+1)) >> 8, undo the scaling like GetPixelColor() does
+    return (sum << 8) / ((uint16_t)_bri + 1);
+  }
+
   inline uint8_t getColorOrder() {
     return _colorOrder;
   }
@@ -559,6 +597,7 @@ class BusManager {
     } else {
       busses[numBusses] = new BusPwm(bc);
     }
+    busses[numBusses]->setMaxPower(bc.maxPower);
     return numBusses++;
   }
 
@@ -576,6 +576,55 @@ class PolyBus {
     return 0;
   }
 
+  //raw pixel buffer of the clockless chip types, brightness is already applied to it
+  //SPI chips (DotStar, LPD8806, P9813) use extra control bits per pixel and return nullptr
+  static uint8_t* getPixels(void* busPtr, uint8_t busType) {
+    switch (busType) {
+      case I_NONE: break;
+    #ifdef ESP8266
+      case I_8266_U0_NEO_3: return (static_cast<B_8266_U0_NEO_3*>(busPtr))->Pixels(); break;
+      case I_8266_U1_NEO_3: return (static_cast<B_8266_U1_NEO_3*>(busPtr))->Pixels(); break;
+      case I_8266_DM_NEO_3: return (static_cast<B_8266_DM_NEO_3*>(busPtr))->Pixels(); break;
+      case I_8266_BB_NEO_3: return (static_cast<B_8266_BB_NEO_3*>(busPtr))->Pixels(); break;
+      case I_8266_U0_NEO_4: return (static_cast<B_8266_U0_NEO_4*>(busPtr))->Pixels(); break;
+      case I_8266_U1_NEO_4: return (static_cast<B_8266_U1_NEO_4*>(busPtr))->Pixels(); break;
+      case I_8266_DM_NEO_4: return (static_cast<B_8266_DM_NEO_4*>(busPtr))->Pixels(); break;
+      case I_8266_BB_NEO_4: return (static_cast<B_8266_BB_NEO_4*>(busPtr))->Pixels(); break;
+      case I_8266_U0_400_3: return (static_cast<B_8266_U0_400_3*>(busPtr))->Pixels(); break;
+      case I_8266_U1_400_3: return (static_cast<B_8266_U1_400_3*>(busPtr))->Pixels(); break;
+      case I_8266_DM_400_3: return (static_cast<B_8266_DM_400_3*>(busPtr))->Pixels(); break;
+      case I_8266_BB_400_3: return (static_cast<B_8266_BB_400_3*>(busPtr))->Pixels(); break;
+      case I_8266_U0_TM1_4: return (static_cast<B_8266_U0_TM1_4*>(busPtr))->Pixels(); break;
+      case I_8266_U1_TM1_4: return (static_cast<B_8266_U1_TM1_4*>(busPtr))->Pixels(); break;
+      case I_8266_DM_TM1_4: return (static_cast<B_8266_DM_TM1_4*>(busPtr))->Pixels(); break;
+      case I_8266_BB_TM1_4: return (static_cast<B_8266_BB_TM1_4*>(busPtr))->Pixels(); break;
+    #endif
+    #ifdef ARDUINO_ARCH_ESP32
+      case I_32_RN_NEO_3: return (static_cast<B_32_RN_NEO_3*>(busPtr))->Pixels(); break;
+      case I_32_I0_NEO_3: return (static_cast<B_32_I0_NEO_3*>(busPtr))->Pixels(); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      case I_32_I1_NEO_3: return (static_cast<B_32_I1_NEO_3*>(busPtr))->Pixels(); break;
+      #endif
+      case I_32_RN_NEO_4: return (static_cast<B_32_RN_NEO_4*>(busPtr))->Pixels(); break;
+      case I_32_I0_NEO_4: return (static_cast<B_32_I0_NEO_4*>(busPtr))->Pixels(); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      case I_32_I1_NEO_4: return (static_cast<B_32_I1_NEO_4*>(busPtr))->Pixels(); break;
+      #endif
+      case I_32_RN_400_3: return (static_cast<B_32_RN_400_3*>(busPtr))->Pixels(); break;
+      case I_32_I0_400_3: return (static_cast<B_32_I0_400_3*>(busPtr))->Pixels(); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      case I_32_I1_400_3: return (static_cast<B_32_I1_400_3*>(busPtr))->Pixels(); break;
+      #endif
+      case I_32_RN_TM1_4: return (static_cast<B_32_RN_TM1_4*>(busPtr))->Pixels(); break;
+      case I_32_I0_TM1_4: return (static_cast<B_32_I0_TM1_4*>(busPtr))->Pixels(); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      case I_32_I1_TM1_4: return (static_cast<B_32_I1_TM1_4*>(busPtr))->Pixels(); break;
+      #endif
+    #endif
+    }
+    return nullptr;
+  }
+
   static void cleanup(void* busPtr, uint8_t busType) {
     if (busPtr == nullptr) return;
     switch (busType) {
@@ -160,7 +160,7 @@ void handleAnalog(uint8_t b)
       // effect speed
       effectSpeed = aRead;
       effectChanged = true;
-      for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+      for (uint8_t i = 0; i < strip.getSegmentsNum(); i++) {
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isSelected()) continue;
         seg.speed = effectSpeed;
@@ -169,7 +169,7 @@ void handleAnalog(uint8_t b)
       // effect intensity
       effectIntensity = aRead;
       effectChanged = true;
-      for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+      for (uint8_t i = 0; i < strip.getSegmentsNum(); i++) {
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isSelected()) continue;
         seg.intensity = effectIntensity;
@@ -178,7 +178,7 @@ void handleAnalog(uint8_t b)
       // selected palette
       effectPalette = map(aRead, 0, 252, 0, strip.getPaletteCount()-1);
       effectChanged = true;
-      for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+      for (uint8_t i = 0; i < strip.getSegmentsNum(); i++) {
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isSelected()) continue;
         seg.palette = effectPalette;
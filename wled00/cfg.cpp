@@ -85,6 +85,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(cctFromRgb, hw_led[F("cr")]);
 	CJSON(strip.cctBlending, hw_led[F("cb")]);
 	Bus::setCCTBlend(strip.cctBlending);
+  strip.setTargetFps(hw_led[F("fps")] | strip.getTargetFps());
 
   JsonArray ins = hw_led["ins"];
   
@@ -115,6 +116,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       ledType |= refresh << 7;  // hack bit 7 to indicate strip requires off refresh
       s++;
       BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst);
+      bc.maxPower = elm[F("maxpwr")] | 0;
       mem += BusManager::memUsage(bc);
       if (mem <= MAX_LED_MEMORY && busses.getNumBusses() <= WLED_MAX_BUSSES) busses.add(bc);  // finalization will be done in WLED::beginStrip()
     }
@@ -194,6 +196,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     rlyMde = !relay["rev"];
   }
 
+  CJSON(serialBaud, hw[F("baud")]);
+
   //int hw_status_pin = hw[F("status")]["pin"]; // -1
 
   JsonObject light = doc[F("light")];
@@ -233,11 +237,14 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_sync = interfaces[F("sync")];
   CJSON(udpPort, if_sync[F("port0")]); // 21324
   CJSON(udpPort2, if_sync[F("port1")]); // 65506
+  CJSON(strip.rngSeed, if_sync[F("seed")]); //same seed on all nodes that should render identical random effects
+  CJSON(timeSyncMode, if_sync[F("tsync")]);
 
   JsonObject if_sync_recv = if_sync["recv"];
   CJSON(receiveNotificationBrightness, if_sync_recv["bri"]);
   CJSON(receiveNotificationColor, if_sync_recv["col"]);
   CJSON(receiveNotificationEffects, if_sync_recv["fx"]);
+  CJSON(receiveSegmentBounds, if_sync_recv["seg"]);
   CJSON(receiveGroups, if_sync_recv["grp"]);
   //! following line might be a problem if called after boot
   receiveNotifications = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
@@ -252,6 +259,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(notifyMacro, if_sync_send["macro"]);
   CJSON(notifyTwice, if_sync_send[F("twice")]);
   CJSON(syncGroups, if_sync_send["grp"]);
+  CJSON(syncApplyDelay, if_sync_send[F("adly")]);
 
   JsonObject if_nodes = interfaces["nodes"];
   CJSON(nodeListEnabled, if_nodes[F("list")]);
@@ -274,6 +282,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(arlsForceMaxBri, if_live[F("maxbri")]);
   CJSON(arlsDisableGammaCorrection, if_live[F("no-gc")]); // false
   CJSON(arlsOffset, if_live[F("offset")]); // 0
+  CJSON(realtimeInterpolate, if_live[F("interp")]);
 
   CJSON(alexaEnabled, interfaces["va"][F("alexa")]); // false
 
@@ -536,6 +545,7 @@ void serializeConfig() {
   hw_led[F("total")] = strip.getLengthTotal(); //no longer read, but provided for compatibility on downgrade
   hw_led[F("maxpwr")] = strip.ablMilliampsMax;
   hw_led[F("ledma")] = strip.milliampsPerLed;
+  hw_led[F("fps")] = strip.getTargetFps();
   hw_led["cct"] = correctWB;
   hw_led[F("cr")] = cctFromRgb;
 	hw_led[F("cb")] = strip.cctBlending;
@@ -559,6 +569,7 @@ void serializeConfig() {
     ins["type"] = bus->getType() & 0x7F;
     ins["ref"] = bus->isOffRefreshRequired();
     ins[F("rgbw")] = bus->isRgbw();
+    ins[F("maxpwr")] = bus->getMaxPower();
   }
 
   // button(s)
@@ -589,6 +600,8 @@ void serializeConfig() {
   hw_relay["pin"] = rlyPin;
   hw_relay["rev"] = !rlyMde;
 
+  hw[F("baud")] = serialBaud;
+
   //JsonObject hw_status = hw.createNestedObject("status");
   //hw_status["pin"] = -1;
 
@@ -622,11 +635,14 @@ void serializeConfig() {
   JsonObject if_sync = interfaces.createNestedObject("sync");
   if_sync[F("port0")] = udpPort;
   if_sync[F("port1")] = udpPort2;
+  if_sync[F("seed")] = strip.rngSeed;
+  if_sync[F("tsync")] = timeSyncMode;
 
   JsonObject if_sync_recv = if_sync.createNestedObject("recv");
   if_sync_recv["bri"] = receiveNotificationBrightness;
   if_sync_recv["col"] = receiveNotificationColor;
   if_sync_recv["fx"] = receiveNotificationEffects;
+  if_sync_recv["seg"] = receiveSegmentBounds;
   if_sync_recv["grp"] = receiveGroups;
 
   JsonObject if_sync_send = if_sync.createNestedObject("send");
@@ -637,6 +653,7 @@ void serializeConfig() {
   if_sync_send["macro"] = notifyMacro;
   if_sync_send[F("twice")] = notifyTwice;
   if_sync_send["grp"] = syncGroups;
+  if_sync_send[F("adly")] = syncApplyDelay;
 
   JsonObject if_nodes = interfaces.createNestedObject("nodes");
   if_nodes[F("list")] = nodeListEnabled;
@@ -657,6 +674,7 @@ void serializeConfig() {
   if_live[F("maxbri")] = arlsForceMaxBri;
   if_live[F("no-gc")] = arlsDisableGammaCorrection;
   if_live[F("offset")] = arlsOffset;
+  if_live[F("interp")] = realtimeInterpolate;
 
   JsonObject if_va = interfaces.createNestedObject("va");
   if_va[F("alexa")] = alexaEnabled;
@@ -767,7 +785,7 @@ void serializeConfig() {
   usermods.addToConfig(usermods_settings);
 
   File f = WLED_FS.open("/cfg.json", "w");
-  if (f) serializeJson(doc, f);
+  if (f) metricFsBytesWritten += serializeJson(doc, f);
   f.close();
   releaseJSONBufferLock();
 }
@@ -862,7 +880,7 @@ void serializeConfigSec() {
   ota[F("aota")] = aOtaEnabled;
 
   File f = WLED_FS.open("/wsec.json", "w");
-  if (f) serializeJson(doc, f);
+  if (f) metricFsBytesWritten += serializeJson(doc, f);
   f.close();
   releaseJSONBufferLock();
 }
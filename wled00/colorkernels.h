@@ -0,0 +1,90 @@
+#ifndef WLED_COLORKERNELS_H
+#define WLED_COLORKERNELS_H
+/*
+ * Packed color kernels (SWAR, SIMD within a register)
+ * Colors are WRGB packed into a uint32_t (see RGBW32()). Each kernel splits a color into two words with
+ * two 8 bit channels each (R/B and W/G, 8 bits of headroom between them), so one 32 bit multiply works on
+ * two channels at once and no channel is unpacked into bytes. White is processed at no extra cost.
+ */
+#include <stdint.h>
+
+#define SWAR_MASK_RB 0x00FF00FFu
+
+//scales all channels by (scale+1)/256, same as FastLED nscale8()
+inline uint32_t colorScale(uint32_t c, uint8_t scale)
+{
+  uint32_t s = scale + 1;
+  uint32_t rb = (((c      & SWAR_MASK_RB) * s) >> 8) & SWAR_MASK_RB;
+  uint32_t wg =  ((c >> 8) & SWAR_MASK_RB) * s        & ~SWAR_MASK_RB;
+  return rb | wg;
+}
+
+//adds two colors, channels saturate at 255 (qadd8)
+inline uint32_t colorAdd(uint32_t c1, uint32_t c2)
+{
+  uint32_t rb = (c1 & SWAR_MASK_RB) + (c2 & SWAR_MASK_RB);
+  uint32_t wg = ((c1 >> 8) & SWAR_MASK_RB) + ((c2 >> 8) & SWAR_MASK_RB);
+  rb |= ((rb >> 8) & 0x00010001u) * 0xFF; //carry out of a channel sets it to 255
+  wg |= ((wg >> 8) & 0x00010001u) * 0xFF;
+  return (rb & SWAR_MASK_RB) | ((wg & SWAR_MASK_RB) << 8);
+}
+
+/*
+ * Blends c1 (blend 0) towards c2 (blend 255, or 65535 if b16), identical results to the former scalar color_blend().
+ * The 8 bit version keeps two channels per 32 bit word. For 16 bit blend amounts the products need 24 bits,
+ * so the channels are spread over 64 bit words instead.
+ */
+template<bool b16> inline uint32_t colorBlend(uint32_t c1, uint32_t c2, uint16_t blend);
+
+template<> inline uint32_t colorBlend<false>(uint32_t c1, uint32_t c2, uint16_t blend)
+{
+  uint32_t b = blend & 0xFF, ib = 0xFF - b;
+  uint32_t rb = (((c1 & SWAR_MASK_RB) * ib + (c2 & SWAR_MASK_RB) * b) >> 8) & SWAR_MASK_RB;
+  uint32_t wg =  (((c1 >> 8) & SWAR_MASK_RB) * ib + ((c2 >> 8) & SWAR_MASK_RB) * b) & ~SWAR_MASK_RB;
+  return rb | wg;
+}
+
+template<> inline uint32_t colorBlend<true>(uint32_t c1, uint32_t c2, uint16_t blend)
+{
+  const uint64_t mask = 0x000000FF000000FFull;
+  uint64_t b = blend, ib = 0xFFFF - blend;
+  uint64_t rb1 = ((uint64_t)(c1 & 0x00FF0000) << 16) | (c1 & 0xFF); //R in bits 32-39, B in bits 0-7
+  uint64_t rb2 = ((uint64_t)(c2 & 0x00FF0000) << 16) | (c2 & 0xFF);
+  uint64_t wg1 = ((uint64_t)(c1 & 0xFF000000) << 8)  | ((c1 >> 8) & 0xFF);
+  uint64_t wg2 = ((uint64_t)(c2 & 0xFF000000) << 8)  | ((c2 >> 8) & 0xFF);
+  uint64_t rb = ((rb1 * ib + rb2 * b) >> 16) & mask;
+  uint64_t wg = ((wg1 * ib + wg2 * b) >> 16) & mask;
+  return (uint32_t)(rb >> 16) | (uint32_t)rb | (uint32_t)((wg >> 8) & 0xFF000000) | (uint32_t)((wg & 0xFF) << 8);
+}
+
+//0x80 in each byte of v that is 0
+inline uint32_t swarZeroBytes(uint32_t v)
+{
+  return ~(((v & 0x7F7F7F7Fu) + 0x7F7F7F7Fu) | v) & 0x80808080u;
+}
+
+//0x80 in each byte where x < y (unsigned): the borrow out of the byte in x - y
+inline uint32_t swarLessBytes(uint32_t x, uint32_t y)
+{
+  uint32_t d = ((x | 0x80808080u) - (y & 0x7F7F7F7Fu)) ^ ((x ^ ~y) & 0x80808080u); //bytewise x - y
+  return ((~x & y) | (~(x ^ y) & d)) & 0x80808080u;
+}
+
+/*
+ * Moves c towards target by amount/256 of the difference, but always by at least 1 per channel until it is reached.
+ * Unlike colorBlend() the weights add up to 256, so channels that reached the target stay there.
+ */
+inline uint32_t colorFadeToward(uint32_t c, uint32_t target, uint8_t amount)
+{
+  uint32_t a = amount, ia = 256 - a;
+  uint32_t rb = (((c & SWAR_MASK_RB) * ia + (target & SWAR_MASK_RB) * a) >> 8) & SWAR_MASK_RB;
+  uint32_t wg =  (((c >> 8) & SWAR_MASK_RB) * ia + ((target >> 8) & SWAR_MASK_RB) * a) & ~SWAR_MASK_RB;
+  uint32_t n = rb | wg;
+  if (n == target) return n;
+  //step the channels that rounding left unchanged by one, no carries as they are below (above) their target
+  uint32_t stuck = swarZeroBytes(n ^ c) & ~swarZeroBytes(c ^ target);
+  uint32_t up = stuck & swarLessBytes(c, target);
+  return n + (up >> 7) - ((stuck & ~up) >> 7);
+}
+
+#endif
@@ -246,20 +246,21 @@ void colorRGBtoRGBW(byte* rgb) //rgb to rgbw (http://codewelt.com/rgbw). (RGBW_M
 */
 
 byte correctionRGB[4] = {0,0,0,0};
+byte correctionLUT[3][256]; //correctionRGB[c] * x / 255 for every channel value x
 uint16_t lastKelvin = 0;
 
 // adjust RGB values based on color temperature in K (range [2800-10200]) (https://en.wikipedia.org/wiki/Color_balance)
 uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb)
 {
-  //remember so that slow colorKtoRGB() doesn't have to run for every setPixelColor()
-  if (lastKelvin != kelvin) colorKtoRGB(kelvin, correctionRGB);  // convert Kelvin to RGB
+  //remember so that slow colorKtoRGB() and the table calculation don't have to run for every setPixelColor()
+  if (lastKelvin != kelvin) {
+    colorKtoRGB(kelvin, correctionRGB);  // convert Kelvin to RGB
+    for (uint8_t c = 0; c < 3; c++) {
+      for (uint16_t x = 0; x < 256; x++) correctionLUT[c][x] = ((uint16_t) correctionRGB[c] * x) /255;
+    }
+  }
   lastKelvin = kelvin;
-  byte rgbw[4];
-  rgbw[0] = ((uint16_t) correctionRGB[0] * R(rgb)) /255; // correct R
-  rgbw[1] = ((uint16_t) correctionRGB[1] * G(rgb)) /255; // correct G
-  rgbw[2] = ((uint16_t) correctionRGB[2] * B(rgb)) /255; // correct B
-  rgbw[3] =                                W(rgb);
-  return colorFromRgbw(rgbw);
+  return RGBW32(correctionLUT[0][R(rgb)], correctionLUT[1][G(rgb)], correctionLUT[2][B(rgb)], W(rgb));
 }
 
 //approximates a Kelvin color temperature from an RGB color.
@@ -210,6 +210,7 @@
 #define SEG_OPTION_MIRROR         3            //Indicates that the effect will be mirrored within the segment
 #define SEG_OPTION_NONUNITY       4            //Indicates that the effect does not use FRAMETIME or needs getPixelColor
 #define SEG_OPTION_FREEZE         5            //Segment contents will not be refreshed
+#define SEG_OPTION_CUBIC          6            //Reduced-resolution rendering (Segment.scale) interpolates cubically instead of linearly
 #define SEG_OPTION_TRANSITIONAL   7
 
 //Segment differs return byte
@@ -220,6 +221,32 @@
 #define SEG_DIFFERS_BOUNDS     0x10
 #define SEG_DIFFERS_GSO        0x20
 
+//Protocols for the packet counters served at /metrics (metrics.cpp)
+#define METRIC_PROTO_SYNC         0            //WLED UDP sync notifications
+#define METRIC_PROTO_UDP          1            //WARLS, DRGB, DRGBW, DNRGB and TPM2.NET on the notifier port
+#define METRIC_PROTO_HYPERION     2            //raw RGB on the Hyperion port
+#define METRIC_PROTO_E131         3
+#define METRIC_PROTO_ARTNET       4
+#define METRIC_PROTO_DDP          5
+#define METRIC_PROTO_COUNT        6
+
+//Timebase sync between nodes (tsync.cpp)
+#define TSYNC_MODE_OFF            0
+#define TSYNC_MODE_LEADER         1            //answers time requests of followers
+#define TSYNC_MODE_FOLLOWER       2            //slews its timebase to the leader's
+#define TSYNC_PACKET_ID        0xF1            //first byte of time sync packets on the notifier port
+
+//Binary pixel upload formats (pixels.cpp), also the encodings of compressed UDP realtime frames
+#define PIXEL_FORMAT_RGB          0
+#define PIXEL_FORMAT_RGBW         1
+#define PIXEL_FORMAT_PALETTE      2            //palette transmitted in packet, 1 byte index per pixel
+#define PIXEL_FORMAT_RLE          3            //runs of count + RGB
+
+//Compressed UDP realtime frames (protocol byte 6): PIXEL_FORMAT_* or these, which depend on previous packets
+#define UDP_RT_COMPRESSED         6
+#define UDP_RT_ENC_DELTA          4            //op byte: bit 7 set skips (op & 0x7F) +1 unchanged pixels, else op +1 RGB pixels follow
+#define UDP_RT_ENC_INDEXED        5            //1 byte index per pixel into the palette of the last PIXEL_FORMAT_PALETTE packet
+
 //Playlist option byte
 #define PL_OPTION_SHUFFLE      0x01
 
@@ -283,6 +310,29 @@
   #endif
 #endif
 
+// packets queued between the AsyncUDP task and the loop (e131.cpp), 0 applies them in the callback
+#ifndef E131_QUEUE_SLOTS
+  #ifdef ESP8266
+    #define E131_QUEUE_SLOTS 0 //callbacks do not run concurrently with the loop
+  #else
+    #define E131_QUEUE_SLOTS 8
+  #endif
+#endif
+#define E131_QUEUE_BUDGET_MS 5 //max. time per loop spent applying queued packets
+
+// UDP packets handled per loop (udp.cpp), senders often split a frame over several packets
+#ifndef UDP_DRAIN_MAX_PACKETS
+  #define UDP_DRAIN_MAX_PACKETS 8
+#endif
+#ifndef UDP_DRAIN_BUDGET_MS
+  #define UDP_DRAIN_BUDGET_MS 10
+#endif
+
+// interpolation of realtime frames (rtinterp.cpp)
+#ifndef RT_INTERP_MAX_INTERVAL
+  #define RT_INTERP_MAX_INTERVAL 250 //ms, longer gaps between frames are pauses of the stream and not measured
+#endif
+
 #define ABL_MILLIAMPS_DEFAULT 850  // auto lower brightness to stay close to milliampere limit
 
 // PWM settings
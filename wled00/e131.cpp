@@ -1,4 +1,7 @@
 #include "wled.h"
+#if E131_QUEUE_SLOTS > 0
+#include <atomic>
+#endif
 
 #define MAX_3_CH_LEDS_PER_UNIVERSE 170
 #define MAX_4_CH_LEDS_PER_UNIVERSE 128
@@ -8,19 +11,41 @@
  * E1.31 handler
  */
 
+/*
+ * Frame end of multi-universe streams, for interpolation
+ * A frame is complete once the universe that ended the previous frame arrives, or when the
+ * universe index wraps around (the stream got shorter or its last universe was lost).
+ */
+static int16_t e131PrevUniverse = -1; //index of the universe received last, -1 at stream start
+static int16_t e131EndUniverse  = -1; //highest index of the previous frame
+static int16_t e131MaxUniverse  = -1; //highest index of the current frame so far
+static bool    e131FrameDone    = false;
+
+void e131ResetFrame()
+{
+  e131PrevUniverse = e131EndUniverse = e131MaxUniverse = -1;
+  e131FrameDone = false;
+}
+
 //DDP protocol support, called by handleE131Packet
 //handles RGB data only
 void handleDDPPacket(e131_packet_t* p) {
   int lastPushSeq = e131LastSequenceNumber[0];
+  metricPacketsRx[METRIC_PROTO_DDP]++;
   
   //reject late packets belonging to previous frame (assuming 4 packets max. before push)
   if (e131SkipOutOfSequence && lastPushSeq) {
     int sn = p->sequenceNum & 0xF;
     if (sn) {
+      bool late;
       if (lastPushSeq > 5) {
-        if (sn > (lastPushSeq -5) && sn < lastPushSeq) return;
+        late = (sn > (lastPushSeq -5) && sn < lastPushSeq);
       } else {
-        if (sn > (10 + lastPushSeq) || sn < lastPushSeq) return;
+        late = (sn > (10 + lastPushSeq) || sn < lastPushSeq);
+      }
+      if (late) {
+        metricPacketsOutOfSeq[METRIC_PROTO_DDP]++;
+        return;
       }
     }
   }
@@ -83,8 +108,14 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   }
   #endif
 
+  uint8_t metricProto = (protocol == P_ARTNET) ? METRIC_PROTO_ARTNET : METRIC_PROTO_E131;
+  metricPacketsRx[metricProto]++;
+
   // only listen for universes we're handling & allocated memory
-  if (uni >= (e131Universe + E131_MAX_UNIVERSE_COUNT)) return;
+  if (uni >= (e131Universe + E131_MAX_UNIVERSE_COUNT)) {
+    metricPacketsDropped[metricProto]++;
+    return;
+  }
 
   uint8_t previousUniverses = uni - e131Universe;
 
@@ -97,11 +128,13 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       DEBUG_PRINT(", universe=");
       DEBUG_PRINT(uni);
       DEBUG_PRINTLN(")");
+      metricPacketsOutOfSeq[metricProto]++;
       return;
     }
   e131LastSequenceNumber[uni-e131Universe] = seq;
 
   // update status info
+  if (!(clientIP == realtimeIP) || realtimeMode != mde) e131ResetFrame(); //another stream
   realtimeIP = clientIP;
   byte wChannel = 0;
   uint16_t totalLen = strip.getLengthTotal();
@@ -173,6 +206,13 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
         const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
         const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
         if (realtimeOverride) return;
+        bool interp = rtInterpActive();
+        if (interp && previousUniverses <= e131PrevUniverse) { //wrapped, a new frame starts
+          if (!e131FrameDone) rtInterpPush();
+          e131EndUniverse = e131MaxUniverse;
+          e131MaxUniverse = -1;
+          e131FrameDone = false;
+        }
         uint16_t previousLeds, dmxOffset;
         if (previousUniverses == 0) {
           if (dmxChannels-DMXAddress < 1) return;
@@ -200,6 +240,15 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
             dmxOffset+=4;
           }
         }
+        if (interp) { //pushed here, not by handleNotifications()
+          e131PrevUniverse = previousUniverses;
+          if (e131PrevUniverse > e131MaxUniverse) e131MaxUniverse = e131PrevUniverse;
+          if (e131PrevUniverse == e131EndUniverse && !e131FrameDone) {
+            rtInterpPush();
+            e131FrameDone = true;
+          }
+          return;
+        }
         break;
       }
     default:
@@ -210,3 +259,74 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   e131NewData = true;
 }
+
+/*
+ * Packet queue between the AsyncUDP task and the loop
+ * On ESP32 the callback runs on another core, possibly while the strip is rendered or shown.
+ * It only copies the packet into a free slot, the loop applies it. Single producer (AsyncUDP task)
+ * and single consumer (loop), each index is only written by one side, so no lock is needed.
+ */
+#if E131_QUEUE_SLOTS > 0
+struct E131QueueSlot {
+  e131_packet_t packet;
+  uint32_t clientIP;
+  byte protocol;
+};
+
+static E131QueueSlot* e131Queue = nullptr;
+static std::atomic<uint8_t> e131QueueHead(0); //next slot to write, producer only
+static std::atomic<uint8_t> e131QueueTail(0); //next slot to read, consumer only
+
+//used part of a packet, only that is copied
+static uint16_t e131PacketLength(e131_packet_t* p, byte protocol)
+{
+  uint16_t len;
+  if (protocol == P_ARTNET)    len = offsetof(e131_packet_t, art_data) + htons(p->art_length);
+  else if (protocol == P_E131) len = offsetof(e131_packet_t, property_values) + htons(p->property_value_count);
+  else                         len = offsetof(e131_packet_t, data) + htons(p->dataLen) + ((p->flags & DDP_TIMECODE_FLAG) ? 4 : 0);
+  return (len < sizeof(e131_packet_t)) ? len : sizeof(e131_packet_t);
+}
+
+void queueE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol)
+{
+  if (!e131Queue) { //only allocated once packets arrive
+    e131Queue = (E131QueueSlot*) malloc(E131_QUEUE_SLOTS * sizeof(E131QueueSlot));
+    if (!e131Queue) {
+      metricE131QueueDrops++;
+      return;
+    }
+  }
+  uint8_t head = e131QueueHead.load(std::memory_order_relaxed);
+  uint8_t next = (head + 1) % E131_QUEUE_SLOTS;
+  if (next == e131QueueTail.load(std::memory_order_acquire)) { //full, loop is behind
+    metricE131QueueDrops++;
+    return;
+  }
+  E131QueueSlot& slot = e131Queue[head];
+  memcpy(&slot.packet, p, e131PacketLength(p, protocol));
+  slot.clientIP = clientIP;
+  slot.protocol = protocol;
+  e131QueueHead.store(next, std::memory_order_release); //publishes the slot
+}
+
+//applies queued packets, for at most E131_QUEUE_BUDGET_MS per call so the rest of the loop keeps running
+void handleE131Queue()
+{
+  uint8_t tail = e131QueueTail.load(std::memory_order_relaxed);
+  uint32_t start = millis();
+  while (tail != e131QueueHead.load(std::memory_order_acquire)) {
+    E131QueueSlot& slot = e131Queue[tail];
+    handleE131Packet(&slot.packet, IPAddress(slot.clientIP), slot.protocol);
+    tail = (tail + 1) % E131_QUEUE_SLOTS;
+    e131QueueTail.store(tail, std::memory_order_release); //slot may be reused
+    if (millis() - start >= E131_QUEUE_BUDGET_MS) break;
+  }
+}
+#else
+void queueE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol)
+{
+  handleE131Packet(p, clientIP, protocol);
+}
+
+void handleE131Queue() {}
+#endif
@@ -76,7 +76,10 @@ void initDMX();
 void handleDMX();
 
 //e131.cpp
+void e131ResetFrame();
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void queueE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleE131Queue();
 
 //file.cpp
 bool handleFileRead(AsyncWebServerRequest*, String path);
@@ -87,6 +90,10 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest);
 void updateFSInfo();
 void closeFile();
 
+//fxvm.cpp
+bool fxvmSave(uint8_t id, const char* src);
+void fxvmInvalidate();
+
 //hue.cpp
 void handleHue();
 void reconnectHue();
@@ -128,6 +135,8 @@ void handleIR();
 #include "FX.h"
 
 void deserializeSegment(JsonObject elem, byte it, byte presetId = 0);
+void queueSegment(JsonObject elem, byte id, byte presetId = 0);
+void handleSegmentQueue();
 bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
 void serializeSegment(JsonObject& root, WS2812FX::Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
 void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true);
@@ -188,6 +197,30 @@ void unloadPlaylist();
 int16_t loadPlaylist(JsonObject playlistObject, byte presetId = 0);
 void handlePlaylist();
 
+//metrics.cpp
+void serveMetrics(AsyncWebServerRequest* request);
+
+//pixels.cpp
+struct PixelUpload {
+  uint8_t  header[5];
+  uint8_t  headerLen;
+  uint8_t  carry[4];  //partial pixel or RLE run between chunks
+  uint8_t  carryLen;
+  uint16_t pix;       //next virtual pixel of the segment
+  uint16_t palBytes;  //expected palette bytes (palette format only)
+  uint16_t palLen;    //received palette bytes
+  bool     error;
+  uint8_t  pal[768];
+};
+void pixelUploadBegin(PixelUpload* up);
+bool pixelUploadFeed(PixelUpload* up, const uint8_t* data, size_t len);
+bool pixelUploadEnd(PixelUpload* up);
+bool handlePixelUpload(const uint8_t* data, size_t len);
+typedef void (*PixelSetter)(uint16_t i, byte r, byte g, byte b, byte w);
+uint8_t pixelElementLen(uint8_t format);
+uint16_t decodePixelElement(uint8_t format, const uint8_t* el, uint16_t pix, uint16_t len, const uint8_t* pal, uint16_t palBytes, PixelSetter set);
+void decodeRealtimePixels(uint8_t enc, const uint8_t* d, uint16_t len, uint16_t id, uint16_t totalLen);
+
 //presets.cpp
 bool applyPreset(byte index, byte callMode = CALL_MODE_DIRECT_CHANGE);
 void savePreset(byte index, bool persist = true, const char* pname = nullptr, JsonObject saveobj = JsonObject());
@@ -202,6 +235,18 @@ int getNumVal(const String* req, uint16_t pos);
 void parseNumber(const char* str, byte* val, byte minv=0, byte maxv=255);
 bool updateVal(const String* req, const char* key, byte* val, byte minv=0, byte maxv=255);
 
+//tsync.cpp
+void handleTimeSync();
+void handleTimeSyncPacket(const uint8_t* buf, uint16_t len, IPAddress ip);
+void serializeTimeSync(JsonObject root);
+
+//rtinterp.cpp
+bool rtInterpActive();
+void rtInterpSetPixel(uint16_t i, uint32_t c);
+void rtInterpPush();
+void handleRtInterp();
+void rtInterpFree();
+
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
 uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
@@ -279,6 +324,7 @@ void clearEEPROM();
 
 //wled_serial.cpp
 void handleSerial();
+void updateSerialBaud(uint32_t baud);
 
 //wled_server.cpp
 bool isIp(String str);
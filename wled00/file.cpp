@@ -168,7 +168,7 @@ void writeSpace(uint16_t l)
 
   while (l > 0) {
     uint16_t block = (l>FS_BUFSIZE) ? FS_BUFSIZE : l;
-    f.write(buf, block);
+    metricFsBytesWritten += f.write(buf, block);
     l -= block;
   }
 
@@ -200,8 +200,8 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
   DEBUGFS_PRINTF("CLen %d\n", contentLen);
   if (bufferedFindSpace(contentLen + strlen(key) + 1)) {
     if (f.position() > 2) f.write(','); //add comma if not first object
-    f.print(key);
-    serializeJson(*content, f);
+    metricFsBytesWritten += f.print(key);
+    metricFsBytesWritten += serializeJson(*content, f);
     DEBUGFS_PRINTF("Inserted, took %d ms (total %d)", millis() - s1, millis() - s);
     doCloseFile = true;
     return true;
@@ -243,10 +243,10 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
     f.print('{'); //start JSON
   }
 
-  f.print(key);
+  metricFsBytesWritten += f.print(key);
 
   //Append object
-  serializeJson(*content, f);
+  metricFsBytesWritten += serializeJson(*content, f);
   f.write('}');
 
   doCloseFile = true;
@@ -304,12 +304,12 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
   if (contentLen && contentLen <= oldLen) { //replace and fill diff with spaces
     DEBUGFS_PRINTLN(F("replace"));
     f.seek(pos);
-    serializeJson(*content, f);
+    metricFsBytesWritten += serializeJson(*content, f);
     writeSpace(pos2 - f.position());
   } else if (contentLen && bufferedFindSpace(contentLen - oldLen, false)) { //enough leading spaces to replace
     DEBUGFS_PRINTLN(F("replace (trailing)"));
     f.seek(pos);
-    serializeJson(*content, f);
+    metricFsBytesWritten += serializeJson(*content, f);
   } else {
     DEBUGFS_PRINTLN(F("delete"));
     pos -= strlen(key);
@@ -0,0 +1,500 @@
+#include "wled.h"
+
+/*
+ * Expression effect: compiler and interpreter
+ *
+ * A program is a single expression, stored in /fx<n>.txt and selected by the segment "prog" value, e.g.
+ *   hsv(t*0.1 + i/len, 1, sin(t+i))
+ * The result is either hsv(h,s,v), rgb(r,g,b) (0-1 each, hue wraps) or a single value that picks a
+ * palette position (0-1, wraps).
+ * Variables: i (pixel), x, y (2D position), t (seconds), len, w, h (canvas size), sx, ix (speed and
+ * intensity, 0-1), pi. Functions: sin, cos, tri, abs, floor, frac, clamp (to 0-1), min, max, noise(x,y).
+ * Operators: + - * / % < > and parentheses.
+ *
+ * The expression is compiled once when the effect loads it. Registers are numbered variables first, then
+ * constants, then temporaries, which are allocated like a stack so deep expressions need few of them.
+ * Constant subexpressions are folded at compile time.
+ */
+
+enum FxOp : uint8_t {
+  FXOP_ADD, FXOP_SUB, FXOP_MUL, FXOP_DIV, FXOP_MOD, FXOP_LT, FXOP_GT, FXOP_MIN, FXOP_MAX, FXOP_NOISE,
+  FXOP_NEG, FXOP_ABS, FXOP_FLOOR, FXOP_FRAC, FXOP_CLAMP, FXOP_SIN, FXOP_COS, FXOP_TRI
+};
+
+#define FX_ONE 0x10000 //1.0 in 16.16
+
+static uint8_t fxVersion = 0; //changes whenever a program is saved, so running effects reload it
+
+uint8_t fxvmVersion()
+{
+  return fxVersion;
+}
+
+void fxvmInvalidate()
+{
+  fxVersion++;
+}
+
+/*
+ * Interpreter
+ */
+
+#define FXVM_UNARY(expr)  for (uint16_t k = 0; k < n; k++) { int32_t a = A[k]; D[k] = (expr); }
+#define FXVM_BINARY(expr) for (uint16_t k = 0; k < n; k++) { int32_t a = A[k], b = B[k]; D[k] = (expr); }
+
+static inline int32_t fxMul(int32_t a, int32_t b) { return ((int64_t)a * b) >> 16; }
+static inline int32_t fxDiv(int32_t a, int32_t b) { return b ? ((int64_t)a << 16) / b : 0; }
+static inline int32_t fxMod(int32_t a, int32_t b)
+{
+  if (!b) return 0;
+  int32_t r = a % b;
+  return (r && ((r < 0) != (b < 0))) ? r + b : r; //same sign as b, like floored modulo
+}
+static inline int32_t fxSin(int32_t a) { return sin16(((int64_t)a * 10430) >> 16) * 2; } //radians to 1/65536 turns
+static inline int32_t fxTri(int32_t a)
+{
+  int32_t f = a & 0xFFFF;
+  return (f < 0x8000) ? f * 2 : (FX_ONE - f) * 2;
+}
+
+//runs the code on n lanes, registers are stride lanes apart
+static void fxvmExec(const FxInstr* code, uint8_t len, int32_t* regs, uint16_t stride, uint16_t n)
+{
+  for (uint8_t pc = 0; pc < len; pc++) {
+    const FxInstr& in = code[pc];
+    int32_t* D = regs + in.dst * stride;
+    const int32_t* A = regs + in.a * stride;
+    const int32_t* B = regs + in.b * stride;
+    switch (in.op) {
+      case FXOP_ADD:   FXVM_BINARY(a + b); break;
+      case FXOP_SUB:   FXVM_BINARY(a - b); break;
+      case FXOP_MUL:   FXVM_BINARY(fxMul(a, b)); break;
+      case FXOP_DIV:   FXVM_BINARY(fxDiv(a, b)); break;
+      case FXOP_MOD:   FXVM_BINARY(fxMod(a, b)); break;
+      case FXOP_LT:    FXVM_BINARY(a < b ? FX_ONE : 0); break;
+      case FXOP_GT:    FXVM_BINARY(a > b ? FX_ONE : 0); break;
+      case FXOP_MIN:   FXVM_BINARY(a < b ? a : b); break;
+      case FXOP_MAX:   FXVM_BINARY(a > b ? a : b); break;
+      case FXOP_NOISE: FXVM_BINARY(inoise16((uint32_t)a, (uint32_t)b)); break;
+      case FXOP_NEG:   FXVM_UNARY(-a); break;
+      case FXOP_ABS:   FXVM_UNARY(a < 0 ? -a : a); break;
+      case FXOP_FLOOR: FXVM_UNARY((int32_t)(a & 0xFFFF0000)); break;
+      case FXOP_FRAC:  FXVM_UNARY(a & 0xFFFF); break;
+      case FXOP_CLAMP: FXVM_UNARY(a < 0 ? 0 : (a > FX_ONE ? FX_ONE : a)); break;
+      case FXOP_SIN:   FXVM_UNARY(fxSin(a)); break;
+      case FXOP_COS:   FXVM_UNARY(fxSin(a + 102944)); break; //+pi/2
+      case FXOP_TRI:   FXVM_UNARY(fxTri(a)); break;
+    }
+  }
+}
+
+static inline uint8_t fxByte(int32_t v) //0-1 to 0-255
+{
+  if (v <= 0) return 0;
+  if (v >= 0xFFFF) return 255;
+  return v >> 8;
+}
+
+size_t fxvmDataSize(const FxProgram* p)
+{
+  return sizeof(FxProgram) + p->regCount * FXVM_SPAN * sizeof(int32_t);
+}
+
+//fills the constant registers, needed once after the program is copied to segment data
+void fxvmInit(FxProgram* p)
+{
+  for (uint8_t c = 0; c < p->constCount; c++) {
+    int32_t* l = p->lane(FXVM_VAR_COUNT + c);
+    for (uint16_t k = 0; k < FXVM_SPAN; k++) l[k] = p->consts[c];
+  }
+}
+
+static void fxvmFill(FxProgram* p, uint8_t r, int32_t v)
+{
+  int32_t* l = p->lane(r);
+  for (uint16_t k = 0; k < FXVM_SPAN; k++) l[k] = v;
+}
+
+void fxvmSetUniforms(FxProgram* p, uint32_t ms, uint16_t len, uint16_t w, uint16_t h, uint8_t speed, uint8_t intensity)
+{
+  fxvmFill(p, FXVM_VAR_T,   ((uint64_t)(ms % 32768000) << 16) / 1000); //wraps after 9 hours
+  fxvmFill(p, FXVM_VAR_LEN, (int32_t)len << 16);
+  fxvmFill(p, FXVM_VAR_W,   (int32_t)w << 16);
+  fxvmFill(p, FXVM_VAR_H,   (int32_t)h << 16);
+  fxvmFill(p, FXVM_VAR_SX,  speed * 257);
+  fxvmFill(p, FXVM_VAR_IX,  intensity * 257);
+}
+
+//evaluates n (<= FXVM_SPAN) pixels from canvas index first on, out receives RGB colors or palette indexes
+void fxvmRun(FxProgram* p, uint16_t first, uint16_t n, uint16_t w, uint32_t* out)
+{
+  int32_t* li = p->lane(FXVM_VAR_I);
+  int32_t* lx = p->lane(FXVM_VAR_X);
+  int32_t* ly = p->lane(FXVM_VAR_Y);
+  uint16_t x = first % w, y = first / w;
+  for (uint16_t k = 0; k < n; k++) {
+    li[k] = (int32_t)(first + k) << 16;
+    lx[k] = (int32_t)x << 16;
+    ly[k] = (int32_t)y << 16;
+    if (++x >= w) { x = 0; y++; }
+  }
+
+  fxvmExec(p->code, p->codeLen, p->lane(0), FXVM_SPAN, n);
+
+  const int32_t* r0 = p->lane(p->res[0]);
+  const int32_t* r1 = p->lane(p->res[1]);
+  const int32_t* r2 = p->lane(p->res[2]);
+  switch (p->out) {
+    case FXVM_OUT_PALETTE:
+      for (uint16_t k = 0; k < n; k++) out[k] = (r0[k] >> 8) & 0xFF;
+      break;
+    case FXVM_OUT_HSV:
+      for (uint16_t k = 0; k < n; k++) {
+        CRGB c = CHSV((r0[k] >> 8) & 0xFF, fxByte(r1[k]), fxByte(r2[k]));
+        out[k] = RGBW32(c.r, c.g, c.b, 0);
+      }
+      break;
+    default:
+      for (uint16_t k = 0; k < n; k++) out[k] = RGBW32(fxByte(r0[k]), fxByte(r1[k]), fxByte(r2[k]), 0);
+      break;
+  }
+}
+
+/*
+ * Compiler (recursive descent, one pass)
+ */
+
+#define FXREG_CONST 0x40 //register numbers while compiling, resolved once the constant count is known
+#define FXREG_TEMP  0x80
+
+typedef struct FxOperand {
+  bool    isConst;
+  int32_t value;
+  uint8_t reg;
+} fx_operand;
+
+typedef struct FxCompiler {
+  const char* src;
+  const char* s;
+  FxProgram*  p;
+  uint8_t     temps, maxTemps;
+  const char* err;
+  const char* errAt; //position of the first error, parsing goes on to the end
+} fx_compiler;
+
+typedef struct FxName {
+  const char* name;
+  uint8_t     val; //register, or op for functions
+  uint8_t     args;
+} fx_name;
+
+static const FxName fxVars[] = {
+  {"i", FXVM_VAR_I, 0}, {"x", FXVM_VAR_X, 0}, {"y", FXVM_VAR_Y, 0}, {"t", FXVM_VAR_T, 0}, {"len", FXVM_VAR_LEN, 0},
+  {"w", FXVM_VAR_W, 0}, {"h", FXVM_VAR_H, 0}, {"sx", FXVM_VAR_SX, 0}, {"ix", FXVM_VAR_IX, 0}
+};
+
+static const FxName fxFuncs[] = {
+  {"sin", FXOP_SIN, 1}, {"cos", FXOP_COS, 1}, {"tri", FXOP_TRI, 1}, {"abs", FXOP_ABS, 1}, {"floor", FXOP_FLOOR, 1},
+  {"frac", FXOP_FRAC, 1}, {"clamp", FXOP_CLAMP, 1}, {"min", FXOP_MIN, 2}, {"max", FXOP_MAX, 2}, {"noise", FXOP_NOISE, 2}
+};
+
+static void fxError(FxCompiler& c, const char* msg)
+{
+  if (c.err) return;
+  c.err = msg;
+  c.errAt = c.s;
+}
+
+static void fxSkip(FxCompiler& c)
+{
+  while (*c.s == ' ' || *c.s == '\t' || *c.s == '\r' || *c.s == '\n') c.s++;
+}
+
+static bool fxAccept(FxCompiler& c, char ch)
+{
+  fxSkip(c);
+  if (*c.s != ch) return false;
+  c.s++;
+  return true;
+}
+
+static void fxExpect(FxCompiler& c, char ch)
+{
+  if (!fxAccept(c, ch)) fxError(c, ch == ')' ? "')' expected" : "',' expected");
+}
+
+static uint8_t fxIdent(FxCompiler& c, char* buf, uint8_t size)
+{
+  fxSkip(c);
+  uint8_t len = 0;
+  while (isalpha(c.s[len]) || (len && isdigit(c.s[len]))) {
+    if (len < size -1) buf[len] = c.s[len];
+    len++;
+  }
+  buf[len < size ? len : size -1] = 0;
+  return len;
+}
+
+static uint8_t fxTemp(FxCompiler& c)
+{
+  uint8_t t = c.temps++;
+  if (c.temps > c.maxTemps) c.maxTemps = c.temps;
+  return FXREG_TEMP | t;
+}
+
+static uint8_t fxReg(FxCompiler& c, const FxOperand& o)
+{
+  if (!o.isConst) return o.reg;
+  for (uint8_t i = 0; i < c.p->constCount; i++) {
+    if (c.p->consts[i] == o.value) return FXREG_CONST | i;
+  }
+  if (c.p->constCount >= FXVM_MAX_REGS) { fxError(c, "too many constants"); return 0; }
+  c.p->consts[c.p->constCount] = o.value;
+  return FXREG_CONST | c.p->constCount++;
+}
+
+//a = a op b, b is unused by unary ops
+static void fxEmit(FxCompiler& c, uint8_t op, FxOperand& a, const FxOperand& b)
+{
+  if (c.err) return;
+  if (a.isConst && b.isConst) { //fold
+    int32_t regs[3] = {a.value, b.value, 0};
+    FxInstr in = {op, 2, 0, 1};
+    fxvmExec(&in, 1, regs, 1, 1);
+    a.value = regs[2];
+    return;
+  }
+  uint8_t ra = fxReg(c, a), rb = fxReg(c, b);
+  uint8_t dst;
+  if (ra & FXREG_TEMP) {
+    dst = ra;
+    if ((rb & FXREG_TEMP) && rb != ra) c.temps--; //b was evaluated after a, so it is on top
+  } else if (rb & FXREG_TEMP) {
+    dst = rb;
+  } else {
+    dst = fxTemp(c);
+  }
+  if (c.p->codeLen >= FXVM_MAX_CODE) { fxError(c, "expression too long"); return; }
+  c.p->code[c.p->codeLen++] = {op, dst, ra, rb};
+  a.isConst = false;
+  a.reg = dst;
+}
+
+static FxOperand fxExpr(FxCompiler& c);
+
+static FxOperand fxNumber(FxCompiler& c)
+{
+  FxOperand o = {true, 0, 0};
+  int32_t ip = 0;
+  while (isdigit(*c.s)) {
+    ip = ip * 10 + (*c.s++ - '0');
+    if (ip > 32767) { fxError(c, "number too large"); return o; }
+  }
+  uint32_t frac = 0, div = 1;
+  if (*c.s == '.') {
+    c.s++;
+    while (isdigit(*c.s)) {
+      if (div < 1000000) { frac = frac * 10 + (*c.s - '0'); div *= 10; }
+      c.s++;
+    }
+  }
+  o.value = (ip << 16) + (int32_t)(((uint64_t)frac << 16) / div);
+  return o;
+}
+
+static FxOperand fxPrimary(FxCompiler& c)
+{
+  FxOperand o = {true, 0, 0};
+  fxSkip(c);
+  if (c.err) return o;
+  if (isdigit(*c.s) || *c.s == '.') return fxNumber(c);
+  if (fxAccept(c, '(')) {
+    o = fxExpr(c);
+    fxExpect(c, ')');
+    return o;
+  }
+
+  char name[8];
+  const char* start = c.s;
+  uint8_t len = fxIdent(c, name, sizeof(name));
+  if (!len) { fxError(c, "value expected"); return o; }
+  c.s += len;
+  if (!strcmp(name, "pi")) { o.value = 205887; return o; }
+  for (uint8_t i = 0; i < sizeof(fxVars)/sizeof(fxVars[0]); i++) {
+    if (strcmp(name, fxVars[i].name)) continue;
+    o.isConst = false;
+    o.reg = fxVars[i].val;
+    return o;
+  }
+  for (uint8_t i = 0; i < sizeof(fxFuncs)/sizeof(fxFuncs[0]); i++) {
+    if (strcmp(name, fxFuncs[i].name)) continue;
+    if (!fxAccept(c, '(')) { fxError(c, "'(' expected"); return o; }
+    o = fxExpr(c);
+    FxOperand b = o;
+    if (fxFuncs[i].args == 2) {
+      fxExpect(c, ',');
+      b = fxExpr(c);
+    }
+    fxExpect(c, ')');
+    fxEmit(c, fxFuncs[i].val, o, b);
+    return o;
+  }
+  c.s = start;
+  fxError(c, "unknown name");
+  return o;
+}
+
+static FxOperand fxUnary(FxCompiler& c)
+{
+  if (fxAccept(c, '-')) {
+    FxOperand o = fxUnary(c);
+    fxEmit(c, FXOP_NEG, o, o);
+    return o;
+  }
+  fxAccept(c, '+');
+  return fxPrimary(c);
+}
+
+static FxOperand fxTerm(FxCompiler& c)
+{
+  FxOperand a = fxUnary(c);
+  while (!c.err) {
+    uint8_t op;
+    if      (fxAccept(c, '*')) op = FXOP_MUL;
+    else if (fxAccept(c, '/')) op = FXOP_DIV;
+    else if (fxAccept(c, '%')) op = FXOP_MOD;
+    else break;
+    FxOperand b = fxUnary(c);
+    fxEmit(c, op, a, b);
+  }
+  return a;
+}
+
+static FxOperand fxSum(FxCompiler& c)
+{
+  FxOperand a = fxTerm(c);
+  while (!c.err) {
+    uint8_t op;
+    if      (fxAccept(c, '+')) op = FXOP_ADD;
+    else if (fxAccept(c, '-')) op = FXOP_SUB;
+    else break;
+    FxOperand b = fxTerm(c);
+    fxEmit(c, op, a, b);
+  }
+  return a;
+}
+
+static FxOperand fxExpr(FxCompiler& c)
+{
+  FxOperand a = fxSum(c);
+  while (!c.err) {
+    uint8_t op;
+    if      (fxAccept(c, '<')) op = FXOP_LT;
+    else if (fxAccept(c, '>')) op = FXOP_GT;
+    else break;
+    FxOperand b = fxSum(c);
+    fxEmit(c, op, a, b);
+  }
+  return a;
+}
+
+static uint8_t fxResolve(const FxProgram* p, uint8_t r)
+{
+  if (r & FXREG_TEMP)  return FXVM_VAR_COUNT + p->constCount + (r & 0x3F);
+  if (r & FXREG_CONST) return FXVM_VAR_COUNT + (r & 0x3F);
+  return r;
+}
+
+int16_t fxvmCompile(const char* src, FxProgram* p, const char** err)
+{
+  memset(p, 0, sizeof(FxProgram));
+  FxCompiler c = {src, src, p, 0, 0, nullptr, nullptr};
+  FxOperand res[3];
+
+  char name[4];
+  uint8_t len = fxIdent(c, name, sizeof(name));
+  const char* after = c.s + len;
+  while (*after == ' ') after++;
+  if (*after == '(' && len == 3 && (!strcmp(name, "hsv") || !strcmp(name, "rgb"))) {
+    p->out = (name[0] == 'h') ? FXVM_OUT_HSV : FXVM_OUT_RGB;
+    c.s = after +1;
+    for (uint8_t i = 0; i < 3; i++) {
+      if (i) fxExpect(c, ',');
+      res[i] = fxExpr(c);
+    }
+    fxExpect(c, ')');
+  } else {
+    p->out = FXVM_OUT_PALETTE;
+    res[0] = res[1] = res[2] = fxExpr(c);
+  }
+  fxSkip(c);
+  if (*c.s) fxError(c, "unexpected character");
+
+  for (uint8_t i = 0; i < 3 && !c.err; i++) p->res[i] = fxReg(c, res[i]);
+  p->regCount = FXVM_VAR_COUNT + p->constCount + c.maxTemps;
+  if (p->regCount > FXVM_MAX_REGS) fxError(c, "expression too complex");
+  if (c.err) {
+    if (err) *err = c.err;
+    return c.errAt - src;
+  }
+
+  for (uint8_t i = 0; i < p->codeLen; i++) {
+    p->code[i].dst = fxResolve(p, p->code[i].dst);
+    p->code[i].a   = fxResolve(p, p->code[i].a);
+    p->code[i].b   = fxResolve(p, p->code[i].b);
+  }
+  for (uint8_t i = 0; i < 3; i++) p->res[i] = fxResolve(p, p->res[i]);
+  return -1;
+}
+
+/*
+ * Storage
+ */
+
+static void fxvmPath(char* path, uint8_t id)
+{
+  sprintf_P(path, PSTR("/fx%d.txt"), id);
+}
+
+bool fxvmLoad(uint8_t id, FxProgram* p)
+{
+  char path[12];
+  fxvmPath(path, id);
+  if (!WLED_FS.exists(path)) return false;
+  File f = WLED_FS.open(path, "r");
+  if (!f) return false;
+  char src[FXVM_MAX_SRC +1];
+  size_t len = f.readBytes(src, FXVM_MAX_SRC);
+  f.close();
+  src[len] = 0;
+
+  const char* err = nullptr;
+  int16_t pos = fxvmCompile(src, p, &err);
+  if (pos < 0) return true;
+  DEBUG_PRINTF("Expression %d: %s at %d\n", id, err, pos);
+  return false;
+}
+
+//compiles the expression and stores it if it is valid
+bool fxvmSave(uint8_t id, const char* src)
+{
+  if (!src || strlen(src) > FXVM_MAX_SRC) return false;
+  FxProgram* p = (FxProgram*) malloc(sizeof(FxProgram));
+  if (!p) return false;
+  const char* err = nullptr;
+  int16_t pos = fxvmCompile(src, p, &err);
+  free(p);
+  if (pos >= 0) {
+    DEBUG_PRINTF("Expression %d: %s at %d\n", id, err, pos);
+    return false;
+  }
+
+  char path[12];
+  fxvmPath(path, id);
+  File f = WLED_FS.open(path, "w");
+  if (!f) return false;
+  metricFsBytesWritten += f.print(src);
+  f.close();
+  fxvmInvalidate();
+  return true;
+}
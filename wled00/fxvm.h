@@ -0,0 +1,64 @@
+#ifndef WLED_FXVM_H
+#define WLED_FXVM_H
+/*
+ * Bytecode of the Expression effect (see fxvm.cpp)
+ * Values are 16.16 fixed point. Registers hold FXVM_SPAN lanes, one per pixel, and every instruction
+ * is applied to all lanes of a span before the next one is dispatched.
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+#define FXVM_MAX_SRC   256 //characters of an expression
+#define FXVM_MAX_CODE   64 //instructions
+#define FXVM_MAX_REGS   32 //variables, constants and temporaries
+#ifdef ESP8266
+  #define FXVM_SPAN     16 //pixels evaluated per instruction dispatch
+#else
+  #define FXVM_SPAN     32
+#endif
+#ifndef FXVM_FRAME_BUDGET_US
+  #define FXVM_FRAME_BUDGET_US 10000 //the rest of the segment is calculated in the next frame
+#endif
+
+//variable registers, i/x/y are set per pixel, the others once per frame
+#define FXVM_VAR_I      0
+#define FXVM_VAR_X      1
+#define FXVM_VAR_Y      2
+#define FXVM_VAR_T      3
+#define FXVM_VAR_LEN    4
+#define FXVM_VAR_W      5
+#define FXVM_VAR_H      6
+#define FXVM_VAR_SX     7
+#define FXVM_VAR_IX     8
+#define FXVM_VAR_COUNT  9
+
+#define FXVM_OUT_PALETTE 0 //result is a position in the palette, 0-1
+#define FXVM_OUT_HSV     1 //hsv(h,s,v), 0-1 each
+#define FXVM_OUT_RGB     2 //rgb(r,g,b), 0-1 each
+
+typedef struct FxInstr {
+  uint8_t op, dst, a, b;
+} fx_instr;
+
+typedef struct FxProgram {
+  uint8_t  out;        //FXVM_OUT_*
+  uint8_t  codeLen;
+  uint8_t  constCount; //constants are in the registers after the variables
+  uint8_t  regCount;
+  uint8_t  res[3];     //registers holding the result
+  fx_instr code[FXVM_MAX_CODE];
+  int32_t  consts[FXVM_MAX_REGS];
+
+  //the register lanes follow the program in segment data
+  int32_t* lane(uint8_t r) { return reinterpret_cast<int32_t*>(this + 1) + r * FXVM_SPAN; }
+} fx_program;
+
+int16_t fxvmCompile(const char* src, FxProgram* p, const char** err); //-1 if ok, else position of the error
+bool    fxvmLoad(uint8_t id, FxProgram* p);
+uint8_t fxvmVersion();
+size_t  fxvmDataSize(const FxProgram* p);
+void    fxvmInit(FxProgram* p);
+void    fxvmSetUniforms(FxProgram* p, uint32_t ms, uint16_t len, uint16_t w, uint16_t h, uint8_t speed, uint8_t intensity);
+void    fxvmRun(FxProgram* p, uint16_t first, uint16_t n, uint16_t w, uint32_t* out);
+
+#endif
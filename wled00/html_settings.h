@@ -268,7 +268,8 @@ name="R5"></td><td><input type="checkbox" id="R6" name="R6"></td><td><input
 type="checkbox" id="R7" name="R7"></td><td><input type="checkbox" id="R8" 
 name="R8"></td></tr></table><br>Receive: <input type="checkbox" name="RB">
 Brightness, <input type="checkbox" name="RC">Color, and <input type="checkbox" 
-name="RX">Effects<br>Send notifications on direct change: <input 
+name="RX">Effects<br>Receive segment bounds and grouping: <input 
+type="checkbox" name="RL"><br>Send notifications on direct change: <input 
 type="checkbox" name="SD"><br>Send notifications on button press or IR: <input 
 type="checkbox" name="SB"><br>Send Alexa notifications: <input type="checkbox" 
 name="SA"><br>Send Philips Hue change notifications: <input type="checkbox" 
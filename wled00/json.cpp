@@ -25,6 +25,14 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
 {
   byte id = elem["id"] | it;
   if (id >= strip.getMaxSegments()) return;
+  if (id >= strip.getSegmentsNum()) { //segment does not exist yet, only create it if it gets bounds
+    int stop = elem["stop"] | -1;
+    if (stop <= (elem["start"] | 0) && !elem[F("len")]) return;
+  }
+  if (!strip.useSegment(id)) { //no storage for this ID yet, the loop allocates it
+    queueSegment(elem, id, presetId);
+    return;
+  }
 
   WS2812FX::Segment& seg = strip.getSegment(id);
   //WS2812FX::Segment prev;
@@ -78,6 +86,22 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
   if (stop > start && of > len -1) of = len -1;
 	strip.setSegment(id, start, stop, grp, spc, of);
 
+  //2D matrix, w is the number of LEDs per row (0 for 1D)
+  uint16_t width = elem["w"] | seg.width;
+  if (width > seg.length()) width = 0;
+  seg.width = width;
+  if (elem.containsKey(F("serp"))) seg.layout = (seg.layout & ~SEG_LAYOUT_SERPENTINE) | (elem[F("serp")] ? SEG_LAYOUT_SERPENTINE : 0);
+  if (elem.containsKey(F("tp")))   seg.layout = (seg.layout & ~SEG_LAYOUT_TRANSPOSE)  | (elem[F("tp")]   ? SEG_LAYOUT_TRANSPOSE  : 0);
+  seg.program = elem[F("prog")] | seg.program; //Expression effect program
+  uint8_t rs = elem[F("rs")] | seg.scale; //render scale of smooth effects
+  seg.scale = MIN(rs, MAX_RENDER_SCALE);
+  uint8_t ri = elem[F("ri")] | (uint8_t)seg.getOption(SEG_OPTION_CUBIC); //interpolation: 0 linear, 1 cubic
+  seg.setOption(SEG_OPTION_CUBIC, ri == 1);
+  if (elem.containsKey(F("cln"))) { //show the output of another segment, -1 to run an own effect again
+    int cln = elem[F("cln")] | -1;
+    seg.clone = (cln >= 0 && cln < strip.getMaxSegments() && cln != id) ? cln + 1 : 0;
+  }
+
   byte segbri = 0;
   if (getVal(elem["bri"], &segbri)) {
     if (segbri > 0) seg.setOpacity(segbri, id);
@@ -210,13 +234,8 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
         }
 
         if (set < 2) stop = start + 1;
-        for (uint16_t i = start; i < stop; i++) {
-          if (strip.gammaCorrectCol) {
-            strip.setPixelColor(i, strip.gamma8(rgbw[0]), strip.gamma8(rgbw[1]), strip.gamma8(rgbw[2]), strip.gamma8(rgbw[3]));
-          } else {
-            strip.setPixelColor(i, rgbw[0], rgbw[1], rgbw[2], rgbw[3]);
-          }
-        }
+        uint32_t c = strip.gamma32(RGBW32(rgbw[0], rgbw[1], rgbw[2], rgbw[3]));
+        for (uint16_t i = start; i < stop; i++) strip.setPixelColor(i, c);
         if (!set) start++;
         set = 0;
       }
@@ -229,6 +248,55 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
   return; // seg.differs(prev);
 }
 
+/*
+ * Segments for IDs without storage, e.g. from a network callback, where the segment storage must not move.
+ * They are kept as a JSON array of [id, presetId, {segment}] and applied from the loop in handleSegmentQueue().
+ * Only touched with the JSON buffer lock held.
+ */
+static char* segQueue = nullptr;
+static uint16_t segQueueLen = 0;
+static byte segQueueMaxId = 0;
+
+void queueSegment(JsonObject elem, byte id, byte presetId)
+{
+  char head[12];
+  uint8_t headLen = sprintf(head, "%c[%u,%u,", segQueue ? ',' : '[', id, presetId);
+  size_t len = measureJson(elem);
+  char* q = (char*) realloc(segQueue, segQueueLen + headLen + len + 3); //entry and closing brackets
+  if (q == nullptr) return;
+  memcpy(q + segQueueLen, head, headLen);
+  segQueueLen += headLen;
+  segQueueLen += serializeJson(elem, q + segQueueLen, len +1);
+  strcpy(q + segQueueLen, "]]");
+  segQueueLen++; //the next entry replaces the array end
+  segQueue = q;
+  if (id > segQueueMaxId) segQueueMaxId = id;
+}
+
+//do not call this method from system context (network callback)
+void handleSegmentQueue()
+{
+  if (segQueue == nullptr || jsonBufferLock) return;
+  bool allocated = strip.ensureSegment(segQueueMaxId); //storage for all queued IDs
+  if (!allocated && jsonBufferLock) return; //a JSON request came in meanwhile, retried
+  #ifdef WLED_USE_DYNAMIC_JSON
+  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  #else
+  if (!requestJSONBufferLock(19)) return;
+  #endif
+  char* q = segQueue; //entries queued from now on go to a new queue
+  segQueue = nullptr;
+  segQueueLen = 0;
+  segQueueMaxId = 0;
+  strip.applyToAllSelected = false;
+  if (allocated && !deserializeJson(doc, q)) { //not retried if there is no memory for the segments
+    for (JsonArray entry : doc.as<JsonArray>()) deserializeSegment(entry[2], entry[0], entry[1]);
+  }
+  releaseJSONBufferLock();
+  free(q);
+  if (allocated) colorUpdated(CALL_MODE_DIRECT_CHANGE);
+}
+
 bool deserializeState(JsonObject root, byte callMode, byte presetId)
 {
   strip.applyToAllSelected = false;
@@ -286,6 +354,10 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   realtimeOverride = root[F("lor")] | realtimeOverride;
   if (realtimeOverride > 2) realtimeOverride = REALTIME_OVERRIDE_ALWAYS;
 
+  //store an Expression effect program, {"expr":{"id":1,"src":"hsv(t*0.1 + i/len, 1, 1)"}}
+  JsonObject expr = root[F("expr")];
+  if (!expr.isNull()) fxvmSave(expr["id"] | 0, expr[F("src")].as<const char*>());
+
   if (root.containsKey("live")) {
     bool lv = root["live"];
     if (lv) realtimeLock(65000); //enter realtime without timeout
@@ -304,13 +376,13 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     
     if (id < 0) { //set all selected segments
       bool didSet = false;
-      byte lowestActive = 99;
-      for (byte s = 0; s < strip.getMaxSegments(); s++)
+      byte lowestActive = 255;
+      for (byte s = 0; s < strip.getSegmentsNum(); s++)
       {
         WS2812FX::Segment sg = strip.getSegment(s);
         if (sg.isActive())
         {
-          if (lowestActive == 99) lowestActive = s;
+          if (lowestActive == 255) lowestActive = s;
           if (sg.isSelected()) {
             deserializeSegment(segVar, s, presetId);
             didSet = true;
@@ -390,6 +462,17 @@ void serializeSegment(JsonObject& root, WS2812FX::Segment& seg, byte id, bool fo
   root["grp"] = seg.grouping;
   root[F("spc")] = seg.spacing;
   root[F("of")] = seg.offset;
+  if (seg.width) {
+    root["w"] = seg.width;
+    root[F("serp")] = (bool)(seg.layout & SEG_LAYOUT_SERPENTINE);
+    root[F("tp")]   = (bool)(seg.layout & SEG_LAYOUT_TRANSPOSE);
+  }
+  if (seg.program) root[F("prog")] = seg.program;
+  if (seg.scale > 1) {
+    root[F("rs")] = seg.scale;
+    root[F("ri")] = (uint8_t)seg.getOption(SEG_OPTION_CUBIC);
+  }
+  if (seg.clone) root[F("cln")] = seg.clone - 1;
   root["on"] = seg.getOption(SEG_OPTION_ON);
   byte segbri = seg.opacity;
   root["bri"] = (segbri) ? segbri : 255;
@@ -466,7 +549,9 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   root[F("mainseg")] = strip.getMainSegmentId();
 
   JsonArray seg = root.createNestedArray("seg");
-  for (byte s = 0; s < strip.getMaxSegments(); s++)
+  //presets with segment bounds disable all other segment IDs
+  byte segNum = (forPreset && segmentBounds) ? strip.getMaxSegments() : strip.getSegmentsNum();
+  for (byte s = 0; s < segNum; s++)
   {
     WS2812FX::Segment sg = strip.getSegment(s);
     if (sg.isActive())
@@ -520,8 +605,25 @@ void serializeInfo(JsonObject root)
 
   leds[F("pwr")] = strip.currentMilliamps;
   leds[F("fps")] = strip.getFps();
+  leds[F("tfps")] = strip.getTargetFps();
+  JsonObject ftime = leds.createNestedObject(F("ftime")); //frame time in ms
+  ftime[F("p50")]  = strip.getFrameTimePercentile(50);
+  ftime[F("p95")]  = strip.getFrameTimePercentile(95);
+  ftime[F("p99")]  = strip.getFrameTimePercentile(99);
+  ftime[F("max")]  = strip.getFrameTimeMax();
+  ftime[F("miss")] = strip.getMissedFrames();
   leds[F("maxpwr")] = (strip.currentMilliamps)? strip.ablMilliampsMax : 0;
+  JsonArray bpwr = leds.createNestedArray(F("bpwr")); //estimated current per bus
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) bpwr.add(busses.getBus(b)->getMilliamps());
   leds[F("maxseg")] = strip.getMaxSegments();
+  JsonObject segdata = leds.createNestedObject(F("segdata")); //effect data arena
+  segdata[F("used")]  = strip.getSegmentDataUsed();
+  segdata[F("peak")]  = strip.getSegmentDataPeak();
+  segdata[F("size")]  = strip.getSegmentDataSize();
+  segdata[F("max")]   = MAX_SEGMENT_DATA;
+  segdata[F("frag")]  = strip.getSegmentDataFragmentation();
+  segdata[F("cmp")]   = strip.getSegmentDataCompactions();
+  segdata[F("fail")]  = strip.getSegmentDataFails();
   //leds[F("seglock")] = false; //might be used in the future to prevent modifications to segment config
 
   root[F("str")] = syncToggleReceive;
@@ -571,6 +673,7 @@ void serializeInfo(JsonObject root)
   fs_info[F("pmt")] = presetsModifiedTime;
 
   root[F("ndc")] = nodeListEnabled ? (int)Nodes.size() : -1;
+  serializeTimeSync(root);
   
   #ifdef ARDUINO_ARCH_ESP32
   #ifdef WLED_DEBUG
@@ -801,6 +904,12 @@ void serializeNodes(JsonObject root)
       node["ip"]      = it->second.ip.toString();
       node[F("age")]  = it->second.age;
       node[F("vid")]  = it->second.build;
+      if (it->second.syncValid) { //timebase sync, in us
+        JsonObject tsync = node.createNestedObject(F("tsync"));
+        tsync[F("ofs")] = it->second.syncOffset;
+        tsync[F("jit")] = it->second.syncJitter;
+        tsync[F("rtt")] = it->second.syncRtt;
+      }
     }
   }
 }
@@ -818,6 +927,16 @@ void serveJson(AsyncWebServerRequest* request)
     serveLiveLeds(request);
     return;
   }
+#ifndef WLED_DISABLE_PROFILER
+  else if (url.indexOf(F("perf")) > 0 || url.indexOf(F("trace")) > 0) {
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    if (url.indexOf(F("trace")) > 0) profiler.printTrace(*response);
+    else                             profiler.printJson(*response);
+    request->send(response);
+    if (request->hasArg(F("reset"))) profiler.reset();
+    return;
+  }
+#endif
   else if (url.indexOf(F("eff")) > 0) {
     request->send_P(200, "application/json", JSON_mode_names);
     return;
@@ -881,7 +1000,11 @@ bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
   if (!request) { //not HTTP, use Websockets
     #ifdef WLED_ENABLE_WEBSOCKETS
     wsc = ws.client(wsClient);
-    if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
+    if (!wsc) return false;
+    if (wsc->queueLength() > 0) { //only send if queue free
+      metricWsDrops++;
+      return false;
+    }
     #endif
   }
 
@@ -86,6 +86,10 @@ void colorUpdated(int callMode)
 
   if (callMode == CALL_MODE_NOTIFICATION) {
     someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
+    if (notificationSegmentSync) { //segments were set by the notification itself
+      strip.applyToAllSelected = false;
+      someSel = false;
+    }
   }
   
   //Notifier: apply received FX to selected segments only if actually receiving FX
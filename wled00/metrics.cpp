@@ -0,0 +1,100 @@
+#include "wled.h"
+
+/*
+ * Prometheus text exposition format at /metrics
+ * Written directly into the response stream, does not use the JSON buffer.
+ * Lines must end with \n only, so println() is not used.
+ */
+
+static const char* const metricProtoNames[METRIC_PROTO_COUNT] = {
+  "sync", "udp", "hyperion", "e131", "artnet", "ddp"
+};
+
+static void metricHeader(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* type, const __FlashStringHelper* help)
+{
+  out.print(F("# HELP wled_")); out.print(name); out.print(' '); out.print(help); out.print('\n');
+  out.print(F("# TYPE wled_")); out.print(name); out.print(' '); out.print(type); out.print('\n');
+}
+
+static void metricValue(Print& out, const __FlashStringHelper* name, uint32_t value, const char* proto = nullptr)
+{
+  out.print(F("wled_")); out.print(name);
+  if (proto) {
+    out.print(F("{protocol=\"")); out.print(proto); out.print(F("\"}"));
+  }
+  out.print(' '); out.print(value); out.print('\n');
+}
+
+static void metric(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* type, const __FlashStringHelper* help, uint32_t value)
+{
+  metricHeader(out, name, type, help);
+  metricValue(out, name, value);
+}
+
+static void metricSeconds(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* help, uint64_t micros)
+{
+  metricHeader(out, name, F("counter"), help);
+  out.print(F("wled_")); out.print(name); out.print(' '); out.print(micros / 1000000.0, 6); out.print('\n');
+}
+
+static void metricPerProto(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* help, uint32_t* values)
+{
+  metricHeader(out, name, F("counter"), help);
+  for (uint8_t i = 0; i < METRIC_PROTO_COUNT; i++) metricValue(out, name, values[i], metricProtoNames[i]);
+}
+
+void serveMetrics(AsyncWebServerRequest* request)
+{
+  AsyncResponseStream *response = request->beginResponseStream(F("text/plain; version=0.0.4"));
+  Print& out = *response;
+
+  metric(out, F("uptime_seconds"), F("counter"), F("Time since boot"), millis() / 1000);
+
+  //render
+  metric(out, F("frames_rendered_total"), F("counter"), F("Frames calculated by effects"), strip.getFramesRendered());
+  metric(out, F("frames_shown_total"), F("counter"), F("Frames sent to the LEDs"), strip.getFramesShown());
+  metric(out, F("frames_missed_total"), F("counter"), F("Frames that took longer than the target frame time"), strip.getMissedFrames());
+  metric(out, F("fps"), F("gauge"), F("Current frames per second"), strip.getFps());
+  metricSeconds(out, F("effect_seconds_total"), F("Time spent calculating effects"), strip.getEffectMicros());
+  metricSeconds(out, F("show_seconds_total"), F("Time spent sending frames to the LEDs"), strip.getShowMicros());
+  metric(out, F("power_milliamps"), F("gauge"), F("Estimated current draw"), strip.currentMilliamps);
+
+  metric(out, F("segment_data_used_bytes"), F("gauge"), F("Effect data in use"), strip.getSegmentDataUsed());
+  metric(out, F("segment_data_peak_bytes"), F("gauge"), F("Highest effect data use since boot"), strip.getSegmentDataPeak());
+  metric(out, F("segment_data_size_bytes"), F("gauge"), F("Memory allocated for effect data"), strip.getSegmentDataSize());
+  metric(out, F("segment_data_compactions_total"), F("counter"), F("Effect data arena compactions"), strip.getSegmentDataCompactions());
+  metric(out, F("segment_data_failures_total"), F("counter"), F("Effect data allocations that failed"), strip.getSegmentDataFails());
+
+  //network
+  metricPerProto(out, F("packets_received_total"), F("UDP packets received"), metricPacketsRx);
+  metricPerProto(out, F("packets_dropped_total"), F("UDP packets received but not applied"), metricPacketsDropped);
+  metricPerProto(out, F("packets_out_of_sequence_total"), F("UDP packets skipped because they arrived out of sequence"), metricPacketsOutOfSeq);
+  metric(out, F("realtime_queue_drops_total"), F("counter"), F("E1.31, Art-Net and DDP packets dropped because the queue was full"), metricE131QueueDrops);
+  #ifdef WLED_ENABLE_WEBSOCKETS
+  metric(out, F("ws_clients"), F("gauge"), F("Connected WebSocket clients"), ws.count());
+  #endif
+  metric(out, F("ws_queue_drops_total"), F("counter"), F("WebSocket messages not sent because of a full queue"), metricWsDrops);
+  metricHeader(out, F("wifi_rssi_dbm"), F("gauge"), F("WiFi signal strength"));
+  out.print(F("wled_wifi_rssi_dbm ")); out.print(WiFi.RSSI()); out.print('\n');
+
+  //JSON API and storage
+  metric(out, F("json_lock_waits_total"), F("counter"), F("JSON buffer requests that had to wait"), metricJsonLockWaits);
+  metric(out, F("json_lock_timeouts_total"), F("counter"), F("JSON buffer requests that timed out"), metricJsonLockTimeouts);
+  metric(out, F("preset_loads_total"), F("counter"), F("Presets applied"), metricPresetLoads);
+  metricSeconds(out, F("preset_load_seconds_total"), F("Time spent loading presets"), (uint64_t)metricPresetLoadMillis * 1000);
+  metric(out, F("fs_bytes_written_total"), F("counter"), F("Bytes written to the filesystem"), metricFsBytesWritten);
+  metric(out, F("fs_bytes_used"), F("gauge"), F("Used filesystem space"), fsBytesUsed);
+
+  //memory
+  metric(out, F("heap_free_bytes"), F("gauge"), F("Free heap"), ESP.getFreeHeap());
+  #ifdef ESP8266
+  metric(out, F("heap_largest_free_block_bytes"), F("gauge"), F("Largest allocatable heap block"), ESP.getMaxFreeBlockSize());
+  #else
+  metric(out, F("heap_largest_free_block_bytes"), F("gauge"), F("Largest allocatable heap block"), ESP.getMaxAllocHeap());
+    #ifdef WLED_USE_PSRAM
+    if (psramFound()) metric(out, F("psram_free_bytes"), F("gauge"), F("Free PSRAM"), ESP.getFreePsram());
+    #endif
+  #endif
+
+  request->send(response);
+}
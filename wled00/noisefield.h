@@ -0,0 +1,30 @@
+#ifndef WLED_NOISEFIELD_H
+#define WLED_NOISEFIELD_H
+/*
+ * Batched Perlin noise (see FX_noise.cpp)
+ * Same 3D field as FastLED inoise16(x,y,z): 65536 units per lattice cell, output 0-65535.
+ * A row of samples starts at x/y and advances by dx/dy per sample, z is the same for the whole row.
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+#define NOISE_CHUNK 32 //samples calculated at once by effects that do not cache the field
+
+void fillNoise16(uint16_t* out, uint16_t len, uint32_t x, uint32_t dx, uint32_t y, uint32_t dy, uint32_t z);
+void fillNoise8(uint8_t* out, uint16_t len, uint32_t x, uint32_t dx, uint32_t y, uint32_t dy, uint32_t z, bool wrap16 = false); //upper byte only, wrap16: x and y wrap like uint16_t
+void fillNoise16_2D(uint16_t* out, uint16_t len, uint32_t x, uint32_t dx, uint32_t y); //FastLED inoise16(x,y), y is the same for the whole row
+
+//8 bit noise of a whole w x h canvas, kept in segment data and only recalculated if the coordinates changed
+typedef struct NoiseField {
+  uint32_t x, y, z;   //first sample
+  uint32_t dx, dy;    //step between samples of a row
+  uint32_t rowDy;     //step in y from one row to the next (rows start at x)
+  uint16_t w, h;
+  bool     valid;
+
+  static size_t size(uint16_t len) { return sizeof(NoiseField) + len; }
+  uint8_t* values() { return reinterpret_cast<uint8_t*>(this + 1); }
+  const uint8_t* fill(uint16_t w, uint16_t h, uint32_t x, uint32_t dx, uint32_t y, uint32_t dy, uint32_t rowDy, uint32_t z);
+} noise_field;
+
+#endif
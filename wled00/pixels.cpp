@@ -0,0 +1,212 @@
+#include "wled.h"
+
+/*
+ * Binary per-pixel upload (HTTP POST /pixels and WebSocket binary messages)
+ *
+ * Packet layout:
+ *  0: segment ID
+ *  1: start offset within the segment (virtual pixels), MSB
+ *  2: start offset within the segment, LSB
+ *  3: pixel format (PIXEL_FORMAT_*, see const.h)
+ *  4: palette entry count (only PIXEL_FORMAT_PALETTE, 0 means 256)
+ *  then the payload:
+ *   RGB:     R,G,B per pixel
+ *   RGBW:    R,G,B,W per pixel
+ *   PALETTE: palette entries as R,G,B, followed by one palette index per pixel
+ *   RLE:     runs of count,R,G,B (count 0 is skipped)
+ *
+ * The data may arrive in chunks of any size (HTTP body, fragmented WS message),
+ * pixels split between two chunks are carried over.
+ * Like the JSON "i" API, the segment is frozen and cleared on the first upload.
+ */
+
+static uint8_t pixelUploadHeaderLen(PixelUpload* up)
+{
+  if (up->headerLen >= 4 && up->header[3] == PIXEL_FORMAT_PALETTE) return 5;
+  return 4;
+}
+
+uint8_t pixelElementLen(uint8_t format)
+{
+  switch (format) {
+    case PIXEL_FORMAT_RGBW:    return 4;
+    case PIXEL_FORMAT_PALETTE: return 1;
+    case PIXEL_FORMAT_RLE:     return 4;
+  }
+  return 3; //RGB
+}
+
+//writes one pixel (or one RLE run) from el to set(), pixels from len on are dropped, returns the pixel after it
+uint16_t decodePixelElement(uint8_t format, const uint8_t* el, uint16_t pix, uint16_t len, const uint8_t* pal, uint16_t palBytes, PixelSetter set)
+{
+  switch (format) {
+    case PIXEL_FORMAT_RGBW:
+      if (pix < len) set(pix, el[0], el[1], el[2], el[3]);
+      return pix +1;
+    case PIXEL_FORMAT_PALETTE: {
+      uint16_t p = el[0] * 3;
+      if (pix < len) {
+        if (p + 2 < palBytes) set(pix, pal[p], pal[p+1], pal[p+2], 0);
+        else                  set(pix, 0, 0, 0, 0); //index outside of transmitted palette
+      }
+      return pix +1;
+      }
+    case PIXEL_FORMAT_RLE:
+      for (uint8_t n = 0; n < el[0] && pix < len; n++) set(pix++, el[1], el[2], el[3], 0);
+      return pix;
+  }
+  if (pix < len) set(pix, el[0], el[1], el[2], 0); //RGB
+  return pix +1;
+}
+
+static void setUploadPixel(uint16_t i, byte r, byte g, byte b, byte w)
+{
+  strip.setPixelColor(i, strip.gamma32(RGBW32(r, g, b, w)));
+}
+
+//only call with setPixelSegment() set
+static inline void writeUploadElement(PixelUpload* up, const uint8_t* el, uint16_t segLen)
+{
+  up->pix = decodePixelElement(up->header[3], el, up->pix, segLen, up->pal, up->palLen, setUploadPixel);
+}
+
+void pixelUploadBegin(PixelUpload* up)
+{
+  up->headerLen = 0;
+  up->carryLen = 0;
+  up->pix = 0;
+  up->palBytes = 0;
+  up->palLen = 0;
+  up->error = false;
+}
+
+bool pixelUploadFeed(PixelUpload* up, const uint8_t* data, size_t len)
+{
+  if (up->error) return false;
+
+  while (len && up->headerLen < pixelUploadHeaderLen(up)) {
+    up->header[up->headerLen++] = *data++; len--;
+    if (up->headerLen == 4) { //header complete, validate
+      uint8_t id = up->header[0];
+      if (id >= strip.getMaxSegments() || !strip.getSegment(id).isActive() || up->header[3] > PIXEL_FORMAT_RLE) {
+        up->error = true;
+        return false;
+      }
+      up->pix = (up->header[1] << 8) | up->header[2];
+    } else if (up->headerLen == 5) { //palette size
+      up->palBytes = (up->header[4] ? up->header[4] : 256) * 3;
+    }
+  }
+
+  //receive palette before any indices
+  if (len && up->palLen < up->palBytes) {
+    size_t n = up->palBytes - up->palLen;
+    if (n > len) n = len;
+    memcpy(up->pal + up->palLen, data, n);
+    up->palLen += n; data += n; len -= n;
+  }
+  if (!len) return true;
+
+  uint8_t id = up->header[0];
+  WS2812FX::Segment& seg = strip.getSegment(id);
+  strip.setPixelSegment(id);
+
+  //freeze and init to black
+  if (!seg.getOption(SEG_OPTION_FREEZE)) {
+    seg.setOption(SEG_OPTION_FREEZE, true);
+    strip.fill(0);
+  }
+
+  uint16_t segLen = seg.virtualLength();
+  uint8_t elLen = pixelElementLen(up->header[3]);
+
+  //complete pixel split between chunks
+  if (up->carryLen) {
+    while (up->carryLen < elLen && len) {
+      up->carry[up->carryLen++] = *data++; len--;
+    }
+    if (up->carryLen == elLen) {
+      writeUploadElement(up, up->carry, segLen);
+      up->carryLen = 0;
+    }
+  }
+
+  while (len >= elLen) {
+    writeUploadElement(up, data, segLen);
+    data += elLen; len -= elLen;
+  }
+
+  //keep remainder for next chunk
+  if (len) {
+    memcpy(up->carry, data, len);
+    up->carryLen = len;
+  }
+
+  strip.setPixelSegment(255);
+  return true;
+}
+
+bool pixelUploadEnd(PixelUpload* up)
+{
+  if (up->headerLen < pixelUploadHeaderLen(up)) up->error = true;
+  if (up->error) return false;
+  strip.trigger();
+  return true;
+}
+
+//convenience function for uploads received in a single buffer
+bool handlePixelUpload(const uint8_t* data, size_t len)
+{
+  PixelUpload* up = (PixelUpload*) malloc(sizeof(PixelUpload));
+  if (!up) return false;
+  pixelUploadBegin(up);
+  pixelUploadFeed(up, data, len);
+  bool success = pixelUploadEnd(up);
+  free(up);
+  return success;
+}
+
+/*
+ * Compressed UDP realtime frame, protocol byte 6
+ *  0: 6, 1: timeout in seconds, 2-3: index of the first LED (MSB first), 4: encoding
+ *  then the payload, as in uploads for the PIXEL_FORMAT_* encodings (a palette packet starts with its entry count),
+ *  or for the encodings that build on previous packets:
+ *   UDP_RT_ENC_DELTA:   op byte, bit 7 set skips (op & 0x7F) +1 LEDs, which keep the previous frame, else op +1 R,G,B follow
+ *   UDP_RT_ENC_INDEXED: one index per LED into the palette of the last PIXEL_FORMAT_PALETTE packet
+ * Pixels go through setRealtimePixel(), so offset, gamma and interpolation apply.
+ */
+static uint8_t* rtPalette = nullptr; //kept for UDP_RT_ENC_INDEXED packets
+static uint16_t rtPaletteBytes = 0;
+
+void decodeRealtimePixels(uint8_t enc, const uint8_t* d, uint16_t len, uint16_t id, uint16_t totalLen)
+{
+  uint16_t i = 0;
+  if (enc == UDP_RT_ENC_DELTA) {
+    while (i < len && id < totalLen) {
+      uint8_t op = d[i++];
+      uint8_t n = (op & 0x7F) +1;
+      if (op & 0x80) { id += n; continue; }
+      for (; n > 0 && i + 2 < len && id < totalLen; n--, i += 3) setRealtimePixel(id++, d[i], d[i+1], d[i+2], 0);
+      if (n) break; //truncated
+    }
+    return;
+  }
+  if (enc == PIXEL_FORMAT_PALETTE) {
+    if (!len) return;
+    uint16_t bytes = (d[0] ? d[0] : 256) * 3;
+    if (1 + bytes > len) return;
+    if (!rtPalette) rtPalette = (uint8_t*) malloc(768);
+    if (!rtPalette) return;
+    memcpy(rtPalette, d + 1, bytes);
+    rtPaletteBytes = bytes;
+    i = 1 + bytes;
+  } else if (enc == UDP_RT_ENC_INDEXED) {
+    if (!rtPalette) return; //no palette received yet
+    enc = PIXEL_FORMAT_PALETTE;
+  } else if (enc > PIXEL_FORMAT_RLE) return;
+
+  uint8_t elLen = pixelElementLen(enc);
+  for (; i + elLen <= len && id < totalLen; i += elLen) {
+    id = decodePixelElement(enc, d + i, id, totalLen, rtPalette, rtPaletteBytes, setRealtimePixel);
+  }
+}
@@ -9,6 +9,7 @@ bool applyPreset(byte index, byte callMode)
   if (index == 0) return false;
 
   const char *filename = index < 255 ? "/presets.json" : "/tmp.json";
+  unsigned long loadStart = millis();
 
 	uint8_t core = 1;
 	//crude way to determine if this was called by a network request
@@ -43,6 +44,9 @@ bool applyPreset(byte index, byte callMode)
     releaseJSONBufferLock();
   }
 
+  metricPresetLoads++;
+  metricPresetLoadMillis += millis() - loadStart;
+
   if (!errorFlag) {
     if (index < 255) currentPreset = index;
     return true;
@@ -0,0 +1,104 @@
+#include "wled.h"
+
+/*
+ * Main loop profiler, see profiler.h
+ */
+#ifndef WLED_DISABLE_PROFILER
+
+static const char profilerNames[] PROGMEM =
+  "loop\0time\0ir\0connection\0serial\0notifications\0transitions\0dmx\0userloop\0usermods\0"
+  "io\0alexa\0dns\0ota\0nightlight\0playlist\0hue\0blynk\0service\0mdns\0"
+  "mqtt\0businit\0ledmap\0ws\0statusled\0";
+
+//returns the name of handler id from the packed name list
+static const char* profilerName(uint8_t id)
+{
+  const char* p = profilerNames;
+  while (id--) p += strlen_P(p) + 1;
+  return p;
+}
+
+uint32_t Profiler::ticksPerUs()
+{
+  #ifdef ARDUINO
+  if (!_ticksPerUs) _ticksPerUs = ESP.getCpuFreqMHz();
+  #else
+  _ticksPerUs = 1;
+  #endif
+  return _ticksPerUs;
+}
+
+void Profiler::record(uint8_t id, uint32_t startTicks)
+{
+  if (id >= PROF_COUNT) return;
+  uint32_t dur = ticks() - startTicks;
+  ProfilerStat& s = _stats[id];
+  if (dur < s.minTicks || s.count == 0) s.minTicks = dur;
+  if (dur > s.maxTicks) s.maxTicks = dur;
+  s.totalTicks += dur;
+  s.count++;
+
+  if (dur < PROFILER_SPAN_MIN_US * ticksPerUs()) return;
+  ProfilerSpan& span = _spans[_spanPos];
+  span.durUs = dur / ticksPerUs();
+  span.startUs = nowUs() - span.durUs;
+  span.id = id;
+  _spanPos = (_spanPos + 1) % PROFILER_SPANS;
+  if (_spanCount < PROFILER_SPANS) _spanCount++;
+}
+
+void Profiler::reset()
+{
+  memset(_stats, 0, sizeof(_stats));
+  _spanPos = 0;
+  _spanCount = 0;
+}
+
+//writes {"handlers":[{"n":"loop","min":12,"avg":345,"max":6789,"cnt":1234},...],"spans":[[start,dur,"name"],...]} (times in us)
+void Profiler::printJson(Print& out)
+{
+  uint32_t tpu = ticksPerUs();
+  out.print(F("{\"handlers\":["));
+  bool first = true;
+  for (uint8_t i = 0; i < PROF_COUNT; i++) {
+    ProfilerStat& s = _stats[i];
+    if (!s.count) continue;
+    if (!first) out.print(',');
+    first = false;
+    out.print(F("{\"n\":\""));  out.print(FPSTR(profilerName(i)));
+    out.print(F("\",\"min\":")); out.print(s.minTicks / tpu);
+    out.print(F(",\"avg\":"));   out.print((uint32_t)(s.totalTicks / s.count / tpu));
+    out.print(F(",\"max\":"));   out.print(s.maxTicks / tpu);
+    out.print(F(",\"cnt\":"));   out.print(s.count);
+    out.print('}');
+  }
+  out.print(F("],\"spans\":["));
+  uint16_t start = (_spanPos + PROFILER_SPANS - _spanCount) % PROFILER_SPANS; //oldest span
+  for (uint16_t i = 0; i < _spanCount; i++) {
+    ProfilerSpan& sp = _spans[(start + i) % PROFILER_SPANS];
+    if (i) out.print(',');
+    out.print('['); out.print(sp.startUs);
+    out.print(','); out.print(sp.durUs);
+    out.print(F(",\"")); out.print(FPSTR(profilerName(sp.id))); out.print(F("\"]"));
+  }
+  out.print(F("]}"));
+}
+
+//writes the span ring buffer in Chrome trace event format ("X" complete events, times in us)
+void Profiler::printTrace(Print& out)
+{
+  out.print(F("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  uint16_t start = (_spanPos + PROFILER_SPANS - _spanCount) % PROFILER_SPANS;
+  for (uint16_t i = 0; i < _spanCount; i++) {
+    ProfilerSpan& sp = _spans[(start + i) % PROFILER_SPANS];
+    if (i) out.print(',');
+    out.print(F("{\"name\":\"")); out.print(FPSTR(profilerName(sp.id)));
+    out.print(F("\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":")); out.print(sp.startUs);
+    out.print(F(",\"dur\":")); out.print(sp.durUs);
+    out.print('}');
+  }
+  out.print(F("]}"));
+}
+
+Profiler profiler = Profiler();
+#endif
@@ -0,0 +1,124 @@
+#ifndef WLED_PROFILER_H
+#define WLED_PROFILER_H
+/*
+ * Low overhead timing of the main loop handlers (see WLED::loop())
+ * Keeps min/avg/max per handler and a ring buffer of recent slow spans.
+ * Served at /json/perf and as Chrome trace events (chrome://tracing, ui.perfetto.dev) at /json/trace
+ * Can be disabled with -D WLED_DISABLE_PROFILER
+ */
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#include <cstdint>
+#endif
+
+//profiled handlers, see profilerNames in profiler.cpp
+#define PROF_LOOP           0
+#define PROF_TIME           1
+#define PROF_IR             2
+#define PROF_CONNECTION     3
+#define PROF_SERIAL         4
+#define PROF_NOTIFICATIONS  5
+#define PROF_TRANSITIONS    6
+#define PROF_DMX            7
+#define PROF_USERLOOP       8
+#define PROF_USERMODS       9
+#define PROF_IO            10
+#define PROF_ALEXA         11
+#define PROF_DNS           12
+#define PROF_OTA           13
+#define PROF_NIGHTLIGHT    14
+#define PROF_PLAYLIST      15
+#define PROF_HUE           16
+#define PROF_BLYNK         17
+#define PROF_SERVICE       18
+#define PROF_MDNS          19
+#define PROF_MQTT          20
+#define PROF_BUSINIT       21
+#define PROF_LEDMAP        22
+#define PROF_WS            23
+#define PROF_STATUSLED     24
+#define PROF_COUNT         25
+
+#ifndef PROFILER_SPANS
+  #ifdef ESP8266
+    #define PROFILER_SPANS   32
+  #else
+    #define PROFILER_SPANS  128
+  #endif
+#endif
+#define PROFILER_SPAN_MIN_US 1000 //only spans at least this long are kept in the ring buffer
+
+struct ProfilerStat {
+  uint32_t minTicks;
+  uint32_t maxTicks;
+  uint32_t count;
+  uint64_t totalTicks;
+};
+
+struct ProfilerSpan {
+  uint32_t startUs;
+  uint32_t durUs;
+  uint8_t  id;
+};
+
+class Profiler {
+  public:
+    //cycle counter on target, microseconds on host
+    static inline uint32_t ticks() {
+      #ifdef ARDUINO
+      return ESP.getCycleCount();
+      #else
+      return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      #endif
+    }
+
+    static inline uint32_t nowUs() {
+      #ifdef ARDUINO
+      return micros();
+      #else
+      return ticks();
+      #endif
+    }
+
+    //adds the time elapsed since startTicks to the statistics of handler id
+    void record(uint8_t id, uint32_t startTicks);
+    void reset();
+
+    #ifdef ARDUINO
+    void printJson(Print& out);
+    void printTrace(Print& out);
+    #endif
+
+  private:
+    uint32_t ticksPerUs();
+
+    ProfilerStat _stats[PROF_COUNT] = {};
+    ProfilerSpan _spans[PROFILER_SPANS] = {};
+    uint16_t _spanPos = 0;   //next slot to write
+    uint16_t _spanCount = 0;
+    uint32_t _ticksPerUs = 0;
+};
+
+extern Profiler profiler;
+
+#ifndef WLED_DISABLE_PROFILER
+//times the rest of the enclosing scope
+class ProfilerScope {
+  public:
+    ProfilerScope(uint8_t id) : _id(id), _start(Profiler::ticks()) {}
+    ~ProfilerScope() { profiler.record(_id, _start); }
+  private:
+    uint8_t  _id;
+    uint32_t _start;
+};
+
+  #define PROFILE(id, call) do { uint32_t _profStart = Profiler::ticks(); call; profiler.record(id, _profStart); } while (0)
+  #define PROFILE_SCOPE(id) ProfilerScope _profScope(id)
+#else
+  #define PROFILE(id, call) do { call; } while (0)
+  #define PROFILE_SCOPE(id)
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+#include "wled.h"
+
+/*
+ * Temporal interpolation of network realtime streams
+ * Received pixels are collected in a frame buffer. Once a frame is complete, the strip fades from
+ * what it shows at that moment to the new frame, over the measured interval between frames.
+ * The output thus lags one frame behind the stream, but is rendered at the strip frame rate.
+ */
+
+static uint32_t* rtBuf = nullptr;    //3 frames: from, to and incoming
+static uint16_t  rtLen = 0;          //pixels per frame
+static uint8_t   rtFrom = 0, rtTo = 1, rtIn = 2;
+static uint32_t  rtLastPush = 0;     //millis() the current frame was completed
+static uint16_t  rtInterval = 0;     //smoothed ms between frames, 0 until measured
+static bool      rtHaveFrame = false;
+static bool      rtDone = true;      //the last frame is fully faded in, nothing to render
+
+static inline uint32_t* rtFrame(uint8_t f) { return rtBuf + (uint32_t)f * rtLen; }
+
+//network protocols only, Adalight and the JSON live API show their frames directly
+bool rtInterpActive()
+{
+  if (!realtimeInterpolate) return false;
+  switch (realtimeMode) {
+    case REALTIME_MODE_UDP: case REALTIME_MODE_HYPERION: case REALTIME_MODE_E131:
+    case REALTIME_MODE_ARTNET: case REALTIME_MODE_TPM2NET: case REALTIME_MODE_DDP: break;
+    default: return false;
+  }
+  uint16_t len = strip.getLengthTotal();
+  if (rtBuf && rtLen == len) return true;
+  rtInterpFree();
+  rtBuf = (uint32_t*) calloc(3 * (uint32_t)len, sizeof(uint32_t));
+  if (!rtBuf) return false; //not enough memory, pixels are set directly
+  rtLen = len;
+  return true;
+}
+
+void rtInterpSetPixel(uint16_t i, uint32_t c)
+{
+  if (i < rtLen) rtFrame(rtIn)[i] = c;
+}
+
+//blend of the from and to frames at the current time, 255 once the to frame is reached
+static uint8_t rtProgress(uint32_t now)
+{
+  if (!rtInterval) return 255;
+  uint32_t dt = now - rtLastPush;
+  return (dt >= rtInterval) ? 255 : (dt << 8) / rtInterval;
+}
+
+//the incoming frame is complete
+void rtInterpPush()
+{
+  if (!rtBuf) return;
+  uint32_t now = millis();
+  uint32_t dt = now - rtLastPush;
+  if (rtHaveFrame && dt < RT_INTERP_MAX_INTERVAL) rtInterval = rtInterval ? (rtInterval * 3 + dt) / 4 : dt;
+
+  //start from what is on the strip now, so frames arriving early do not cause a jump
+  uint8_t t = rtProgress(now);
+  uint32_t* from = rtFrame(rtFrom);
+  uint32_t* to = rtFrame(rtTo);
+  if (t == 255) memcpy(from, to, rtLen * sizeof(uint32_t));
+  else for (uint16_t i = 0; i < rtLen; i++) from[i] = colorBlend<false>(from[i], to[i], t);
+
+  uint8_t f = rtTo; rtTo = rtIn; rtIn = f;
+  memcpy(rtFrame(rtIn), rtFrame(rtTo), rtLen * sizeof(uint32_t)); //packets may only update part of the next frame
+  if (!rtHaveFrame) memcpy(from, rtFrame(rtTo), rtLen * sizeof(uint32_t)); //the first frame is shown as is
+  rtLastPush = now;
+  rtHaveFrame = true;
+  rtDone = false;
+}
+
+//renders an intermediate frame whenever the strip is due
+void handleRtInterp()
+{
+  if (!rtBuf || !rtHaveFrame || rtDone || realtimeOverride) return;
+  uint32_t now = millis();
+  if (now - strip.getLastShow() < 1000 / strip.getTargetFps()) return;
+
+  uint8_t t = rtProgress(now);
+  uint32_t* from = rtFrame(rtFrom);
+  uint32_t* to = rtFrame(rtTo);
+  for (uint16_t i = 0; i < rtLen; i++) {
+    strip.setPixelColor(i, (t == 255) ? to[i] : colorBlend<false>(from[i], to[i], t));
+  }
+  strip.show();
+  if (t == 255) rtDone = true;
+}
+
+void rtInterpFree()
+{
+  free(rtBuf);
+  rtBuf = nullptr;
+  rtLen = 0;
+  rtFrom = 0; rtTo = 1; rtIn = 2;
+  rtInterval = 0;
+  rtHaveFrame = false;
+  rtDone = true;
+  e131ResetFrame();
+}
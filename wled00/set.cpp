@@ -132,6 +132,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       // actual finalization is done in WLED::loop() (removing old busses and adding new)
       if (busConfigs[s] != nullptr) delete busConfigs[s];
       busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder, request->hasArg(cv), skip);
+      Bus* prevBus = busses.getBus(s); //per-bus current budget is only configurable in cfg.json, keep it
+      if (prevBus) busConfigs[s]->maxPower = prevBus->getMaxPower();
       doInitBusses = true;
     }
 
@@ -217,6 +219,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     receiveNotificationBrightness = request->hasArg(F("RB"));
     receiveNotificationColor = request->hasArg(F("RC"));
     receiveNotificationEffects = request->hasArg(F("RX"));
+    receiveSegmentBounds = request->hasArg(F("RL"));
     receiveNotifications = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
     notifyDirectDefault = request->hasArg(F("SD"));
     notifyDirect = notifyDirectDefault;
@@ -596,10 +599,14 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   byte selectedSeg = strip.getMainSegmentId();
   if (selectedSeg != prevMain) setValuesFromMainSeg();
 
+  bool queued = false; //no storage for the selected segment yet, the loop creates it with the bounds of this request
   pos = req.indexOf(F("SS="));
   if (pos > 0) {
     byte t = getNumVal(&req, pos);
-    if (t < strip.getMaxSegments()) selectedSeg = t;
+    if (t < strip.getMaxSegments()) {
+      selectedSeg = t;
+      queued = !strip.useSegment(t);
+    }
   }
 
   WS2812FX::Segment& selseg = strip.getSegment(selectedSeg);
@@ -607,7 +614,7 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   if (pos > 0) {
     byte t = getNumVal(&req, pos);
     if (t == 2) {
-      for (uint8_t i = 0; i < strip.getMaxSegments(); i++)
+      for (uint8_t i = 0; i < strip.getSegmentsNum(); i++)
       {
         strip.getSegment(i).setOption(SEG_OPTION_SELECTED, 0);
       }
@@ -636,7 +643,19 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   if (pos > 0) {
     spcI = getNumVal(&req, pos);
   }
-  strip.setSegment(selectedSeg, startI, stopI, grpI, spcI);
+  if (queued && stopI > startI) {
+    StaticJsonDocument<128> segDoc;
+    JsonObject elem = segDoc.to<JsonObject>();
+    elem["start"] = startI;
+    elem["stop"] = stopI;
+    elem["grp"] = grpI;
+    elem[F("spc")] = spcI;
+    if (!apply) queueSegment(elem, selectedSeg); //called by JSON API or IR, which hold the JSON buffer lock
+    else if (requestJSONBufferLock(20)) {
+      queueSegment(elem, selectedSeg);
+      releaseJSONBufferLock();
+    }
+  } else strip.setSegment(selectedSeg, startI, stopI, grpI, spcI);
 
   pos = req.indexOf(F("RV=")); //Segment reverse
   if (pos > 0) selseg.setOption(SEG_OPTION_REVERSED, req.charAt(pos+3) != '0');
@@ -915,7 +934,7 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
     if (col[i] != prevCol[i]) col0Changed = true;
     if (colSec[i] != prevColSec[i]) col1Changed = true;
   }
-  for (uint8_t i = 0; i < strip.getMaxSegments(); i++)
+  for (uint8_t i = 0; i < strip.getSegmentsNum(); i++)
   {
     WS2812FX::Segment& seg = strip.getSegment(i);
     if (!seg.isSelected()) continue;
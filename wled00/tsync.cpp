@@ -0,0 +1,227 @@
+#include "wled.h"
+#ifdef ARDUINO_ARCH_ESP32
+#include "esp_timer.h"
+#endif
+
+/*
+ * Timebase sync between nodes (NTP style round trip measurement)
+ *
+ * A follower periodically broadcasts a request on the notifier port, the leader answers it directly.
+ * Packet layout (big endian, times in us):
+ *  0:     TSYNC_PACKET_ID
+ *  1:     0 request, 1 response
+ *  2:     sequence number
+ *  3:     reserved
+ *  4-11:  t1, follower clock when sending the request
+ *  12-19: t2, leader sync clock when receiving the request (response only)
+ *  20-27: t3, leader sync clock when sending the response (response only)
+ *  28-31: remaining offset of the follower (request only, shown in the leader's node list)
+ *  32-35: jitter of the follower
+ *  36-39: round trip time of the follower
+ *
+ * The offset of an exchange is ((t2-t1) + (t3-t4)) / 2 and its delay (t4-t1) - (t3-t2).
+ * Of the last TSYNC_SAMPLES exchanges the one with the lowest delay is used, as it was the least
+ * affected by queueing. Exchanges that took much longer than that are ignored as outliers.
+ * The timebase is then slewed towards the measured offset instead of jumping, so effects do not skip.
+ */
+
+#define TSYNC_PACKET_SIZE      40
+#define TSYNC_SAMPLES           8
+#define TSYNC_INTERVAL_FAST   250 //ms between requests until the sample window is full
+#define TSYNC_INTERVAL       2000
+#define TSYNC_STEP_US      100000 //larger offsets are applied at once
+#define TSYNC_SLEW_PPM      10000 //smaller ones at up to 1% of the elapsed time
+#define TSYNC_OUTLIER_US     2000 //samples with more than twice the lowest delay plus this are outliers
+
+struct TimeSyncSample {
+  int64_t  offset;
+  uint32_t delay;
+};
+
+static TimeSyncSample tsSamples[TSYNC_SAMPLES];
+static uint8_t  tsSampleCount = 0, tsSamplePos = 0;
+static uint8_t  tsSeq = 0;
+static uint32_t tsLastRequest = 0;
+static uint64_t tsRequestTime = 0; //t1 of the pending request
+static int64_t  tsTarget = 0;      //offset of the leader's sync clock to our clock
+static int64_t  tsApplied = 0;     //offset currently in use as timebase
+static uint64_t tsLastSlew = 0;
+static bool     tsLocked = false;
+static int32_t  tsResidual = 0;
+static uint32_t tsJitter = 0, tsRtt = 0;
+
+static uint64_t timeSyncMicros()
+{
+  #ifdef ESP8266
+  return micros64();
+  #else
+  return esp_timer_get_time();
+  #endif
+}
+
+//our time as seen by effects (millis() + timebase), in us
+static uint64_t timeSyncClock()
+{
+  return timeSyncMicros() + (int64_t)(int32_t)strip.timebase * 1000;
+}
+
+static void writeU32(uint8_t* p, uint32_t v)
+{
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+static uint32_t readU32(const uint8_t* p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void writeU64(uint8_t* p, uint64_t v)
+{
+  writeU32(p, v >> 32); writeU32(p +4, v);
+}
+
+static uint64_t readU64(const uint8_t* p)
+{
+  return ((uint64_t)readU32(p) << 32) | readU32(p +4);
+}
+
+static void setNodeTimeSync(IPAddress ip, int32_t offset, uint32_t jitter, uint32_t rtt)
+{
+  for (NodesMap::iterator it = Nodes.begin(); it != Nodes.end(); ++it) {
+    if (it->second.ip != ip) continue;
+    it->second.syncOffset = offset;
+    it->second.syncJitter = jitter;
+    it->second.syncRtt    = rtt;
+    it->second.syncValid  = true;
+  }
+}
+
+static void applyTimeSyncOffset()
+{
+  strip.timebase = (uint32_t)(tsApplied / 1000);
+}
+
+static void sendTimeSyncRequest()
+{
+  uint8_t buf[TSYNC_PACKET_SIZE] = {0};
+  buf[0] = TSYNC_PACKET_ID;
+  buf[1] = 0;
+  buf[2] = ++tsSeq;
+  writeU32(buf +28, tsResidual);
+  writeU32(buf +32, tsJitter);
+  writeU32(buf +36, tsRtt);
+
+  IPAddress broadcastIp;
+  broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+  notifierUdp.beginPacket(broadcastIp, udpPort);
+  tsRequestTime = timeSyncMicros();
+  writeU64(buf +4, tsRequestTime);
+  notifierUdp.write(buf, TSYNC_PACKET_SIZE);
+  notifierUdp.endPacket();
+  tsLastRequest = millis();
+}
+
+//adds the result of an exchange and updates the offset estimate
+static void addTimeSyncSample(int64_t offset, uint32_t delay)
+{
+  tsSamples[tsSamplePos].offset = offset;
+  tsSamples[tsSamplePos].delay  = delay;
+  tsSamplePos = (tsSamplePos + 1) % TSYNC_SAMPLES;
+  if (tsSampleCount < TSYNC_SAMPLES) tsSampleCount++;
+
+  uint8_t best = 0;
+  for (uint8_t i = 1; i < tsSampleCount; i++) {
+    if (tsSamples[i].delay < tsSamples[best].delay) best = i;
+  }
+  uint32_t maxDelay = 2 * tsSamples[best].delay + TSYNC_OUTLIER_US;
+  float sq = 0; uint8_t n = 0;
+  for (uint8_t i = 0; i < tsSampleCount; i++) {
+    if (tsSamples[i].delay > maxDelay) continue;
+    float d = tsSamples[i].offset - tsSamples[best].offset;
+    sq += d * d; n++;
+  }
+  tsJitter = sqrtf(sq / n);
+  tsRtt = tsSamples[best].delay;
+  tsTarget = tsSamples[best].offset;
+
+  int64_t err = tsTarget - tsApplied;
+  if (!tsLocked || err > TSYNC_STEP_US || err < -TSYNC_STEP_US) {
+    tsApplied = tsTarget;
+    tsLocked = true;
+    tsLastSlew = timeSyncMicros();
+    applyTimeSyncOffset();
+  }
+  tsResidual = tsTarget - tsApplied;
+}
+
+void handleTimeSync()
+{
+  if (timeSyncMode != TSYNC_MODE_FOLLOWER || !udpConnected) {
+    tsLocked = false;
+    tsSampleCount = 0;
+    return;
+  }
+
+  if (millis() - tsLastRequest > (tsSampleCount < TSYNC_SAMPLES ? TSYNC_INTERVAL_FAST : TSYNC_INTERVAL)) sendTimeSyncRequest();
+
+  //slew towards the measured offset, by at most TSYNC_SLEW_PPM of the time since it last moved or was reached
+  uint64_t t = timeSyncMicros();
+  if (!tsLocked || tsApplied == tsTarget) { tsLastSlew = t; return; }
+  int64_t maxStep = (int64_t)(t - tsLastSlew) * TSYNC_SLEW_PPM / 1000000;
+  if (maxStep == 0) return;
+  tsLastSlew = t;
+  int64_t err = tsTarget - tsApplied;
+  if (err >  maxStep) err =  maxStep;
+  if (err < -maxStep) err = -maxStep;
+  tsApplied += err;
+  tsResidual = tsTarget - tsApplied;
+  applyTimeSyncOffset();
+}
+
+void handleTimeSyncPacket(const uint8_t* buf, uint16_t len, IPAddress ip)
+{
+  if (len < TSYNC_PACKET_SIZE) return;
+
+  if (buf[1] == 0 && timeSyncMode == TSYNC_MODE_LEADER) { //request, answer right away
+    uint64_t t2 = timeSyncClock();
+    uint8_t out[TSYNC_PACKET_SIZE] = {0};
+    out[0] = TSYNC_PACKET_ID;
+    out[1] = 1;
+    out[2] = buf[2];
+    memcpy(out +4, buf +4, 8); //t1
+    writeU64(out +12, t2);
+    notifierUdp.beginPacket(ip, udpPort);
+    writeU64(out +20, timeSyncClock());
+    notifierUdp.write(out, TSYNC_PACKET_SIZE);
+    notifierUdp.endPacket();
+
+    uint32_t rtt = readU32(buf +36);
+    if (rtt) setNodeTimeSync(ip, readU32(buf +28), readU32(buf +32), rtt);
+    return;
+  }
+
+  if (buf[1] == 1 && timeSyncMode == TSYNC_MODE_FOLLOWER) { //response to our request
+    uint64_t t4 = timeSyncMicros();
+    uint64_t t1 = readU64(buf +4);
+    if (buf[2] != tsSeq || t1 != tsRequestTime) return; //late or not ours
+    uint64_t t2 = readU64(buf +12);
+    uint64_t t3 = readU64(buf +20);
+    int64_t delay = (int64_t)(t4 - t1) - (int64_t)(t3 - t2);
+    if (delay < 0) delay = 0;
+    int64_t offset = ((int64_t)(t2 - t1) + (int64_t)(t3 - t4)) / 2;
+    tsRequestTime = 0;
+    addTimeSyncSample(offset, delay);
+    setNodeTimeSync(ip, tsResidual, tsJitter, tsRtt);
+  }
+}
+
+void serializeTimeSync(JsonObject root)
+{
+  JsonObject ts = root.createNestedObject(F("tsync"));
+  ts[F("mode")] = timeSyncMode;
+  if (timeSyncMode != TSYNC_MODE_FOLLOWER) return;
+  ts[F("lock")] = tsLocked;
+  ts[F("ofs")]  = tsResidual; //us
+  ts[F("jit")]  = tsJitter;
+  ts[F("rtt")]  = tsRtt;
+}
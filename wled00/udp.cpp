@@ -5,9 +5,222 @@
  */
 
 #define WLEDPACKETSIZE 39
+#define WLEDPACKETSIZE_V2 48 //header of version 11 packets, followed by segment records
 #define UDP_IN_MAXSIZE 1472
+#define SYNC_SEG_MAXSIZE 32  //segment record with all fields
+#define WLEDPACKETSIZE_MAX ((WLEDPACKETSIZE_V2 + MAX_NUM_SEGMENTS * SYNC_SEG_MAXSIZE) < UDP_IN_MAXSIZE ? (WLEDPACKETSIZE_V2 + MAX_NUM_SEGMENTS * SYNC_SEG_MAXSIZE) : UDP_IN_MAXSIZE)
+#define SYNC_FULL_INTERVAL 8 //send all segments at least every 8th packet, so receivers recover from lost deltas
+#define SYNC_APPLY_MAX_DELAY 2000 //ignore apply times further in the future
 #define PRESUMED_NETWORK_DELAY 3 //how many ms could it take on avg to reach the receiver? This will be added to transmitted times
 
+/*
+ * Segment sync (compatibility version 11)
+ * Appended to the 39 byte notifier packet, older receivers ignore it:
+ *  39:    flags, bit 0: contains all active segments from the first covered ID on (others are deleted)
+ *         bit 1: more records follow in the next packet, which covers the IDs after the last record
+ *  40-43: apply at, toki seconds (0: apply on arrival)
+ *  44-45: apply at, toki milliseconds
+ *  46:    number of segment records
+ *  47:    first covered segment ID
+ * Each record starts with the segment ID and a SEG_DIFFERS_* mask of the field groups that follow:
+ *  BOUNDS: start(2) stop(2) width(2) layout(1)  GSO: grouping(1) spacing(1) offset(2)  FX: mode speed intensity palette
+ *  COL: 3 colors (WRGB, 4 each)  OPT: option bits  BRI: opacity cct
+ * Only segments that changed since the last packet are sent (delta against the last sent state).
+ */
+static WS2812FX::Segment* syncSent = nullptr; //segments as last sent
+static uint8_t syncSentNum = 0;
+static uint8_t syncPacketsSinceFull = SYNC_FULL_INTERVAL;
+static byte*   syncPending = nullptr;         //received packets waiting for their apply time, each prefixed with its length (2 bytes)
+static uint16_t syncPendingLen = 0;
+static Toki::Time syncPendingAt;
+
+static byte udpRxBuffer[UDP_IN_MAXSIZE +1]; //receive buffer, reused for every packet
+static bool udpShowPending = false;   //realtime pixels were set, show after all pending packets are handled
+
+static uint8_t syncSegmentRecordLen(uint8_t d)
+{
+  uint8_t len = 2;
+  if (d & SEG_DIFFERS_BOUNDS) len += 7;
+  if (d & SEG_DIFFERS_GSO)    len += 4;
+  if (d & SEG_DIFFERS_FX)     len += 4;
+  if (d & SEG_DIFFERS_COL)    len += 12;
+  if (d & SEG_DIFFERS_OPT)    len += 1;
+  if (d & SEG_DIFFERS_BRI)    len += 2;
+  return len;
+}
+
+//mode, speed and intensity of the active segments, notifications that change them restart the effect randomness
+static uint32_t syncEffectHash()
+{
+  uint32_t h = 2166136261u; //FNV-1a
+  for (uint8_t i = 0; i < strip.getSegmentsNum(); i++) {
+    WS2812FX::Segment& seg = strip.getSegment(i);
+    if (!seg.isActive()) continue;
+    h = (h ^ (i | (seg.mode << 8) | (seg.speed << 16) | ((uint32_t)seg.intensity << 24))) * 16777619u;
+  }
+  return h;
+}
+
+/*
+ * Writes the records of all changed segments from ID from on to udpOut, returns the packet length.
+ * from is set to the first ID of the next packet if not all records fit, 0 once all are written.
+ */
+static uint16_t writeSyncSegments(byte* udpOut, bool full, uint8_t& from)
+{
+  uint8_t first = from;
+  from = 0;
+  uint8_t num = strip.getSegmentsNum();
+  if (num > syncSentNum) {
+    WS2812FX::Segment* sent = (WS2812FX::Segment*) realloc(syncSent, num * sizeof(WS2812FX::Segment));
+    if (!sent) return WLEDPACKETSIZE; //receivers use the main segment fields only
+    memset(sent + syncSentNum, 0, (num - syncSentNum) * sizeof(WS2812FX::Segment));
+    syncSent = sent; syncSentNum = num;
+  }
+
+  uint16_t pos = WLEDPACKETSIZE_V2;
+  uint8_t count = 0, lastId = first;
+  for (uint8_t i = first; i < syncSentNum; i++) {
+    WS2812FX::Segment seg = strip.getSegment(i);
+    WS2812FX::Segment& last = syncSent[i];
+    uint8_t d = seg.differs(last);
+    if (seg.cct != last.cct) d |= SEG_DIFFERS_BRI;
+    if (!seg.isActive()) {
+      d = (last.isActive() && !full) ? SEG_DIFFERS_BOUNDS : 0; //deleted since the last packet
+    } else if (full) {
+      d = SEG_DIFFERS_BOUNDS | SEG_DIFFERS_GSO | SEG_DIFFERS_FX | SEG_DIFFERS_COL | SEG_DIFFERS_OPT | SEG_DIFFERS_BRI;
+    }
+    if (!d) {
+      last = seg;
+      continue;
+    }
+    if (pos + syncSegmentRecordLen(d) > WLEDPACKETSIZE_MAX) { //rest is sent in the next packet
+      from = lastId +1; //IDs between the last record and this one have none
+      break;
+    }
+    byte* p = udpOut + pos;
+    *p++ = i;
+    *p++ = d;
+    if (d & SEG_DIFFERS_BOUNDS) {
+      *p++ = seg.start >> 8; *p++ = seg.start & 0xFF;
+      *p++ = seg.stop  >> 8; *p++ = seg.stop  & 0xFF;
+      *p++ = seg.width >> 8; *p++ = seg.width & 0xFF;
+      *p++ = seg.layout;
+    }
+    if (d & SEG_DIFFERS_GSO) {
+      *p++ = seg.grouping; *p++ = seg.spacing;
+      *p++ = seg.offset >> 8; *p++ = seg.offset & 0xFF;
+    }
+    if (d & SEG_DIFFERS_FX) {
+      *p++ = seg.mode; *p++ = seg.speed; *p++ = seg.intensity; *p++ = seg.palette;
+    }
+    if (d & SEG_DIFFERS_COL) {
+      for (uint8_t c = 0; c < NUM_COLORS; c++) {
+        *p++ = seg.colors[c] >> 24; *p++ = seg.colors[c] >> 16; *p++ = seg.colors[c] >> 8; *p++ = seg.colors[c];
+      }
+    }
+    if (d & SEG_DIFFERS_OPT) *p++ = seg.options;
+    if (d & SEG_DIFFERS_BRI) {
+      *p++ = seg.opacity; *p++ = seg.cct;
+    }
+    pos = p - udpOut;
+    last = seg;
+    lastId = i;
+    count++;
+  }
+
+  udpOut[39] = full | ((from > 0) << 1);
+  udpOut[46] = count;
+  udpOut[47] = first;
+  return pos;
+}
+
+//applies the segment records of a version 11 notification
+static void applySyncSegments(byte* udpIn, uint16_t len, bool someSel)
+{
+  bool recvFx  = receiveNotificationEffects    || !someSel;
+  bool recvCol = receiveNotificationColor      || !someSel;
+  bool recvBri = receiveNotificationBrightness || !someSel;
+  bool recvBounds = receiveSegmentBounds && recvFx;
+  uint8_t seen[(MAX_NUM_SEGMENTS +7) /8] = {0}; //IDs with a record
+  uint8_t lastId = 0;
+  uint16_t pos = WLEDPACKETSIZE_V2;
+  strip.applyToAllSelected = false;
+
+  for (uint8_t n = 0; n < udpIn[46]; n++) {
+    if (pos + 2 > len) break;
+    uint8_t id = udpIn[pos];
+    uint8_t d  = udpIn[pos +1];
+    byte* p = udpIn + pos + 2;
+    pos += syncSegmentRecordLen(d);
+    if (pos > len) break; //truncated record
+    if (id >= strip.getMaxSegments()) continue;
+    seen[id >> 3] |= 1 << (id & 0x07);
+    lastId = id;
+
+    if (d & (SEG_DIFFERS_BOUNDS | SEG_DIFFERS_GSO)) {
+      WS2812FX::Segment& cur = strip.getSegment(id);
+      uint16_t start = cur.start, stop = cur.stop;
+      uint16_t width = cur.width; uint8_t layout = cur.layout;
+      uint8_t grp = 0, spc = 0; uint16_t of = UINT16_MAX;
+      if (d & SEG_DIFFERS_BOUNDS) {
+        start = (p[0] << 8) | p[1]; stop = (p[2] << 8) | p[3];
+        width = (p[4] << 8) | p[5]; layout = p[6];
+        p += 7;
+      }
+      if (d & SEG_DIFFERS_GSO) {
+        grp = p[0]; spc = p[1]; of = (p[2] << 8) | p[3];
+        p += 4;
+      }
+      if (recvBounds) {
+        strip.setSegment(id, start, stop, grp, spc, of);
+        WS2812FX::Segment& seg = strip.getSegment(id);
+        if (width > seg.length()) width = 0;
+        seg.width = width;
+        seg.layout = layout;
+      }
+    }
+    if (id >= strip.getSegmentsNum()) continue; //segment does not exist here
+
+    WS2812FX::Segment& seg = strip.getSegment(id);
+    if (d & SEG_DIFFERS_FX) {
+      if (recvFx) {
+        if (p[0] < strip.getModeCount()) strip.setMode(id, p[0]);
+        seg.speed = p[1];
+        seg.intensity = p[2];
+        if (p[3] < strip.getPaletteCount()) seg.palette = p[3];
+      }
+      p += 4;
+    }
+    if (d & SEG_DIFFERS_COL) {
+      for (uint8_t c = 0; c < NUM_COLORS; c++) {
+        if (recvCol) seg.setColor(c, ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3], id);
+        p += 4;
+      }
+    }
+    if (d & SEG_DIFFERS_OPT) {
+      if (recvFx) {
+        seg.setOption(SEG_OPTION_REVERSED, (p[0] >> SEG_OPTION_REVERSED) & 0x01);
+        seg.setOption(SEG_OPTION_MIRROR,   (p[0] >> SEG_OPTION_MIRROR)   & 0x01);
+        seg.setOption(SEG_OPTION_FREEZE,   (p[0] >> SEG_OPTION_FREEZE)   & 0x01);
+      }
+      if (recvBri) seg.setOption(SEG_OPTION_ON, (p[0] >> SEG_OPTION_ON) & 0x01, id);
+      p++;
+    }
+    if (d & SEG_DIFFERS_BRI) {
+      if (recvBri) seg.setOpacity(p[0], id);
+      if (recvCol) seg.setCCT(p[1], id);
+    }
+  }
+
+  uint8_t flags = udpIn[39];
+  if ((flags & 0x01) && recvBounds) { //full state, delete segments the sender does not have
+    uint8_t end = (flags & 0x02) ? lastId +1 : strip.getSegmentsNum(); //the next packet covers the rest
+    for (uint8_t i = udpIn[47]; i < end; i++) {
+      if (!(seen[i >> 3] & (1 << (i & 0x07)))) strip.setSegment(i, 0, 0);
+    }
+  }
+}
+
 void notify(byte callMode, bool followUp)
 {
   if (!udpConnected) return;
@@ -25,7 +238,7 @@ void notify(byte callMode, bool followUp)
     case CALL_MODE_ALEXA:         if (!notifyAlexa)  return; break;
     default: return;
   }
-  byte udpOut[WLEDPACKETSIZE];
+  static byte udpOut[WLEDPACKETSIZE_MAX]; //up to 1.5kB, too large for the stack
 	WS2812FX::Segment& mainseg = strip.getSegment(strip.getMainSegmentId());
   udpOut[0] = 0; //0: wled notifier protocol 1: WARLS protocol
   udpOut[1] = callMode;
@@ -43,7 +256,8 @@ void notify(byte callMode, bool followUp)
   //3: supports FX intensity, 24 byte packet 4: supports transitionDelay 5: sup palette
   //6: supports timebase syncing, 29 byte packet 7: supports tertiary color 8: supports sys time sync, 36 byte packet
   //9: supports sync groups, 37 byte packet 10: supports CCT, 39 byte packet
-  udpOut[11] = 10; 
+  //11: supports segment sync and apply time, variable length packet
+  udpOut[11] = 11; 
   udpOut[12] = colSec[0];
   udpOut[13] = colSec[1];
   udpOut[14] = colSec[2];
@@ -84,13 +298,36 @@ void notify(byte callMode, bool followUp)
 	//0: byte 38 contains 0-255 value, 255: no valid CCT, 1-254: Kelvin value MSB
 	udpOut[37] = strip.hasCCTBus() ? 0 : 255; //check this is 0 for the next value to be significant
 	udpOut[38] = mainseg.cct;
+
+  //receivers apply the change at the same time (needs synced system time)
+  Toki::Time at = toki.getTime();
+  toki.adjust(at, syncApplyDelay);
+  if (!syncApplyDelay || toki.getTimeSource() == TOKI_TS_NONE) at.sec = 0;
+  udpOut[40] = (at.sec >> 24) & 0xFF;
+  udpOut[41] = (at.sec >> 16) & 0xFF;
+  udpOut[42] = (at.sec >>  8) & 0xFF;
+  udpOut[43] = (at.sec >>  0) & 0xFF;
+  udpOut[44] = (at.ms >> 8) & 0xFF;
+  udpOut[45] = (at.ms >> 0) & 0xFF;
   
   IPAddress broadcastIp;
   broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
 
-  notifierUdp.beginPacket(broadcastIp, udpPort);
-  notifierUdp.write(udpOut, WLEDPACKETSIZE);
-  notifierUdp.endPacket();
+  //segment records that do not fit are sent in following packets right away, with the same header
+  bool full = followUp || ++syncPacketsSinceFull >= SYNC_FULL_INTERVAL;
+  uint8_t from = 0;
+  do {
+    uint16_t packetLen = writeSyncSegments(udpOut, full, from);
+    notifierUdp.beginPacket(broadcastIp, udpPort);
+    notifierUdp.write(udpOut, packetLen);
+    notifierUdp.endPacket();
+  } while (from);
+  if (full) syncPacketsSinceFull = 0;
+  //receivers restart their effect randomness from the same time, see applyNotification()
+  static uint32_t sentEffectHash = 0;
+  uint32_t fx = syncEffectHash();
+  if (strip.rngSeed && !followUp && (full || fx != sentEffectHash)) strip.reseed(t);
+  sentEffectHash = fx;
   notificationSentCallMode = callMode;
   notificationSentTime = millis();
   notificationTwoRequired = (followUp)? false:notifyTwice;
@@ -129,33 +366,128 @@ void sendTPM2Ack() {
 }
 
 
-void handleNotifications()
+//applies a received notification (everything but the timing)
+static void applyNotification(byte* udpIn, uint16_t len)
 {
-  IPAddress localIP;
+  byte version = udpIn[11];
+  bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
+  bool segSync = (version > 10 && version < 200 && len >= WLEDPACKETSIZE_V2);
+  uint32_t fx = syncEffectHash();
+
+  if (segSync) {
+    applySyncSegments(udpIn, len, someSel);
+    setValuesFromMainSeg();
+  } else {
+    //apply colors from notification
+    if (receiveNotificationColor || !someSel)
+    {
+      col[0] = udpIn[3];
+      col[1] = udpIn[4];
+      col[2] = udpIn[5];
+      if (version > 0) //sending module's white val is intended
+      {
+        col[3] = udpIn[10];
+        if (version > 1)
+        {
+          colSec[0] = udpIn[12];
+          colSec[1] = udpIn[13];
+          colSec[2] = udpIn[14];
+          colSec[3] = udpIn[15];
+        }
+        if (version > 6)
+        {
+          strip.setColor(2, udpIn[20], udpIn[21], udpIn[22], udpIn[23]); //tertiary color
+        }
+				if (version > 9 && version < 200 && udpIn[37] < 255) { //valid CCT/Kelvin value
+					uint8_t cct = udpIn[38];
+					if (udpIn[37] > 0) { //Kelvin
+						cct = (((udpIn[37] << 8) + udpIn[38]) - 1900) >> 5; 
+					}
+					uint8_t segid = strip.getMainSegmentId();
+					strip.getSegment(segid).setCCT(cct, segid);
+				}
+      }
+    }
 
-  //send second notification if enabled
-  if(udpConnected && notificationTwoRequired && millis()-notificationSentTime > 250){
-    notify(notificationSentCallMode,true);
+    //apply effects from notification
+    if (version < 200 && (receiveNotificationEffects || !someSel))
+    {
+      if (udpIn[8] < strip.getModeCount()) effectCurrent = udpIn[8];
+      effectSpeed   = udpIn[9];
+      if (version > 2) effectIntensity = udpIn[16];
+      if (version > 4 && udpIn[19] < strip.getPaletteCount()) effectPalette = udpIn[19];
+    }
   }
-  
-  if (e131NewData && millis() - strip.getLastShow() > 15)
+
+  if (version > 3)
   {
-    e131NewData = false;
-    strip.show();
+    transitionDelayTemp = ((udpIn[17] << 0) & 0xFF) + ((udpIn[18] << 8) & 0xFF00);
   }
 
-  //unlock strip when realtime UDP times out
-  if (realtimeMode && millis() > realtimeTimeout)
-  {
-    if (realtimeOverride == REALTIME_OVERRIDE_ONCE) realtimeOverride = REALTIME_OVERRIDE_NONE;
-    strip.setBrightness(scaledBri(bri));
-    realtimeMode = REALTIME_MODE_INACTIVE;
-    realtimeIP[0] = 0;
+  nightlightActive = udpIn[6];
+  if (nightlightActive) nightlightDelayMins = udpIn[7];
+  
+  if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
+  notificationSegmentSync = segSync; //segments are already set, do not apply the main segment values to all selected
+  colorUpdated(CALL_MODE_NOTIFICATION);
+  notificationSegmentSync = false;
+
+  //like the sender: once per notification, if it is a full state or changed effects, not for the repeated one
+  static uint32_t reseedTime = 0;
+  bool full = segSync && (udpIn[39] & 0x01);
+  if (version > 5 && version < 200 && (receiveNotificationEffects || !someSel) && strip.rngSeed && !udpIn[24]) {
+    uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
+    if ((full || fx != syncEffectHash()) && t != reseedTime) {
+      strip.reseed(t);
+      reseedTime = t;
+    }
   }
+}
 
-  //receive UDP notifications
-  if (!udpConnected) return;
-    
+//applies the received packets that wait for their apply time
+static void applyPendingNotifications()
+{
+  byte* buf = syncPending;
+  uint16_t bufLen = syncPendingLen;
+  syncPending = nullptr;
+  syncPendingLen = 0;
+  for (uint16_t pos = 0; pos + 2 <= bufLen;) {
+    uint16_t len = (buf[pos] << 8) | buf[pos +1];
+    if (!realtimeMode) applyNotification(buf + pos + 2, len);
+    pos += 2 + len;
+  }
+  free(buf);
+}
+
+//packets with the same apply time belong to one notification and are kept together
+static void deferNotification(byte* udpIn, uint16_t len, Toki::Time at)
+{
+  if (syncPending && (at.sec != syncPendingAt.sec || at.ms != syncPendingAt.ms)) applyPendingNotifications(); //do not lose the previous one
+  byte* buf = (byte*) realloc(syncPending, syncPendingLen + 2 + len);
+  if (!buf) { //apply right away
+    applyPendingNotifications();
+    applyNotification(udpIn, len);
+    return;
+  }
+  buf[syncPendingLen] = len >> 8;
+  buf[syncPendingLen +1] = len & 0xFF;
+  memcpy(buf + syncPendingLen + 2, udpIn, len);
+  syncPending = buf;
+  syncPendingLen += 2 + len;
+  syncPendingAt = at;
+}
+
+//applies a scheduled notification once its time has come
+static void handlePendingNotification()
+{
+  if (!syncPending || toki.isLater(toki.getTime(), syncPendingAt)) return;
+  applyPendingNotifications();
+}
+
+//reads and handles one pending packet, returns false if there was none
+static bool handleUdpPacket()
+{
+  byte* udpIn = udpRxBuffer;
   bool isSupp = false;
   uint16_t packetSize = notifierUdp.parsePacket();
   if (!packetSize && udp2Connected) {
@@ -167,14 +499,20 @@ void handleNotifications()
   if (!packetSize && udpRgbConnected) {
     packetSize = rgbUdp.parsePacket();
     if (packetSize) {
-      if (!receiveDirect) return;
-      if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return;
+      metricPacketsRx[METRIC_PROTO_HYPERION]++;
+      if (!receiveDirect || packetSize > UDP_IN_MAXSIZE || packetSize < 3) {
+        metricPacketsDropped[METRIC_PROTO_HYPERION]++;
+        return true;
+      }
       realtimeIP = rgbUdp.remoteIP();
       DEBUG_PRINTLN(rgbUdp.remoteIP());
-      uint8_t lbuf[packetSize];
+      byte* lbuf = udpRxBuffer;
       rgbUdp.read(lbuf, packetSize);
       realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
-      if (realtimeOverride) return;
+      if (realtimeOverride) {
+        metricPacketsDropped[METRIC_PROTO_HYPERION]++;
+        return true;
+      }
       uint16_t id = 0;
       uint16_t totalLen = strip.getLengthTotal();
       for (uint16_t i = 0; i < packetSize -2; i += 3)
@@ -182,26 +520,35 @@ void handleNotifications()
         setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
         id++; if (id >= totalLen) break;
       }
-      strip.show();
-      return;
+      udpShowPending = true;
+      return true;
     } 
   }
 
-  if (!(receiveNotifications || receiveDirect)) return;
+  if (!(receiveNotifications || receiveDirect || timeSyncMode)) return false;
   
-  localIP = Network.localIP();
+  IPAddress localIP = Network.localIP();
   //notifier and UDP realtime
-  if (!packetSize || packetSize > UDP_IN_MAXSIZE) return;
-  if (!isSupp && notifierUdp.remoteIP() == localIP) return; //don't process broadcasts we send ourselves
+  if (!packetSize) return false;
+  if (packetSize > UDP_IN_MAXSIZE) {
+    metricPacketsRx[METRIC_PROTO_UDP]++;
+    metricPacketsDropped[METRIC_PROTO_UDP]++;
+    return true;
+  }
+  if (!isSupp && notifierUdp.remoteIP() == localIP) return true; //don't process broadcasts we send ourselves
 
-  uint8_t udpIn[packetSize +1];
   uint16_t len;
   if (isSupp) len = notifier2Udp.read(udpIn, packetSize);
   else        len =  notifierUdp.read(udpIn, packetSize);
 
+  if (udpIn[0] == TSYNC_PACKET_ID) {
+    if (!isSupp) handleTimeSyncPacket(udpIn, len, notifierUdp.remoteIP());
+    return true;
+  }
+
   // WLED nodes info notifications
   if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
-    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return;
+    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return true;
 
     uint8_t unit = udpIn[39];
     NodesMap::iterator it = Nodes.find(unit);
@@ -227,15 +574,17 @@ void handleNotifications()
           build |= udpIn[40+i]<<(8*i);
       it->second.build = build;
     }
-    return;
+    return true;
   }
 
+  metricPacketsRx[udpIn[0] == 0 ? METRIC_PROTO_SYNC : METRIC_PROTO_UDP]++;
+
   //wled notifier, ignore if realtime packets active
   if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
   {
     //ignore notification if received within a second after sending a notification ourselves
-    if (millis() - notificationSentTime < 1000) return;
-    if (udpIn[1] > 199) return; //do not receive custom versions
+    if (millis() - notificationSentTime < 1000) return true;
+    if (udpIn[1] > 199) return true; //do not receive custom versions
 
     //compatibilityVersionByte: 
     byte version = udpIn[11];
@@ -243,54 +592,18 @@ void handleNotifications()
     // if we are not part of any sync group ignore message
     if (version < 9 || version > 199) {
       // legacy senders are treated as if sending in sync group 1 only
-      if (!(receiveGroups & 0x01)) return;
-    } else if (!(receiveGroups & udpIn[36])) return;
+      if (!(receiveGroups & 0x01)) return true;
+    } else if (!(receiveGroups & udpIn[36])) return true;
     
     bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
-    //apply colors from notification
-    if (receiveNotificationColor || !someSel)
-    {
-      col[0] = udpIn[3];
-      col[1] = udpIn[4];
-      col[2] = udpIn[5];
-      if (version > 0) //sending module's white val is intended
-      {
-        col[3] = udpIn[10];
-        if (version > 1)
-        {
-          colSec[0] = udpIn[12];
-          colSec[1] = udpIn[13];
-          colSec[2] = udpIn[14];
-          colSec[3] = udpIn[15];
-        }
-        if (version > 6)
-        {
-          strip.setColor(2, udpIn[20], udpIn[21], udpIn[22], udpIn[23]); //tertiary color
-        }
-				if (version > 9 && version < 200 && udpIn[37] < 255) { //valid CCT/Kelvin value
-					uint8_t cct = udpIn[38];
-					if (udpIn[37] > 0) { //Kelvin
-						cct = (((udpIn[37] << 8) + udpIn[38]) - 1900) >> 5; 
-					}
-					uint8_t segid = strip.getMainSegmentId();
-					strip.getSegment(segid).setCCT(cct, segid);
-				}
-      }
-    }
-
     bool timebaseUpdated = false;
-    //apply effects from notification
-    if (version < 200 && (receiveNotificationEffects || !someSel))
+    //effect timing is taken on arrival, even if the rest is applied later
+    if (version > 5 && version < 200 && (receiveNotificationEffects || !someSel))
     {
-      if (udpIn[8] < strip.getModeCount()) effectCurrent = udpIn[8];
-      effectSpeed   = udpIn[9];
-      if (version > 2) effectIntensity = udpIn[16];
-      if (version > 4 && udpIn[19] < strip.getPaletteCount()) effectPalette = udpIn[19];
-      if (version > 5)
-      {
-        uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
-        t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
-        t -= millis();
+      uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
+      t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
+      t -= millis();
+      if (timeSyncMode != TSYNC_MODE_FOLLOWER) { //otherwise the measured timebase is more accurate
         strip.timebase = t;
         timebaseUpdated = true;
       }
@@ -319,21 +632,26 @@ void handleNotifications()
         }
       }
     }
-    
-    if (version > 3)
-    {
-      transitionDelayTemp = ((udpIn[17] << 0) & 0xFF) + ((udpIn[18] << 8) & 0xFF00);
-    }
 
-    nightlightActive = udpIn[6];
-    if (nightlightActive) nightlightDelayMins = udpIn[7];
-    
-    if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
-    colorUpdated(CALL_MODE_NOTIFICATION);
-    return;
+    //version 11 senders schedule the change so all receivers switch in the same frame
+    if (version > 10 && version < 200 && len >= WLEDPACKETSIZE_V2 && toki.getTimeSource() > TOKI_TS_NONE) {
+      Toki::Time at;
+      at.sec = (udpIn[40] << 24) | (udpIn[41] << 16) | (udpIn[42] << 8) | (udpIn[43]);
+      at.ms = (udpIn[44] << 8) | (udpIn[45]);
+      Toki::Time now = toki.getTime();
+      if (at.sec && toki.isLater(now, at) && toki.msDifference(now, at) < SYNC_APPLY_MAX_DELAY) {
+        deferNotification(udpIn, len, at);
+        return true;
+      }
+    }
+    applyNotification(udpIn, len);
+    return true;
   }
 
-  if (!receiveDirect) return;
+  if (!receiveDirect || udpIn[0] == 0) {
+    metricPacketsDropped[udpIn[0] == 0 ? METRIC_PROTO_SYNC : METRIC_PROTO_UDP]++;
+    return true;
+  }
   
   //TPM2.NET
   if (udpIn[0] == 0x9c)
@@ -342,13 +660,13 @@ void handleNotifications()
     //if the number of LEDs in your installation doesn't allow that, please include padding bytes at the end of the last packet
     byte tpmType = udpIn[1];
     if (tpmType == 0xaa) { //TPM2.NET polling, expect answer
-      sendTPM2Ack(); return;
+      sendTPM2Ack(); return true;
     }
-    if (tpmType != 0xda) return; //return if notTPM2.NET data
+    if (tpmType != 0xda) return true; //return if notTPM2.NET data
 
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
     realtimeLock(realtimeTimeoutMs, REALTIME_MODE_TPM2NET);
-    if (realtimeOverride) return;
+    if (realtimeOverride) return true;
 
     tpmPacketCount++; //increment the packet count
     if (tpmPacketCount == 1) tpmPayloadFrameSize = (udpIn[2] << 8) + udpIn[3]; //save frame size for the whole payload if this is the first packet
@@ -369,26 +687,26 @@ void handleNotifications()
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
-      strip.show();
+      udpShowPending = true;
     }
-    return;
+    return true;
   }
 
-  //UDP realtime: 1 warls 2 drgb 3 drgbw
-  if (udpIn[0] > 0 && udpIn[0] < 5)
+  //UDP realtime: 1 warls 2 drgb 3 drgbw 4 dnrgb 5 dnrgbw 6 compressed
+  if (udpIn[0] > 0 && udpIn[0] <= UDP_RT_COMPRESSED)
   {
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
     DEBUG_PRINTLN(realtimeIP);
-    if (packetSize < 2) return;
+    if (packetSize < 2) return true;
 
     if (udpIn[1] == 0)
     {
       realtimeTimeout = 0;
-      return;
+      return true;
     } else {
       realtimeLock(udpIn[1]*1000 +1, REALTIME_MODE_UDP);
     }
-    if (realtimeOverride) return;
+    if (realtimeOverride) return true;
 
     uint16_t totalLen = strip.getLengthTotal();
     if (udpIn[0] == 1) //warls
@@ -433,9 +751,13 @@ void handleNotifications()
         setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
         id++;
       }
+    } else if (udpIn[0] == UDP_RT_COMPRESSED && packetSize > 5)
+    {
+      uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
+      decodeRealtimePixels(udpIn[4], udpIn + 5, packetSize - 5, id, totalLen);
     }
-    strip.show();
-    return;
+    udpShowPending = true;
+    return true;
   }
 
   // API over UDP
@@ -446,25 +768,74 @@ void handleNotifications()
     apireq += (char*)udpIn;
     handleSet(nullptr, apireq);
   } else if (udpIn[0] == '{') { //JSON API
-    DynamicJsonDocument jsonBuffer(2048);
-    DeserializationError error = deserializeJson(jsonBuffer, udpIn);
-    JsonObject root = jsonBuffer.as<JsonObject>();
+    #ifdef WLED_USE_DYNAMIC_JSON
+    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    #else
+    if (!requestJSONBufferLock(21)) return true;
+    #endif
+    DeserializationError error = deserializeJson(doc, udpIn);
+    JsonObject root = doc.as<JsonObject>();
     if (!error && !root.isNull()) deserializeState(root);
+    releaseJSONBufferLock();
   }
+  return true;
 }
 
+void handleNotifications()
+{
+  //send second notification if enabled
+  if(udpConnected && notificationTwoRequired && millis()-notificationSentTime > 250){
+    notify(notificationSentCallMode,true);
+  }
+
+  handleTimeSync();
+  handlePendingNotification();
+  handleE131Queue();
+  
+  if (e131NewData && rtInterpActive()) { //faded in by handleRtInterp()
+    e131NewData = false;
+    rtInterpPush();
+  }
+  if (e131NewData && millis() - strip.getLastShow() > 15)
+  {
+    e131NewData = false;
+    strip.show();
+  }
+
+  //unlock strip when realtime UDP times out
+  if (realtimeMode && millis() > realtimeTimeout)
+  {
+    if (realtimeOverride == REALTIME_OVERRIDE_ONCE) realtimeOverride = REALTIME_OVERRIDE_NONE;
+    strip.setBrightness(scaledBri(bri));
+    realtimeMode = REALTIME_MODE_INACTIVE;
+    realtimeIP[0] = 0;
+    rtInterpFree();
+  }
+  handleRtInterp();
+
+  //receive UDP packets, several per call so senders that split frames are not limited by the loop rate
+  if (!udpConnected) return;
+  uint32_t drainStart = millis();
+  for (uint8_t n = 0; n < UDP_DRAIN_MAX_PACKETS; n++) {
+    if (!handleUdpPacket()) break;
+    if (millis() - drainStart >= UDP_DRAIN_BUDGET_MS) break;
+  }
+  if (udpShowPending) { //show once all packets of the frame are in
+    udpShowPending = false;
+    if (rtInterpActive()) rtInterpPush();
+    else strip.show();
+  }
+}
 
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
 {
   uint16_t pix = i + arlsOffset;
   if (pix < strip.getLengthTotal())
   {
-    if (!arlsDisableGammaCorrection && strip.gammaCorrectCol)
-    {
-      strip.setPixelColor(pix, strip.gamma8(r), strip.gamma8(g), strip.gamma8(b), strip.gamma8(w));
-    } else {
-      strip.setPixelColor(pix, r, g, b, w);
-    }
+    uint32_t c = RGBW32(r, g, b, w);
+    if (!arlsDisableGammaCorrection) c = strip.gamma32(c); //single table pass, no-op if gamma correction is off
+    if (rtInterpActive()) rtInterpSetPixel(pix, c);
+    else strip.setPixelColor(pix, c);
   }
 }
 
@@ -7,9 +7,11 @@ bool requestJSONBufferLock(uint8_t module)
 {
   unsigned long now = millis();
 
+  if (jsonBufferLock) metricJsonLockWaits++;
   while (jsonBufferLock && millis()-now < 1000) delay(1); // wait for a second for buffer lock
 
   if (millis()-now >= 1000) {
+    metricJsonLockTimeouts++;
     DEBUG_PRINT(F("ERROR: Locking JSON buffer failed! ("));
     DEBUG_PRINT(jsonBufferLock);
     DEBUG_PRINTLN(")");
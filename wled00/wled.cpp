@@ -123,31 +123,33 @@ void WLED::loop()
   #ifdef WLED_DEBUG
   static unsigned long maxUsermodMillis = 0;
   #endif
-
-  handleTime();
-  handleIR();        // 2nd call to function needed for ESP32 to return valid results -- should be good for ESP8266, too
-  handleConnection();
-  handleSerial();
-  handleNotifications();
-  handleTransitions();
+  PROFILE_SCOPE(PROF_LOOP);
+
+  PROFILE(PROF_TIME, handleTime());
+  PROFILE(PROF_IR, handleIR());        // 2nd call to function needed for ESP32 to return valid results -- should be good for ESP8266, too
+  PROFILE(PROF_CONNECTION, handleConnection());
+  PROFILE(PROF_SERIAL, handleSerial());
+  PROFILE(PROF_NOTIFICATIONS, handleNotifications());
+  PROFILE(PROF_NOTIFICATIONS, handleSegmentQueue()); //segments from network requests that need storage
+  PROFILE(PROF_TRANSITIONS, handleTransitions());
 #ifdef WLED_ENABLE_DMX
-  handleDMX();
+  PROFILE(PROF_DMX, handleDMX());
 #endif
-  userLoop();
+  PROFILE(PROF_USERLOOP, userLoop());
 
   #ifdef WLED_DEBUG
   unsigned long usermodMillis = millis();
   #endif
-  usermods.loop();
+  PROFILE(PROF_USERMODS, usermods.loop());
   #ifdef WLED_DEBUG
   usermodMillis = millis() - usermodMillis;
   if (usermodMillis > maxUsermodMillis) maxUsermodMillis = usermodMillis;
   #endif
 
   yield();
-  handleIO();
-  handleIR();
-  handleAlexa();
+  PROFILE(PROF_IO, handleIO());
+  PROFILE(PROF_IR, handleIR());
+  PROFILE(PROF_ALEXA, handleAlexa());
 
   yield();
 
@@ -161,24 +163,27 @@ void WLED::loop()
   if (!realtimeMode || realtimeOverride)  // block stuff if WARLS/Adalight is enabled
   {
     if (apActive)
-      dnsServer.processNextRequest();
+      PROFILE(PROF_DNS, dnsServer.processNextRequest());
 #ifndef WLED_DISABLE_OTA
     if (WLED_CONNECTED && aOtaEnabled)
-      ArduinoOTA.handle();
+      PROFILE(PROF_OTA, ArduinoOTA.handle());
 #endif
-    handleNightlight();
-    handlePlaylist();
+    PROFILE(PROF_NIGHTLIGHT, handleNightlight());
+    PROFILE(PROF_PLAYLIST, handlePlaylist());
     yield();
 
-    handleHue();
+    PROFILE(PROF_HUE, handleHue());
 #ifndef WLED_DISABLE_BLYNK
-    handleBlynk();
+    PROFILE(PROF_BLYNK, handleBlynk());
 #endif
 
     yield();
 
-    if (!offMode || strip.isOffRefreshRequred)
-      strip.service();
+    if (!offMode || strip.isOffRefreshRequred) {
+      PROFILE(PROF_SERVICE, strip.service());
+      if (!noWifiSleep && strip.timeToNextFrame() > 1)
+        delay(1); //idle until the next frame is due, lets the ESP enter modem sleep
+    }
 #ifdef ESP8266
     else if (!noWifiSleep)
       delay(1); //required to make sure ESP enters modem sleep (see #1184)
@@ -186,7 +191,7 @@ void WLED::loop()
   }
   yield();
 #ifdef ESP8266
-  MDNS.update();
+  PROFILE(PROF_MDNS, MDNS.update());
 #endif
 
   //millis() rolls over every 50 days
@@ -196,6 +201,7 @@ void WLED::loop()
   }
   if (millis() - lastMqttReconnectAttempt > 30000) {
     lastMqttReconnectAttempt = millis();
+    PROFILE_SCOPE(PROF_MQTT);
     initMqtt();
     yield();
     // refresh WLED nodes list
@@ -207,6 +213,7 @@ void WLED::loop()
   //LED settings have been saved, re-init busses
   //This code block causes severe FPS drop on ESP32 with the original "if (busConfigs[0] != nullptr)" conditional. Investigate! 
   if (doInitBusses) {
+    PROFILE_SCOPE(PROF_BUSINIT);
     doInitBusses = false;
     DEBUG_PRINTLN(F("Re-init busses."));
     bool aligned = strip.checkSegmentAlignment(); //see if old segments match old bus(ses)
@@ -228,13 +235,13 @@ void WLED::loop()
     serializeConfig();
   }
   if (loadLedmap >= 0) {
-    strip.deserializeMap(loadLedmap);
+    PROFILE(PROF_LEDMAP, strip.deserializeMap(loadLedmap));
     loadLedmap = -1;
   }
 
   yield();
-  handleWs();
-  handleStatusLED();
+  PROFILE(PROF_WS, handleWs());
+  PROFILE(PROF_STATUSLED, handleStatusLED());
 
 // DEBUG serial logging (every 30s)
 #ifdef WLED_DEBUG
@@ -332,6 +339,7 @@ void WLED::setup()
 
   DEBUG_PRINTLN(F("Reading config"));
   deserializeConfigFromFS();
+  if (serialBaud != 115200) updateSerialBaud(serialBaud);
 
 #if STATUSLED
   if (!pinManager.isPinAllocated(STATUSLED)) {
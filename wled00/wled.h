@@ -146,6 +146,7 @@ using PSRAMDynamicJsonDocument = BasicJsonDocument<PSRAM_Allocator>;
 #include "const.h"
 #include "NodeStruct.h"
 #include "pin_manager.h"
+#include "profiler.h"
 #include "bus_manager.h"
 
 #ifndef CLIENT_SSID
@@ -295,6 +296,7 @@ WLED_GLOBAL bool nodeBroadcastEnabled _INIT(true);
 
 WLED_GLOBAL byte buttonType[WLED_MAX_BUTTONS]  _INIT({BTN_TYPE_PUSH});
 WLED_GLOBAL byte irEnabled      _INIT(0);     // Infrared receiver
+WLED_GLOBAL uint32_t serialBaud _INIT(115200); // Adalight/TPM2/JSON serial, up to 1500000 with USB-serial bridges
 
 WLED_GLOBAL uint16_t udpPort    _INIT(21324); // WLED notifier default port
 WLED_GLOBAL uint16_t udpPort2   _INIT(65506); // WLED notifier supplemental port
@@ -302,9 +304,12 @@ WLED_GLOBAL uint16_t udpRgbPort _INIT(19446); // Hyperion port
 
 WLED_GLOBAL uint8_t syncGroups    _INIT(0x01);                    // sync groups this instance syncs (bit mapped)
 WLED_GLOBAL uint8_t receiveGroups _INIT(0x01);                    // sync receive groups this instance belongs to (bit mapped)
+WLED_GLOBAL byte timeSyncMode      _INIT(TSYNC_MODE_OFF);          // measure and follow the timebase of a leader node (TSYNC_MODE_*)
+WLED_GLOBAL uint16_t syncApplyDelay _INIT(100);                    // ms after sending at which receivers apply a notification (0: on arrival)
 WLED_GLOBAL bool receiveNotificationBrightness _INIT(true);       // apply brightness from incoming notifications
 WLED_GLOBAL bool receiveNotificationColor      _INIT(true);       // apply color
 WLED_GLOBAL bool receiveNotificationEffects    _INIT(true);       // apply effects setup
+WLED_GLOBAL bool receiveSegmentBounds          _INIT(false);      // apply segment bounds and grouping, delete segments the sender does not have
 WLED_GLOBAL bool notifyDirect _INIT(false);                       // send notification if change via UI or HTTP API
 WLED_GLOBAL bool notifyButton _INIT(false);                       // send if updated by button or infrared remote
 WLED_GLOBAL bool notifyAlexa  _INIT(false);                       // send notification if updated via Alexa
@@ -326,6 +331,7 @@ WLED_GLOBAL int arlsOffset _INIT(0);                              // realtime LE
 WLED_GLOBAL bool receiveDirect _INIT(true);                       // receive UDP realtime
 WLED_GLOBAL bool arlsDisableGammaCorrection _INIT(true);          // activate if gamma correction is handled by the source
 WLED_GLOBAL bool arlsForceMaxBri _INIT(false);                    // enable to force max brightness if source has very dark colors that would be black
+WLED_GLOBAL bool realtimeInterpolate _INIT(false);                // fade between received network frames at the strip frame rate (adds one frame of latency)
 
 #ifdef WLED_ENABLE_DMX
 WLED_GLOBAL DMXESPSerial dmx;
@@ -462,6 +468,7 @@ WLED_GLOBAL bool receiveNotifications _INIT(true);
 WLED_GLOBAL unsigned long notificationSentTime _INIT(0);
 WLED_GLOBAL byte notificationSentCallMode _INIT(CALL_MODE_INIT);
 WLED_GLOBAL bool notificationTwoRequired _INIT(false);
+WLED_GLOBAL bool notificationSegmentSync _INIT(false); // notification being applied has set the segments itself
 
 // effects
 WLED_GLOBAL byte effectCurrent _INIT(0);
@@ -590,8 +597,8 @@ WLED_GLOBAL AsyncMqttClient* mqtt _INIT(NULL);
 // udp interface objects
 WLED_GLOBAL WiFiUDP notifierUdp, rgbUdp, notifier2Udp;
 WLED_GLOBAL WiFiUDP ntpUdp;
-WLED_GLOBAL ESPAsyncE131 e131 _INIT_N(((handleE131Packet)));
-WLED_GLOBAL ESPAsyncE131 ddp  _INIT_N(((handleE131Packet)));
+WLED_GLOBAL ESPAsyncE131 e131 _INIT_N(((queueE131Packet)));
+WLED_GLOBAL ESPAsyncE131 ddp  _INIT_N(((queueE131Packet)));
 WLED_GLOBAL bool e131NewData _INIT(false);
 
 // led fx library object
@@ -610,6 +617,18 @@ WLED_GLOBAL StaticJsonDocument<JSON_BUFFER_SIZE> doc;
 #endif
 WLED_GLOBAL volatile uint8_t jsonBufferLock _INIT(0);
 
+// counters served at /metrics (metrics.cpp), monotonically increasing
+WLED_GLOBAL uint32_t metricPacketsRx[METRIC_PROTO_COUNT]       _INIT_N(({0}));
+WLED_GLOBAL uint32_t metricPacketsDropped[METRIC_PROTO_COUNT]  _INIT_N(({0})); // received but not applied
+WLED_GLOBAL uint32_t metricPacketsOutOfSeq[METRIC_PROTO_COUNT] _INIT_N(({0}));
+WLED_GLOBAL uint32_t metricWsDrops _INIT(0);          // messages not sent because of a full WS queue
+WLED_GLOBAL uint32_t metricJsonLockWaits _INIT(0);    // JSON buffer was locked when requested
+WLED_GLOBAL uint32_t metricJsonLockTimeouts _INIT(0);
+WLED_GLOBAL uint32_t metricPresetLoads _INIT(0);
+WLED_GLOBAL uint32_t metricPresetLoadMillis _INIT(0); // total time spent loading presets
+WLED_GLOBAL uint32_t metricFsBytesWritten _INIT(0);
+WLED_GLOBAL uint32_t metricE131QueueDrops _INIT(0);   // E1.31/Art-Net/DDP packets dropped because the loop was behind (only written by the AsyncUDP task)
+
 // enable additional debug output
 #ifdef WLED_DEBUG
   #ifndef ESP8266
@@ -382,6 +382,9 @@ void deEEP() {
   
   DEBUG_PRINTLN(F("Preset file not found, attempting to load from EEPROM"));
   DEBUGFS_PRINTLN(F("Allocating saving buffer for dEEP"));
+  //storage for the segments of preset 16, it does not grow while the buffer is locked
+  strip.ensureSegment((240 -1) / sizeof(WS2812FX::Segment));
+  strip.resetSegments();
   #ifdef WLED_USE_DYNAMIC_JSON
   DynamicJsonDocument doc(JSON_BUFFER_SIZE);
   #else
@@ -430,10 +433,14 @@ void deEEP() {
         segObj[F("ix")]  = EEPROM.read(i+16);
         segObj["pal"] = EEPROM.read(i+17);
       } else {
+        for (byte j = 0; j * sizeof(WS2812FX::Segment) < 240; j++) {
+          if (!strip.useSegment(j)) break;
+        }
+        if (strip.getSegmentsNum() * sizeof(WS2812FX::Segment) < 240) continue; //no memory
         WS2812FX::Segment* seg = strip.getSegments();
         memcpy(seg, EEPROM.getDataPtr() +i+2, 240);
         if (ver == 2) { //versions before 2004230 did not have opacity
-          for (byte j = 0; j < strip.getMaxSegments(); j++)
+          for (byte j = 0; j < strip.getSegmentsNum(); j++)
           {
             strip.getSegment(j).opacity = 255;
             strip.getSegment(j).setOption(SEG_OPTION_ON, 1);
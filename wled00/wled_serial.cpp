@@ -17,23 +17,181 @@ enum class AdaState {
   TPM2_Header_Type,
   TPM2_Header_CountHi,
   TPM2_Header_CountLo,
+  Baud_Magic,
+  Baud_Rate,
+  Baud_Check,
+  Json,
 };
 
+#ifdef ESP8266
+  #define SERIAL_JSON_MAXLEN 2048
+#else
+  #define SERIAL_JSON_MAXLEN 4096
+#endif
+#define SERIAL_JSON_TIMEOUT 1000 //ms, discard incomplete JSON after this
+#define SERIAL_CHUNK_SIZE    192 //bytes read at once, multiple of 3
+#ifndef SERIAL_RX_BUFFER_SIZE
+  #ifdef ESP8266
+    #define SERIAL_RX_BUFFER_SIZE 2048 //receive buffer at rates above 115200, holds a frame while the loop is busy
+  #else
+    #define SERIAL_RX_BUFFER_SIZE 4096
+  #endif
+#endif
+#ifndef SERIAL_MAX_BYTES_PER_LOOP
+  #define SERIAL_MAX_BYTES_PER_LOOP SERIAL_RX_BUFFER_SIZE //a full receive buffer, bytes arriving meanwhile are read in the next loop pass
+#endif
+
+/*
+ * Runtime baud rate command (not stored, use hw.baud in cfg.json for that)
+ * 0xBA 0xD0 <rate> <rate ^ 0x55>, rate 0xB0-0xB7 selects an entry of serialBaudRates.
+ * Framed, so stray bytes between Adalight frames do not change the rate.
+ */
+#define SERIAL_BAUD_MAGIC_1 0xBA
+#define SERIAL_BAUD_MAGIC_2 0xD0
+static const uint32_t serialBaudRates[] PROGMEM = {115200, 230400, 460800, 500000, 576000, 921600, 1000000, 1500000};
+
+static AdaState state = AdaState::Header_A;
+static uint16_t count = 0;
+static uint16_t pixel = 0;
+static byte check = 0x00;
+static byte red   = 0x00;
+static byte green = 0x00;
+
+static char*    jsonBuf = nullptr; //JSON API line, collected without blocking the loop
+static uint16_t jsonLen = 0;
+static uint8_t  jsonDepth = 0;
+static bool     jsonInString = false, jsonEscape = false;
+static uint32_t jsonStart = 0;
+
+static void serialFrameDone()
+{
+  if (!realtimeMode && bri == 0) strip.setBrightness(briLast);
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
+
+  if (!realtimeOverride) strip.show();
+  state = AdaState::Header_A;
+}
+
+//reads pixel data in chunks and writes whole RGB triplets at once, instead of one byte per loop pass, returns the bytes read
+static size_t handleSerialPixels()
+{
+  byte buf[SERIAL_CHUNK_SIZE];
+  uint32_t left = (uint32_t)count * 3;
+  if (state == AdaState::Data_Green) left -= 1;
+  if (state == AdaState::Data_Blue)  left -= 2;
+  size_t n = Serial.available();
+  if (n > sizeof(buf)) n = sizeof(buf);
+  if (n > left) n = left; //never read into the next header
+  n = Serial.readBytes(buf, n);
+
+  size_t i = 0;
+  while (i < n) {
+    if (state == AdaState::Data_Red && i + 3 <= n) { //whole pixel
+      if (!realtimeOverride) setRealtimePixel(pixel, buf[i], buf[i+1], buf[i+2], 0);
+      pixel++;
+      i += 3;
+    } else { //pixel split over two reads
+      byte next = buf[i++];
+      if (state == AdaState::Data_Red)   { red   = next; state = AdaState::Data_Green; continue; }
+      if (state == AdaState::Data_Green) { green = next; state = AdaState::Data_Blue;  continue; }
+      if (!realtimeOverride) setRealtimePixel(pixel, red, green, next, 0);
+      pixel++;
+      state = AdaState::Data_Red;
+    }
+    if (--count == 0) {
+      serialFrameDone();
+      break;
+    }
+  }
+  return n;
+}
+
+static void handleSerialJson()
+{
+  bool verboseResponse = false;
+  #ifdef WLED_USE_DYNAMIC_JSON
+  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  #else
+  if (!requestJSONBufferLock(16)) return;
+  #endif
+  DeserializationError error = deserializeJson(doc, jsonBuf, jsonLen);
+  if (error) {
+    releaseJSONBufferLock();
+    return;
+  }
+  verboseResponse = deserializeState(doc.as<JsonObject>());
+  //only send response if TX pin is unused for other purposes
+  if (verboseResponse && !pinManager.isPinAllocated(1)) {
+    doc.clear();
+    JsonObject state = doc.createNestedObject("state");
+    serializeState(state);
+    JsonObject info  = doc.createNestedObject("info");
+    serializeInfo(info);
+
+    serializeJson(doc, Serial);
+    Serial.println();
+  }
+  releaseJSONBufferLock();
+}
+
+//collects a JSON object until its braces are balanced, returns true once it is complete
+static bool collectSerialJson(byte next)
+{
+  if (jsonLen >= SERIAL_JSON_MAXLEN -1) { //too long, discard
+    state = AdaState::Header_A;
+    return false;
+  }
+  jsonBuf[jsonLen++] = next;
+  if (jsonInString) {
+    if (jsonEscape)        jsonEscape = false;
+    else if (next == '\\') jsonEscape = true;
+    else if (next == '"')  jsonInString = false;
+    return false;
+  }
+  if (next == '"') jsonInString = true;
+  else if (next == '{') jsonDepth++;
+  else if (next == '}' && --jsonDepth == 0) {
+    jsonBuf[jsonLen] = 0;
+    state = AdaState::Header_A;
+    return true;
+  }
+  return false;
+}
+
+//rates above 115200 fill the default 256 byte receive buffer within a few ms, it is enlarged before the port is restarted
+void updateSerialBaud(uint32_t baud)
+{
+  Serial.flush();
+  if (baud <= 115200) {
+    Serial.updateBaudRate(baud);
+    return;
+  }
+  Serial.end();
+  Serial.setRxBufferSize(SERIAL_RX_BUFFER_SIZE);
+  Serial.begin(baud);
+}
+
 void handleSerial()
 {
   if (pinManager.isPinAllocated(3)) return;
-  
+
   #ifdef WLED_ENABLE_ADALIGHT
-  static auto state = AdaState::Header_A;
-  static uint16_t count = 0;
-  static uint16_t pixel = 0;
-  static byte check = 0x00;
-  static byte red   = 0x00;
-  static byte green = 0x00;
-  
-  while (Serial.available() > 0)
+  if (state == AdaState::Json && millis() - jsonStart > SERIAL_JSON_TIMEOUT) state = AdaState::Header_A;
+
+  int32_t budget = SERIAL_MAX_BYTES_PER_LOOP; //a continuous stream must not keep the loop (WiFi, watchdog) waiting
+  while (Serial.available() > 0 && budget > 0)
   {
-    yield();
+    if (state == AdaState::Data_Red || state == AdaState::Data_Green || state == AdaState::Data_Blue) {
+      budget -= handleSerialPixels();
+      yield();
+      continue;
+    }
+    budget--;
+    if (state == AdaState::Json) {
+      if (collectSerialJson(Serial.read())) handleSerialJson();
+      continue;
+    }
+
     byte next = Serial.peek();
     switch (state) {
       case AdaState::Header_A:
@@ -46,32 +204,16 @@ void handleSerial()
           return;
         } else if (next == 'v') {
           Serial.print("WLED"); Serial.write(' '); Serial.println(VERSION);
+        } else if (next == SERIAL_BAUD_MAGIC_1) { //change baud rate
+          state = AdaState::Baud_Magic;
         } else if (next == '{') { //JSON API
-          bool verboseResponse = false;
-          #ifdef WLED_USE_DYNAMIC_JSON
-          DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-          #else
-          if (!requestJSONBufferLock(16)) return;
-          #endif
-          Serial.setTimeout(100);
-          DeserializationError error = deserializeJson(doc, Serial);
-          if (error) {
-            releaseJSONBufferLock();
-            return;
-          }
-          verboseResponse = deserializeState(doc.as<JsonObject>());
-          //only send response if TX pin is unused for other purposes
-          if (verboseResponse && !pinManager.isPinAllocated(1)) {
-            doc.clear();
-            JsonObject state = doc.createNestedObject("state");
-            serializeState(state);
-            JsonObject info  = doc.createNestedObject("info");
-            serializeInfo(info);
-
-            serializeJson(doc, Serial);
-            Serial.println();
-          }
-          releaseJSONBufferLock();
+          if (!jsonBuf) jsonBuf = (char*) malloc(SERIAL_JSON_MAXLEN);
+          if (!jsonBuf) break;
+          jsonLen = 0; jsonDepth = 0;
+          jsonInString = false; jsonEscape = false;
+          jsonStart = millis();
+          state = AdaState::Json;
+          continue; //the brace is read by the collector
         }
         break;
       case AdaState::Header_d:
@@ -97,6 +239,19 @@ void handleSerial()
         if (check == next) state = AdaState::Data_Red;
         else               state = AdaState::Header_A;
         break;
+      case AdaState::Baud_Magic:
+        state = (next == SERIAL_BAUD_MAGIC_2) ? AdaState::Baud_Rate : AdaState::Header_A;
+        break;
+      case AdaState::Baud_Rate:
+        check = next;
+        state = (next >= 0xB0 && next <= 0xB7) ? AdaState::Baud_Check : AdaState::Header_A;
+        break;
+      case AdaState::Baud_Check:
+        state = AdaState::Header_A;
+        if (next != (check ^ 0x55)) break;
+        Serial.read(); //the command is complete, nothing of it may be left in the buffer at the new rate
+        updateSerialBaud(pgm_read_dword(&serialBaudRates[check - 0xB0]));
+        continue;
       case AdaState::TPM2_Header_Type:
         state = AdaState::Header_A; //(unsupported) TPM2 command or invalid type
         if (next == 0xDA) state = AdaState::TPM2_Header_CountHi; //TPM2 data
@@ -109,28 +264,9 @@ void handleSerial()
         break;
       case AdaState::TPM2_Header_CountLo:
         count += next /3;
-        state = AdaState::Data_Red;
-        break;
-      case AdaState::Data_Red:
-        red   = next;
-        state = AdaState::Data_Green;
-        break;
-      case AdaState::Data_Green:
-        green = next;
-        state = AdaState::Data_Blue;
-        break;
-      case AdaState::Data_Blue:
-        byte blue  = next;
-        if (!realtimeOverride) setRealtimePixel(pixel++, red, green, blue, 0);
-        if (--count > 0) state = AdaState::Data_Red;
-        else {
-          if (!realtimeMode && bri == 0) strip.setBrightness(briLast);
-          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
-
-          if (!realtimeOverride) strip.show();
-          state = AdaState::Header_A;
-        }
+        state = count ? AdaState::Data_Red : AdaState::Header_A;
         break;
+      default: break;
     }
     Serial.read(); //discard the byte
   }
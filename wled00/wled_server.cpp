@@ -27,10 +27,11 @@ void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t
     if (filename == "/presets.json") presetsModifiedTime = toki.second();
   }
   if (len) {
-    request->_tempFile.write(data,len);
+    metricFsBytesWritten += request->_tempFile.write(data,len);
   }
   if(final){
     request->_tempFile.close();
+    if (filename.startsWith(F("/fx"))) fxvmInvalidate(); //Expression effect program, reload it
     request->send(200, "text/plain", F("File Uploaded!"));
   }
 }
@@ -144,6 +145,26 @@ void initServer()
   });
   server.addHandler(handler);
 
+  server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request){
+    serveMetrics(request);
+  });
+
+  //binary per-pixel upload, see pixels.cpp for the format
+  server.on("/pixels", HTTP_POST, [](AsyncWebServerRequest *request){
+    PixelUpload* up = (PixelUpload*)(request->_tempObject);
+    if (!up || !pixelUploadEnd(up)) {
+      request->send(400, "application/json", F("{\"error\":9}"));
+      return;
+    }
+    request->send(200, "application/json", F("{\"success\":true}"));
+  }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total){
+    if (!index) {
+      request->_tempObject = malloc(sizeof(PixelUpload)); //freed by request destructor
+      if (request->_tempObject) pixelUploadBegin((PixelUpload*)(request->_tempObject));
+    }
+    if (request->_tempObject) pixelUploadFeed((PixelUpload*)(request->_tempObject), data, len);
+  });
+
   server.on("/version", HTTP_GET, [](AsyncWebServerRequest *request){
     request->send(200, "text/plain", (String)VERSION);
     });
@@ -8,6 +8,8 @@
 uint16_t wsLiveClientId = 0;
 unsigned long wsLastLiveTime = 0;
 //uint8_t* wsFrameBuffer = nullptr;
+PixelUpload* wsPixelUpload = nullptr; //binary pixel upload split into multiple frames/packets
+uint32_t wsPixelUploadClientId = 0;
 
 #define WS_LIVE_INTERVAL 40
 
@@ -19,6 +21,9 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
     if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    if (wsPixelUpload && client->id() == wsPixelUploadClientId) {
+      free(wsPixelUpload); wsPixelUpload = nullptr;
+    }
   } else if(type == WS_EVT_DATA){
     //data packet
     AwsFrameInfo * info = (AwsFrameInfo*)arg;
@@ -63,8 +68,29 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
         }
         //update if it takes longer than 300ms until next "broadcast"
         if (verboseResponse && (millis() - lastInterfaceUpdate < 1700 || !interfaceUpdateCallMode)) sendDataWs(client);
+      } else if (info->opcode == WS_BINARY) {
+        //binary per-pixel upload
+        if (!handlePixelUpload(data, len)) client->text(F("{\"error\":9}"));
       }
     } else {
+      //binary pixel uploads can be decoded chunk by chunk
+      if (info->message_opcode == WS_BINARY) {
+        if (info->num == 0 && info->index == 0) { //first chunk of message
+          if (wsPixelUpload && wsPixelUploadClientId != client->id()) return; //only one split upload at a time
+          if (!wsPixelUpload) wsPixelUpload = (PixelUpload*) malloc(sizeof(PixelUpload));
+          if (!wsPixelUpload) return;
+          wsPixelUploadClientId = client->id();
+          pixelUploadBegin(wsPixelUpload);
+        }
+        if (!wsPixelUpload || wsPixelUploadClientId != client->id()) return;
+        pixelUploadFeed(wsPixelUpload, data, len);
+        if (info->final && (info->index + len) == info->len) {
+          if (!pixelUploadEnd(wsPixelUpload)) client->text(F("{\"error\":9}"));
+          free(wsPixelUpload); wsPixelUpload = nullptr;
+        }
+        return;
+      }
+
       //message is comprised of multiple frames or the frame is split into multiple packets
       //if(info->index == 0){
         //if (!wsFrameBuffer && len < 4096) wsFrameBuffer = new uint8_t[4096];
@@ -117,8 +143,10 @@ void sendDataWs(AsyncWebSocketClient * client)
     releaseJSONBufferLock();
   } 
   if (client) {
+    if (client->queueIsFull()) metricWsDrops++;
     client->text(buffer);
   } else {
+    if (!ws.availableForWriteAll()) metricWsDrops++;
     ws.textAll(buffer);
   }
 }